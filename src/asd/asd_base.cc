@@ -22,8 +22,10 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 //
 
+#include <mutex>
 #include <src/asd/asd_base.h>
 #include <src/util/prim_op.h>
+#include <src/util/taskqueue.h>
 
 using namespace std;
 using namespace bagel;
@@ -503,3 +505,43 @@ shared_ptr<Matrix> ASD_base::couple_blocks(const DimerSubspace_base& AB, const D
 
   return out;
 }
+
+
+void ASD_base::compute_blocks(const vector<DimerSubspace_base>& subspaces, const bool diagonal, const bool offdiagonal,
+                              function<void (const int, const int, shared_ptr<const Matrix>)> func) const {
+  // Coulomb matrices are created on demand; all of them have to exist before the threads start
+  jop_->compute_coulomb_matrices();
+
+  // nonzero blocks and their estimated costs
+  vector<tuple<int, int, double>> blocks;
+  for (int i = 0; i != subspaces.size(); ++i) {
+    const double isize = subspaces[i].dimerstates();
+    if (offdiagonal)
+      for (int j = 0; j != i; ++j)
+        if (coupling_type(subspaces[j], subspaces[i]) != Coupling::none)
+          blocks.emplace_back(i, j, isize*subspaces[j].dimerstates());
+    if (diagonal)
+      blocks.emplace_back(i, i, isize*isize);
+  }
+  // largest first. The ordering (and hence the assignment below) is identical on all processes
+  stable_sort(blocks.begin(), blocks.end(), [](const tuple<int, int, double>& a, const tuple<int, int, double>& b) { return get<2>(a) > get<2>(b); });
+
+  // each block goes to the process with the smallest accumulated cost
+  mutex funcmutex;
+  vector<double> load(mpi__->size(), 0.0);
+  TaskQueue<function<void(void)>> tasks(blocks.size());
+  for (auto& b : blocks) {
+    const int rank = min_element(load.begin(), load.end()) - load.begin();
+    load[rank] += get<2>(b);
+    if (rank != mpi__->rank()) continue;
+
+    const int i = get<0>(b);
+    const int j = get<1>(b);
+    tasks.emplace_back([this, i, j, &subspaces, &func, &funcmutex]() {
+      shared_ptr<const Matrix> block = (i == j) ? compute_diagonal_block(subspaces[i]) : couple_blocks(subspaces[j], subspaces[i]);
+      lock_guard<mutex> lock(funcmutex);
+      func(i, j, block);
+    });
+  }
+  tasks.compute();
+}
@@ -25,6 +25,7 @@
 #ifndef __ASD_ASD_BASE_H
 #define __ASD_ASD_BASE_H
 
+#include <functional>
 #include <src/asd/dimer/dimer.h>
 #include <src/asd/dimer/dimer_jop.h>
 #include <src/asd/asd_spin.h>
@@ -109,6 +110,12 @@ class ASD_base {
     // Off-diagonal stuff
     std::shared_ptr<Matrix> couple_blocks(const DimerSubspace_base& AB, const DimerSubspace_base& ApBp) const; // Off-diagonal driver for H
 
+    /// Task-parallel driver for the blocks of H: the diagonal blocks (i,i) and/or the coupling blocks (i,j) with j < i.
+    /** Nonzero blocks are distributed over processes by estimated cost and computed on threads. func(i, j, block) is called
+        for each block computed on this process (the calls are serialized); reduction over processes is left to the caller. */
+    void compute_blocks(const std::vector<DimerSubspace_base>& subspaces, const bool diagonal, const bool offdiagonal,
+                        std::function<void (const int, const int, std::shared_ptr<const Matrix>)> func) const;
+
     std::shared_ptr<Matrix> compute_offdiagonal_1e(const std::array<MonomerKey,4>&, std::shared_ptr<const Matrix> h) const;
     std::shared_ptr<Matrix> compute_inter_2e(const std::array<MonomerKey,4>&) const;
     std::shared_ptr<Matrix> compute_aET(const std::array<MonomerKey,4>&) const;
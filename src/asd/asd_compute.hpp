@@ -65,33 +65,33 @@ void ASD<VecType>::compute() {
 
   if (store_matrix_) hamiltonian_ = std::make_shared<Matrix>(dimerstates_, dimerstates_);
 
-  denom_ = std::unique_ptr<double[]>(new double[dimerstates_]);
+  denom_ = std::unique_ptr<double[]>(new double[dimerstates_]());
 
-  for (auto& subspace : subspaces_) {
+  for (auto& subspace : subspaces_)
     compute_pure_terms(subspace, jop_);
-    std::shared_ptr<Matrix> block = compute_diagonal_block(subspace);
+  const std::vector<DimerSubspace_base> subspaces = subspaces_base();
+
+  compute_blocks(subspaces, true, false, [this, &subspaces](const int i, const int j, std::shared_ptr<const Matrix> block) {
+    const int offset = subspaces[i].offset();
     if (store_matrix_)
-      hamiltonian_->add_block(1.0, subspace.offset(), subspace.offset(), block->ndim(), block->mdim(), block);
+      hamiltonian_->add_block(1.0, offset, offset, block->ndim(), block->mdim(), block);
     const int n = block->ndim();
-    for (int i = 0; i < n; ++i) denom_[subspace.offset() + i] = block->element(i,i);
-  }
+    for (int k = 0; k < n; ++k) denom_[offset + k] = block->element(k,k);
+  });
+  if (mpi__->size() > 1)
+    mpi__->allreduce(denom_.get(), dimerstates_);
   std::cout << "  o Computing diagonal blocks and building denominator - time " << std::setw(9) << std::fixed << std::setprecision(2) << asdtime.tick() << std::endl;
 
   if (store_matrix_) {
-    for (auto iAB = subspaces_.begin(); iAB != subspaces_.end(); ++iAB) {
-      const int ioff = iAB->offset();
-      for (auto jAB = subspaces_.begin(); jAB != iAB; ++jAB) {
-        const int joff = jAB->offset();
-
 // TODO remove this comment once the gammaforst issue has been fixed (bra and ket have been exchanged)
-        std::shared_ptr<Matrix> block = couple_blocks(*jAB, *iAB);
-
-        if (block) {
-          hamiltonian_->add_block(1.0, joff, ioff, block->ndim(), block->mdim(), block);
-          hamiltonian_->add_block(1.0, ioff, joff, block->mdim(), block->ndim(), block->transpose());
-        }
-      }
-    }
+    compute_blocks(subspaces, false, true, [this, &subspaces](const int i, const int j, std::shared_ptr<const Matrix> block) {
+      const int ioff = subspaces[i].offset();
+      const int joff = subspaces[j].offset();
+      hamiltonian_->add_block(1.0, joff, ioff, block->ndim(), block->mdim(), block);
+      hamiltonian_->add_block(1.0, ioff, joff, block->mdim(), block->ndim(), block->transpose());
+    });
+    if (mpi__->size() > 1)
+      hamiltonian_->allreduce();
     std::cout << "  o Computing off-diagonal blocks - time " << std::setw(9) << std::fixed << std::setprecision(2) << asdtime.tick() << std::endl;
   }
 
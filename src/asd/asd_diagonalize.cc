@@ -95,36 +95,35 @@ shared_ptr<Matrix> ASD_base::apply_hamiltonian(const Matrix& o, const vector<Dim
   const int nstates = o.mdim();
 
   shared_ptr<Matrix> out = o.clone();
-  for (auto iAB = subspaces.begin(); iAB != subspaces.end(); ++iAB) {
-    const int ioff = iAB->offset();
-    for (auto jAB = subspaces.begin(); jAB != iAB; ++jAB) {
-      const int joff = jAB->offset();
-
-      if (store_matrix_) {
+  if (store_matrix_) {
+    for (auto iAB = subspaces.begin(); iAB != subspaces.end(); ++iAB) {
+      const int ioff = iAB->offset();
+      for (auto jAB = subspaces.begin(); jAB != iAB; ++jAB) {
+        const int joff = jAB->offset();
         dgemm_("N", "N", iAB->dimerstates(), nstates, jAB->dimerstates(), 1.0, hamiltonian_->element_ptr(ioff, joff), hamiltonian_->ndim(),
                                                                                o.element_ptr(joff, 0), o.ndim(),
                                                                           1.0, out->element_ptr(ioff, 0), out->ndim());
         dgemm_("T", "N", jAB->dimerstates(), nstates, iAB->dimerstates(), 1.0, hamiltonian_->element_ptr(ioff, joff), hamiltonian_->ndim(),
                                                                                o.element_ptr(ioff, 0), o.ndim(),
                                                                           1.0, out->element_ptr(joff, 0), out->ndim());
-      } else {
-        shared_ptr<const Matrix> block = couple_blocks(*jAB, *iAB);
-
-        if (block) {
-          dgemm_("N", "N", block->ndim(), nstates, block->mdim(), 1.0, block->data(), block->ndim(), o.element_ptr(ioff, 0), dimerstates_, 1.0, out->element_ptr(joff, 0), o.ndim());
-          dgemm_("T", "N", block->mdim(), nstates, block->ndim(), 1.0, block->data(), block->ndim(), o.element_ptr(joff, 0), dimerstates_, 1.0, out->element_ptr(ioff, 0), o.ndim());
-        }
       }
-    }
-
-    if (store_matrix_) {
       dgemm_("N", "N", iAB->dimerstates(), nstates, iAB->dimerstates(), 1.0, hamiltonian_->element_ptr(ioff, ioff), hamiltonian_->ndim(),
                                                                              o.element_ptr(ioff, 0), o.ndim(),
                                                                         1.0, out->element_ptr(ioff, 0), out->ndim());
-    } else {
-      shared_ptr<const Matrix> block = compute_diagonal_block(*iAB);
-      dgemm_("N", "N", block->ndim(), nstates, block->mdim(), 1.0, block->data(), block->ndim(), o.element_ptr(ioff, 0), dimerstates_, 1.0, out->element_ptr(ioff, 0), out->ndim());
     }
+  } else {
+    compute_blocks(subspaces, true, true, [&](const int i, const int j, shared_ptr<const Matrix> block) {
+      const int ioff = subspaces[i].offset();
+      const int joff = subspaces[j].offset();
+      if (i == j) {
+        dgemm_("N", "N", block->ndim(), nstates, block->mdim(), 1.0, block->data(), block->ndim(), o.element_ptr(ioff, 0), dimerstates_, 1.0, out->element_ptr(ioff, 0), out->ndim());
+      } else if (block) {
+        dgemm_("N", "N", block->ndim(), nstates, block->mdim(), 1.0, block->data(), block->ndim(), o.element_ptr(ioff, 0), dimerstates_, 1.0, out->element_ptr(joff, 0), o.ndim());
+        dgemm_("T", "N", block->mdim(), nstates, block->ndim(), 1.0, block->data(), block->ndim(), o.element_ptr(joff, 0), dimerstates_, 1.0, out->element_ptr(ioff, 0), o.ndim());
+      }
+    });
+    if (mpi__->size() > 1)
+      out->allreduce();
   }
 
   return out;
@@ -133,3 +133,10 @@ void DimerJop::common_init(const int norbA, const int norbB) {
   cross_mo1e_ = cross_mo1e;
 }
 
+
+void DimerJop::compute_coulomb_matrices() {
+  coulomb_matrix<0,0,0,0>(); coulomb_matrix<1,0,0,0>(); coulomb_matrix<0,1,0,0>(); coulomb_matrix<1,1,0,0>();
+  coulomb_matrix<0,0,1,0>(); coulomb_matrix<1,0,1,0>(); coulomb_matrix<0,1,1,0>(); coulomb_matrix<1,1,1,0>();
+  coulomb_matrix<0,0,0,1>(); coulomb_matrix<1,0,0,1>(); coulomb_matrix<0,1,0,1>(); coulomb_matrix<1,1,0,1>();
+  coulomb_matrix<0,0,1,1>(); coulomb_matrix<1,0,1,1>(); coulomb_matrix<0,1,1,1>(); coulomb_matrix<1,1,1,1>();
+}
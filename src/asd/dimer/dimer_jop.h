@@ -66,6 +66,8 @@ class DimerJop : public Jop {
     /// Same as non-const version but will not create the matrix if it doesn't already exist
     template<int A, int B, int C, int D>
     std::shared_ptr<const Matrix> coulomb_matrix() const;
+    /// Creates all of the Coulomb matrices, after which coulomb_matrix can be called from several threads
+    void compute_coulomb_matrices();
 
   private:
     void common_init(const int norbA, const int norbB);
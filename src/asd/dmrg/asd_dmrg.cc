@@ -24,6 +24,7 @@
 
 #include <iostream>
 
+#include <src/util/timer.h>
 #include <src/asd/dmrg/asd_dmrg.h>
 
 using namespace std;
@@ -46,6 +47,11 @@ ASD_DMRG::ASD_DMRG(shared_ptr<const PTree> input, shared_ptr<const MultiSite> mu
   if (down_sweep_)
     down_sweep_truncs_ = input_->get_vector<int>("down_sweep_truncs");
 
+  spill_blocks_ = input_->get<bool>("spill_blocks", false);
+  block_window_ = input_->get<int>("block_window", 1);
+  block_reuse_thresh_ = input_->get<double>("block_reuse_thresh", 1.0e-10);
+  blocks_ = make_shared<DMRG_BlockCache>(nsites_, spill_blocks_, block_window_, block_reuse_thresh_);
+
   auto winput = input_->get_child_optional("weights");
   if (winput)
     weights_ = input_->get_vector<double>("weights", nstate_);
@@ -109,3 +115,30 @@ shared_ptr<PTree> ASD_DMRG::prepare_sweeping_input(const int site) const {
 
   return out;
 }
+
+void ASD_DMRG::sweep_step(const int site, const bool forward) {
+  Timer steptime;
+  blocks_->update_window(site);
+
+  shared_ptr<DMRG_Block1> system, environment;
+  if (forward) {
+    system = (site == 0) ? nullptr : blocks_->left(site-1);
+    environment = blocks_->right(nsites_ - site - 2);
+  } else {
+    system = (site == nsites_-1) ? nullptr : blocks_->right(nsites_ - site - 2);
+    environment = blocks_->left(site-1);
+  }
+  const int index = forward ? site : nsites_ - site - 1;
+
+  vector<double> energies;
+  if (blocks_->reusable(forward, index, system, environment, ntrunc_, perturb_, energies)) {
+    for (int i = 0; i < nstate_; ++i)
+      sweep_energies_[i].push_back(energies[i]);
+  } else {
+    shared_ptr<const Reference> ref = multisite_->build_reference(site, vector<bool>(nsites_, false));
+    shared_ptr<DMRG_Block1> block = decimate_block(prepare_sweeping_input(site), ref, system, environment, site);
+    for (int i = 0; i < nstate_; ++i)
+      energies.push_back(sweep_energies_[i].back());
+    blocks_->store(forward, index, block, system, environment, ntrunc_, perturb_, energies, steptime.tick());
+  }
+}
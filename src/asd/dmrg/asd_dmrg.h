@@ -27,6 +27,7 @@
 
 #include <src/asd/multisite/multisite.h>
 #include <src/asd/dmrg/dmrg_block.h>
+#include <src/asd/dmrg/block_cache.h>
 
 namespace bagel {
 
@@ -38,10 +39,8 @@ class ASD_DMRG {
     /// contains orbital information
     std::shared_ptr<const MultiSite> multisite_;
 
-    /// DMRG_Block representing L block containing l sites is in left_blocks_[l-1]
-    std::vector<std::shared_ptr<DMRG_Block1>> left_blocks_;
-    /// DMRG_Block representing R block containing l sites is in right_blocks_[l-1]
-    std::vector<std::shared_ptr<DMRG_Block1>> right_blocks_;
+    /// DMRG_Block representing L (R) block containing l sites is in blocks_->left(l-1) (blocks_->right(l-1))
+    std::shared_ptr<DMRG_BlockCache> blocks_;
 
     std::vector<double> weights_; ///< weights to use when building RDM
 
@@ -62,6 +61,10 @@ class ASD_DMRG {
     bool down_sweep_; ///< controls whether to sweep with decreasing values of ntrunc_ after the main calculation
     std::vector<int> down_sweep_truncs_; ///< descending list of values to use for ntrunc_
 
+    bool spill_blocks_; ///< write blocks that are far from the active site to disk
+    int block_window_; ///< number of blocks on each side of the active site kept in memory when spill_blocks_ is set
+    double block_reuse_thresh_; ///< threshold below which a newly decimated block is considered identical to the previous one (negative to turn off)
+
     /// Prints graphical depiction of sweep process, mainly probably useful for debugging
     std::string print_progress(const int position, const std::string left_symbol, const std::string right_symbol) const;
 
@@ -95,6 +98,8 @@ class ASD_DMRG {
     std::vector<std::shared_ptr<PTree>> prepare_growing_input(const int site) const;
     /// Prepare one input to be used during the sweep
     std::shared_ptr<PTree> prepare_sweeping_input(const int site) const;
+    /// One step of a sweep at site producing either a left (forward) or a right (backward) block. Decimations with unchanged inputs are skipped
+    void sweep_step(const int site, const bool forward);
 };
 
 }
@@ -33,7 +33,7 @@ using namespace bagel;
 void ASD_DMRG::compute() {
   Timer dmrg_timer;
 
-  shared_ptr<DMRG_Block1> left_block, right_block;
+  shared_ptr<DMRG_Block1> left_block;
 
   // Seed lattice
   cout << " ===== Start growing DMRG chain =====" << endl;
@@ -41,7 +41,7 @@ void ASD_DMRG::compute() {
     shared_ptr<const Reference> ref = multisite_->build_reference(0, vector<bool>(nsites_, true));
     // CI calculation on site 1 with all other sites at meanfield
     left_block = compute_first_block(prepare_growing_input(0), ref);
-    left_blocks_.push_back(left_block);
+    blocks_->set(true, 0, left_block);
     cout << "  " << print_progress(0, ">>", "..") << setw(16) << dmrg_timer.tick() << endl;
   }
 
@@ -51,13 +51,9 @@ void ASD_DMRG::compute() {
     fill_n(meanfield.begin(), site, false);
     shared_ptr<const Reference> ref = multisite_->build_reference(site, meanfield);
     left_block = grow_block(prepare_growing_input(site), ref, left_block, site);
-    left_blocks_.push_back(left_block);
+    blocks_->set(true, site, left_block);
     cout << "  " << print_progress(site, ">>", "..") << setw(16) << dmrg_timer.tick() << endl;
   }
-  assert(left_blocks_.size() == nsites_-1);
-
-  right_blocks_.resize(nsites_-1);
-
   cout << endl << " ===== Starting sweeps =====" << endl << endl;
 
   cout << "  o convergence threshold: " << setw(8) << setprecision(4) << scientific << thresh_ << endl;
@@ -67,25 +63,17 @@ void ASD_DMRG::compute() {
   for (int iter = 0; iter < maxiter_; ++iter) {
   // Start sweeping backwards
     for (int site = nsites_-1; site > 0; --site) {
-      left_block = left_blocks_[site-1];
-      right_block = (site == nsites_-1) ? nullptr : right_blocks_[nsites_ - site - 2];
-      shared_ptr<const Reference> ref = multisite_->build_reference(site, vector<bool>(nsites_, false));
-
-      right_block = decimate_block(prepare_sweeping_input(site), ref, right_block, left_block, site);
-      right_blocks_[nsites_ - site - 1] = right_block;
+      sweep_step(site, false);
       cout << "  " << print_progress(site, "<<", "<<") << setw(16) << dmrg_timer.tick() << endl;
     }
 
   // Sweep forwards
     for (int site = 0; site < nsites_-1; ++site) {
-      left_block = (site == 0) ? nullptr : left_blocks_[site-1];
-      right_block = right_blocks_[nsites_ - site - 2];
-      shared_ptr<const Reference> ref = multisite_->build_reference(site, vector<bool>(nsites_, false));
-
-      left_block = decimate_block(prepare_sweeping_input(site), ref, left_block, right_block, site);
-      left_blocks_[site] = left_block;
+      sweep_step(site, true);
       cout << "  " << print_progress(site, ">>", ">>") << setw(16) << dmrg_timer.tick() << endl;
     }
+    cout << endl;
+    blocks_->print_costs();
 
     bool conv = (perturb_ < perturb_min_);
     bool drop_perturb = true;
@@ -157,31 +145,21 @@ void ASD_DMRG::down_sweep() {
 
     vector<double> energies(nstate_, 0.0);
 
-    shared_ptr<DMRG_Block1> left_block, right_block;
-
     cout << "  o Starting sweep with M = " << ntrunc_ << endl;
     for (int iter = 0; iter < maxiter_; ++iter) {
     // Start sweeping backwards
       for (int site = nsites_-1; site > 0; --site) {
-        left_block = left_blocks_[site-1];
-        right_block = (site == nsites_-1) ? nullptr : right_blocks_[nsites_ - site - 2];
-        shared_ptr<const Reference> ref = multisite_->build_reference(site, vector<bool>(nsites_, false));
-
-        right_block = decimate_block(prepare_sweeping_input(site), ref, right_block, left_block, site);
-        right_blocks_[nsites_ - site - 1] = right_block;
+        sweep_step(site, false);
         cout << "  " << print_progress(site, "<<", "<<") << setw(16) << dmrg_timer.tick() << endl;
       }
 
     // Sweep forwards
       for (int site = 0; site < nsites_-1; ++site) {
-        left_block = (site == 0) ? nullptr : left_blocks_[site-1];
-        right_block = right_blocks_[nsites_ - site - 2];
-        shared_ptr<const Reference> ref = multisite_->build_reference(site, vector<bool>(nsites_, false));
-
-        left_block = decimate_block(prepare_sweeping_input(site), ref, left_block, right_block, site);
-        left_blocks_[site] = left_block;
+        sweep_step(site, true);
         cout << "  " << print_progress(site, ">>", ">>") << setw(16) << dmrg_timer.tick() << endl;
       }
+      cout << endl;
+      blocks_->print_costs();
 
       bool conv = true;
       cout << endl;
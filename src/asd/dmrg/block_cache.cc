@@ -0,0 +1,135 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: block_cache.cc
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <iomanip>
+
+#include <src/asd/dmrg/block_cache.h>
+
+using namespace std;
+using namespace bagel;
+
+DMRG_BlockCache::DMRG_BlockCache(const int nsites, const bool spill, const int window, const double reuse_thresh, const string prefix)
+  : nsites_(nsites), left_(nsites-1), right_(nsites-1), spill_(spill), window_(window), reuse_thresh_(reuse_thresh), prefix_(prefix) {
+}
+
+
+string DMRG_BlockCache::filename(const bool left, const int i) const {
+  return prefix_ + (left ? "_left_" : "_right_") + to_string(i) + "_" + to_string(mpi__->rank()) + ".scratch";
+}
+
+
+shared_ptr<DMRG_Block1> DMRG_BlockCache::get(const bool left, const int i) {
+  shared_ptr<DMRG_Block1> out = entry(left, i).block;
+  if (out && out->on_disk())
+    out->restore();
+  return out;
+}
+
+
+void DMRG_BlockCache::set(const bool left, const int i, shared_ptr<DMRG_Block1> block) {
+  Entry& e = entry(left, i);
+  e = Entry();
+  e.block = block;
+}
+
+
+bool DMRG_BlockCache::reusable(const bool left, const int i, shared_ptr<const DMRG_Block1> system, shared_ptr<const DMRG_Block1> environment,
+                               const int ntrunc, const double perturb, vector<double>& energies) {
+  Entry& e = entry(left, i);
+  const bool out = reuse_thresh_ >= 0.0 && e.block && !e.energies.empty()
+                && e.system.lock() == system && e.environment.lock() == environment && e.ntrunc == ntrunc && e.perturb == perturb;
+  if (out) {
+    energies = e.energies;
+    ++e.nreuse;
+  }
+  return out;
+}
+
+
+shared_ptr<DMRG_Block1> DMRG_BlockCache::store(const bool left, const int i, shared_ptr<DMRG_Block1> block, shared_ptr<const DMRG_Block1> system,
+                                               shared_ptr<const DMRG_Block1> environment, const int ntrunc, const double perturb,
+                                               const vector<double>& energies, const double time) {
+  Entry& e = entry(left, i);
+  // keeping the old object lets the downstream decimations recognize that their inputs have not changed
+  if (reuse_thresh_ >= 0.0 && e.block && !e.block->on_disk() && e.block->equivalent(*block, reuse_thresh_))
+    ++e.nreuse;
+  else
+    e.block = block;
+  e.system = system;
+  e.environment = environment;
+  e.ntrunc = ntrunc;
+  e.perturb = perturb;
+  e.energies = energies;
+  e.time = time;
+  ++e.nbuild;
+  return e.block;
+}
+
+
+void DMRG_BlockCache::update_window(const int site) {
+  if (!spill_) return;
+  // the left block ending at site-1 and the right block starting at site+1 are the ones in use
+  for (int l = 0; l != nsites_-1; ++l) {
+    if (left_[l].block && abs(l - (site-1)) > window_)
+      left_[l].block->spill(filename(true, l));
+    if (right_[l].block && abs(l - (nsites_-site-2)) > window_)
+      right_[l].block->spill(filename(false, l));
+  }
+}
+
+
+size_t DMRG_BlockCache::memory() const {
+  size_t out = 0;
+  for (auto& e : left_)
+    if (e.block && !e.block->on_disk()) out += e.block->size();
+  for (auto& e : right_)
+    if (e.block && !e.block->on_disk()) out += e.block->size();
+  return out;
+}
+
+
+void DMRG_BlockCache::print_costs() const {
+  cout << "  o Block cache (time in seconds of the last decimation, memory in MB)" << endl;
+  cout << setw(8) << "site" << setw(12) << "<< time" << setw(8) << "built" << setw(8) << "reused" << setw(12) << "memory"
+                            << setw(12) << ">> time" << setw(8) << "built" << setw(8) << "reused" << setw(12) << "memory" << endl;
+  auto print_entry = [](const Entry& e) {
+    const double mb = e.block ? e.block->size()*sizeof(double)/1.0e6 : 0.0;
+    cout << setw(12) << setprecision(2) << fixed << e.time << setw(8) << e.nbuild << setw(8) << e.nreuse;
+    if (e.block && e.block->on_disk())
+      cout << setw(12) << "disk";
+    else
+      cout << setw(12) << setprecision(2) << fixed << mb;
+  };
+  for (int site = 0; site != nsites_; ++site) {
+    cout << setw(8) << site;
+    // the right block decimated at site has nsites-site sites; the left one has site+1 sites
+    if (site > 0) print_entry(right_[nsites_-site-1]);
+    else          cout << setw(40) << "---";
+    if (site < nsites_-1) print_entry(left_[site]);
+    else                  cout << setw(40) << "---";
+    cout << endl;
+  }
+  cout << "    total memory held by blocks: " << setprecision(2) << fixed << memory()*sizeof(double)/1.0e6 << " MB" << endl;
+  cout << scientific;
+}
@@ -0,0 +1,100 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: block_cache.h
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __ASD_DMRG_BLOCK_CACHE_H
+#define __ASD_DMRG_BLOCK_CACHE_H
+
+#include <src/asd/dmrg/dmrg_block.h>
+
+namespace bagel {
+
+/// Holds the left and right environment blocks of ASD_DMRG between sweeps.
+/** A decimation is skipped when it would be performed with exactly the same system and environment blocks
+    (and the same M and perturbation) as in the previous sweep. Newly decimated blocks that are identical (within a threshold) to the
+    block they replace (compared through DMRG_Block1::equivalent) are discarded in favor of the old one, so that
+    converged parts of the chain are not rebuilt. Blocks farther than window_ sites from the active site can be spilled to disk. */
+class DMRG_BlockCache {
+  protected:
+    struct Entry {
+      std::shared_ptr<DMRG_Block1> block;
+      /// inputs with which block was last decimated (weak, so that replaced blocks are released)
+      std::weak_ptr<const DMRG_Block1> system;
+      std::weak_ptr<const DMRG_Block1> environment;
+      int ntrunc;
+      double perturb;
+      /// energies of all the states obtained in the decimation that produced block
+      std::vector<double> energies;
+
+      /// costs for the per-site report
+      double time;
+      int nbuild;
+      int nreuse;
+
+      Entry() : ntrunc(-1), perturb(0.0), time(0.0), nbuild(0), nreuse(0) { }
+    };
+
+    const int nsites_;
+    std::vector<Entry> left_;  ///< left_[l] holds the block containing sites [0, l]
+    std::vector<Entry> right_; ///< right_[l] holds the block containing sites [nsites-l-1, nsites)
+
+    bool spill_;          ///< if true, blocks outside of the window are written to disk
+    int window_;          ///< number of blocks on each side of the active site that are kept in memory
+    double reuse_thresh_; ///< threshold for DMRG_Block1::equivalent. Negative values turn off block reuse
+    std::string prefix_;  ///< prefix of the scratch files
+
+    Entry& entry(const bool left, const int i) { return left ? left_.at(i) : right_.at(i); }
+    const Entry& entry(const bool left, const int i) const { return left ? left_.at(i) : right_.at(i); }
+    std::string filename(const bool left, const int i) const;
+
+  public:
+    DMRG_BlockCache(const int nsites, const bool spill, const int window, const double reuse_thresh, const std::string prefix = "dmrg_block");
+
+    /// returns the block (reading it from disk if necessary)
+    std::shared_ptr<DMRG_Block1> left(const int i)  { return get(true, i); }
+    std::shared_ptr<DMRG_Block1> right(const int i) { return get(false, i); }
+    std::shared_ptr<DMRG_Block1> get(const bool left, const int i);
+
+    /// stores a block obtained while growing the chain (not a candidate for reuse)
+    void set(const bool left, const int i, std::shared_ptr<DMRG_Block1> block);
+
+    /// true if the block at (left, i) was decimated with exactly these inputs. The stored energies are then returned in energies
+    bool reusable(const bool left, const int i, std::shared_ptr<const DMRG_Block1> system, std::shared_ptr<const DMRG_Block1> environment,
+                  const int ntrunc, const double perturb, std::vector<double>& energies);
+    /// registers a decimated block. Returns the block to be used in the rest of the sweep, which is the old block if the two are equivalent
+    std::shared_ptr<DMRG_Block1> store(const bool left, const int i, std::shared_ptr<DMRG_Block1> block, std::shared_ptr<const DMRG_Block1> system,
+                                       std::shared_ptr<const DMRG_Block1> environment, const int ntrunc, const double perturb,
+                                       const std::vector<double>& energies, const double time);
+
+    /// spills the blocks that are not needed around site to disk
+    void update_window(const int site);
+
+    /// number of doubles held in memory
+    size_t memory() const;
+    /// prints timing and memory per site
+    void print_costs() const;
+};
+
+}
+
+#endif
@@ -23,6 +23,8 @@
 //
 
 #include <algorithm>
+#include <cstdio>
+#include <fstream>
 
 #include <src/asd/dmrg/dmrg_block.h>
 #include <src/ci/ras/civector.h>
@@ -164,6 +166,107 @@ shared_ptr<const BlockOperators> DMRG_Block1::compute_block_ops(shared_ptr<Dimer
   return make_shared<BlockOperators1>(shared_from_this(), jop);
 }
 
+DMRG_Block1::~DMRG_Block1() {
+  if (on_disk())
+    remove(spill_file_.c_str());
+}
+
+size_t DMRG_Block1::size() const {
+  size_t out = 0;
+  for (auto& i : sparse_)
+    for (auto& j : i.second)
+      out += j.second.data->storage().size();
+  for (auto& i : H2e_)
+    out += i.second->size();
+  for (auto& i : spin_)
+    out += i.second->size();
+  return out;
+}
+
+void DMRG_Block1::spill(const string& filename) {
+  if (on_disk()) return;
+  ofstream fs(filename, ios::binary | ios::trunc);
+  if (!fs.is_open())
+    throw runtime_error("DMRG_Block1::spill could not open " + filename);
+  // the order of traversal of sparse_ is deterministic, so restore() can read the tensors back in the same order
+  for (auto& i : sparse_)
+    for (auto& j : i.second) {
+      btas::Tensor3<double>& tensor = *j.second.data;
+      fs.write(reinterpret_cast<const char*>(tensor.data()), tensor.storage().size()*sizeof(double));
+      tensor.storage() = btas::Tensor3<double>::storage_type();
+    }
+  if (!fs.good())
+    throw runtime_error("DMRG_Block1::spill failed while writing " + filename);
+  spill_file_ = filename;
+}
+
+void DMRG_Block1::restore() {
+  if (!on_disk()) return;
+  ifstream fs(spill_file_, ios::binary);
+  if (!fs.is_open())
+    throw runtime_error("DMRG_Block1::restore could not open " + spill_file_);
+  for (auto& i : sparse_)
+    for (auto& j : i.second) {
+      btas::Tensor3<double>& tensor = *j.second.data;
+      tensor.storage().resize(tensor.range().area());
+      fs.read(reinterpret_cast<char*>(tensor.data()), tensor.storage().size()*sizeof(double));
+    }
+  if (!fs.good())
+    throw runtime_error("DMRG_Block1::restore failed while reading " + spill_file_);
+  fs.close();
+  remove(spill_file_.c_str());
+  spill_file_.clear();
+}
+
+bool DMRG_Block1::equivalent(const DMRG_Block1& o, const double thresh) const {
+  if (blocks_.size() != o.blocks_.size() || norb() != o.norb() || on_disk() || o.on_disk())
+    return false;
+  for (auto& b : blocks_) {
+    auto iter = o.blocks_.find(b);
+    if (iter == o.blocks_.end() || !(*iter == b))
+      return false;
+  }
+
+  // the renormalized operators are compared element by element, so that only blocks with the same states (not only the same space) are reused
+  auto same = [&thresh](const double* a, const double* b, const size_t n) {
+    return equal(a, a+n, b, [&thresh](const double& x, const double& y) { return fabs(x-y) <= thresh; });
+  };
+  auto same_matrix = [&same](const Matrix& a, const Matrix& b) {
+    return a.ndim() == b.ndim() && a.mdim() == b.mdim() && same(a.data(), b.data(), a.size());
+  };
+  auto same_map = [&same_matrix](const map<BlockKey, shared_ptr<const Matrix>>& a, const map<BlockKey, shared_ptr<const Matrix>>& b) {
+    if (a.size() != b.size())
+      return false;
+    for (auto& i : a) {
+      auto iter = b.find(i.first);
+      if (iter == b.end() || !same_matrix(*i.second, *iter->second))
+        return false;
+    }
+    return true;
+  };
+
+  if (!same_matrix(*coeff_, *o.coeff_) || !same_map(H2e_, o.H2e_) || !same_map(spin_, o.spin_))
+    return false;
+
+  if (sparse_.size() != o.sparse_.size())
+    return false;
+  for (auto& i : sparse_) {
+    auto iter = o.sparse_.find(i.first);
+    if (iter == o.sparse_.end() || iter->second.size() != i.second.size())
+      return false;
+    for (auto& j : i.second) {
+      auto jter = iter->second.find(j.first);
+      if (jter == iter->second.end())
+        return false;
+      const btas::Tensor3<double>& a = *j.second.data;
+      const btas::Tensor3<double>& b = *jter->second.data;
+      if (a.range() != b.range() || !same(a.data(), b.data(), a.size()))
+        return false;
+    }
+  }
+  return true;
+}
+
 DMRG_Block2::DMRG_Block2(shared_ptr<const DMRG_Block1> lb, shared_ptr<const DMRG_Block1> rb) : left_block_(lb), right_block_(rb) {
   // left block runs first in the resulting pairmap_ vectors
   for (auto& left : lb->blocks()) {
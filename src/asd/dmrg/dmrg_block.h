@@ -88,9 +88,12 @@ class DMRG_Block1 : public std::enable_shared_from_this<DMRG_Block1>, public DMR
     std::map<BlockKey, std::shared_ptr<const Matrix>> H2e_;
     std::map<BlockKey, std::shared_ptr<const Matrix>> spin_;
 
+    std::string spill_file_; ///< nonempty when the coupling tensors have been moved to disk
+
   public:
     /// default constructor
     DMRG_Block1() { }
+    ~DMRG_Block1();
 
     /// constructor that takes an Rvalue reference to a GammaForestASD
     DMRG_Block1(GammaForestASD<RASDvec>&& forest, const std::map<BlockKey, std::shared_ptr<const Matrix>> h2e, const std::map<BlockKey,
@@ -108,6 +111,17 @@ class DMRG_Block1 : public std::enable_shared_from_this<DMRG_Block1>, public DMR
     std::shared_ptr<Matrix> spin_raise(const BlockKey b) const override;
 
     std::shared_ptr<const BlockOperators> compute_block_ops(std::shared_ptr<DimerJop> jop) const override;
+
+    /// number of doubles held in memory by this block
+    size_t size() const;
+    /// writes the coupling tensors to filename and releases their memory
+    void spill(const std::string& filename);
+    /// reads the coupling tensors back from disk
+    void restore();
+    bool on_disk() const { return !spill_file_.empty(); }
+
+    /// true if o has the same sectors, orbitals, and renormalized operators (element by element within thresh)
+    bool equivalent(const DMRG_Block1& o, const double thresh) const;
 };
 
 namespace DMRG {
@@ -35,6 +35,9 @@ using namespace bagel;
 vector<shared_ptr<ProductRASCivec>> FormSigmaProdRAS::operator()(const vector<shared_ptr<ProductRASCivec>>& ccvec,
                      shared_ptr<const BlockOperators> blockops, shared_ptr<DimerJop> jop, const vector<bool>& conv) const {
 
+  if (sector_parallel_)
+    return compute_tasks(ccvec, blockops, jop, conv, /*diagonal_only*/false);
+
   const int nstate = ccvec.size();
   vector<shared_ptr<ProductRASCivec>> sigmavec;
   for_each(ccvec.begin(), ccvec.end(), [&sigmavec] (shared_ptr<const ProductRASCivec> c) { sigmavec.push_back(c->clone()); });
@@ -65,6 +68,9 @@ vector<shared_ptr<ProductRASCivec>> FormSigmaProdRAS::operator()(const vector<sh
 vector<shared_ptr<ProductRASCivec>> FormSigmaProdRAS::diagonal(const vector<shared_ptr<ProductRASCivec>>& ccvec,
                      shared_ptr<const BlockOperators> blockops, shared_ptr<DimerJop> jop, const vector<bool>& conv) const {
 
+  if (sector_parallel_)
+    return compute_tasks(ccvec, blockops, jop, conv, /*diagonal_only*/true);
+
   const int nstate = ccvec.size();
   vector<shared_ptr<ProductRASCivec>> sigmavec;
   for_each(ccvec.begin(), ccvec.end(), [&sigmavec] (shared_ptr<const ProductRASCivec> c) { sigmavec.push_back(c->clone()); });
@@ -92,12 +98,7 @@ vector<shared_ptr<ProductRASCivec>> FormSigmaProdRAS::diagonal(const vector<shar
   return sigmavec;
 }
 
-void FormSigmaProdRAS::pure_block_and_ras(shared_ptr<const ProductRASCivec> cc, shared_ptr<ProductRASCivec> sigma, shared_ptr<const BlockOperators> blockops, shared_ptr<DimerJop> jop) const {
-  Timer ptime(2);
-
-  const int norb = cc->space()->norb();
-
-  // first, prepare g and mo2e arrays
+Matrix FormSigmaProdRAS::compute_g(shared_ptr<DimerJop> jop, const int norb) const {
   shared_ptr<const Matrix> mo2e = jop->monomer_jop<0>()->mo2e();
   auto mo2e_hz = [&norb, &mo2e] (const int i, const int j, const int k, const int l) { return mo2e->element(i + norb*j, k + norb*l); };
 
@@ -123,6 +124,17 @@ void FormSigmaProdRAS::pure_block_and_ras(shared_ptr<const ProductRASCivec> cc,
     g(k,k) += val;
     ++kl;
   }
+  return g;
+}
+
+void FormSigmaProdRAS::pure_block_and_ras(shared_ptr<const ProductRASCivec> cc, shared_ptr<ProductRASCivec> sigma, shared_ptr<const BlockOperators> blockops, shared_ptr<DimerJop> jop) const {
+  Timer ptime(2);
+
+  const int norb = cc->space()->norb();
+
+  // first, prepare g and mo2e arrays
+  shared_ptr<const Matrix> mo2e = jop->monomer_jop<0>()->mo2e();
+  const Matrix g = compute_g(jop, norb);
 
   // now precompute Sparse_IJ objects
   unordered_map</*bspace_tag*/size_t, shared_ptr<Sparse_IJ>> sparse_map;
@@ -133,31 +145,30 @@ void FormSigmaProdRAS::pure_block_and_ras(shared_ptr<const ProductRASCivec> cc,
       sparse_map.emplace(bspace->key(), make_shared<Sparse_IJ>(bspace, bspace));
   }
 
-  // convenient access to space object
-  shared_ptr<RASSpace> space = sigma->space();
-
   for (auto& sector : sigma->sectors()) {
-    // first prepare pure block part which will be a nsecstates x nsecstates matrix
-    const Matrix pure_block = *blockops->ham(sector.first);
-
-    shared_ptr<RASBlockVectors> sigma_sector = sector.second;
     shared_ptr<const RASBlockVectors> cc_sector = cc->sector(sector.first);
-    // TODO: would this benefit from being blocksparse?
-    if (mpi__->rank() == 0) {
-      dgemm_("N","T", sigma_sector->ndim(), sigma_sector->mdim(), sigma_sector->mdim(), 1.0, cc_sector->data(), cc_sector->ndim(), pure_block.data(), pure_block.ndim(),
-                                                                                        0.0, sigma_sector->data(), sigma_sector->ndim());
-    }
-    ptime.tick_print("pure_block");
+    pure_sector(cc_sector, sector.second, sigma->space(), blockops, g, mo2e->data(), *sparse_map.at(cc_sector->det()->stringspaceb()->key()));
+    ptime.tick_print("pure_block and pure_ras");
+  }
+}
 
-    // now do individual form_sigmas for the RAS parts
-    shared_ptr<const MOFile> monomerjop = jop->monomer_jop<0>();
-    resolve_H_aa(*cc_sector, *sigma_sector, g.data(), mo2e->data());
+void FormSigmaProdRAS::pure_sector(shared_ptr<const RASBlockVectors> cc_sector, shared_ptr<RASBlockVectors> sigma_sector, shared_ptr<RASSpace> space,
+                                   shared_ptr<const BlockOperators> blockops, const Matrix& g, const double* mo2e, const Sparse_IJ& sparseij) const {
+  // first prepare pure block part which will be a nsecstates x nsecstates matrix
+  const Matrix pure_block = *blockops->ham(cc_sector->left_state().key());
 
-    shared_ptr<const RASDeterminants> trans_det = space->det(cc_sector->det()->neleb(), cc_sector->det()->nelea());
-    resolve_H_bb(*cc_sector, *sigma_sector, trans_det, g.data(), mo2e->data());
-    resolve_H_ab(*cc_sector, *sigma_sector, *sparse_map.at(cc_sector->det()->stringspaceb()->key()), mo2e->data());
-    ptime.tick_print("pure_ras");
+  // TODO: would this benefit from being blocksparse?
+  if (mine(0)) {
+    dgemm_("N","T", sigma_sector->ndim(), sigma_sector->mdim(), sigma_sector->mdim(), 1.0, cc_sector->data(), cc_sector->ndim(), pure_block.data(), pure_block.ndim(),
+                                                                                      1.0, sigma_sector->data(), sigma_sector->ndim());
   }
+
+  // now do individual form_sigmas for the RAS parts
+  resolve_H_aa(*cc_sector, *sigma_sector, g.data(), mo2e);
+
+  shared_ptr<const RASDeterminants> trans_det = space->det(cc_sector->det()->neleb(), cc_sector->det()->nelea());
+  resolve_H_bb(*cc_sector, *sigma_sector, trans_det, g.data(), mo2e);
+  resolve_H_ab(*cc_sector, *sigma_sector, sparseij, mo2e);
 }
 
 
@@ -288,7 +299,7 @@ void FormSigmaProdRAS::aET_branch(shared_ptr<const RASBlockVectors> cc_sector, s
     apply(1.0, *cc_sector, sector_r, {GammaSQ::CreateAlpha}, {r});
     if (do_single) {
 #ifdef HAVE_MPI_H
-      if (mpi_counter++ % mpi__->size() == mpi__->rank()) {
+      if (mine(mpi_counter++)) {
 #endif
         shared_ptr<const BlockSparseMatrix> Sr = blockops->S_a(singleETkey, r);
         mat_block_multiply(false, false, phase, sector_r, *Sr, 1.0, *single_sector);
@@ -299,7 +310,7 @@ void FormSigmaProdRAS::aET_branch(shared_ptr<const RASBlockVectors> cc_sector, s
     if (do_double) {
       for (int s = 0; s < r; ++s) {
 #ifdef HAVE_MPI_H
-        if (mpi_counter++ % mpi__->size() == mpi__->rank()) {
+        if (mine(mpi_counter++)) {
 #endif
           tmp_double->zero();
           apply(1.0, sector_r, *tmp_double, {GammaSQ::CreateAlpha}, {s});
@@ -355,7 +366,7 @@ void FormSigmaProdRAS::bET_branch(shared_ptr<const RASBlockVectors> cc_sector, s
     apply(1.0, *cc_sector, sector_r, {GammaSQ::CreateBeta}, {r});
     if (do_b) {
 #ifdef HAVE_MPI_H
-      if (mpi_counter++ % mpi__->size() == mpi__->rank()) {
+      if (mine(mpi_counter++)) {
 #endif
         shared_ptr<const BlockSparseMatrix> Sr = blockops->S_b(bETkey, r);
         mat_block_multiply(false, false, phase, sector_r, *Sr, 1.0, *b_sector);
@@ -367,7 +378,7 @@ void FormSigmaProdRAS::bET_branch(shared_ptr<const RASBlockVectors> cc_sector, s
     if (do_bb) {
       for (int s = 0; s < r; ++s) {
 #ifdef HAVE_MPI_H
-        if (mpi_counter++ % mpi__->size() == mpi__->rank()) {
+        if (mine(mpi_counter++)) {
 #endif
           tmp_bb->zero();
           apply(1.0, sector_r, *tmp_bb, {GammaSQ::CreateBeta}, {s});
@@ -383,7 +394,7 @@ void FormSigmaProdRAS::bET_branch(shared_ptr<const RASBlockVectors> cc_sector, s
     if (do_ab) {
       for (int s = 0; s < rnorb; ++s) {
 #ifdef HAVE_MPI_H
-        if (mpi_counter++ % mpi__->size() == mpi__->rank()) {
+        if (mine(mpi_counter++)) {
 #endif
           tmp_ab->zero();
           apply(1.0, sector_r, *tmp_ab, {GammaSQ::CreateAlpha}, {s});
@@ -434,7 +445,7 @@ void FormSigmaProdRAS::aHT_branch(shared_ptr<const RASBlockVectors> cc_sector, s
     apply(1.0, *cc_sector, sector_r, {GammaSQ::AnnihilateAlpha}, {r});
     if (do_aHT) {
 #ifdef HAVE_MPI_H
-      if (mpi_counter++ % mpi__->size() == mpi__->rank()) {
+      if (mine(mpi_counter++)) {
 #endif
         shared_ptr<const BlockSparseMatrix> Sr = blockops->S_a(cckey, r);
         mat_block_multiply(false, true, phase, sector_r, *Sr, 1.0, *a_sector);
@@ -446,7 +457,7 @@ void FormSigmaProdRAS::aHT_branch(shared_ptr<const RASBlockVectors> cc_sector, s
     if (do_aaHT) {
       for (int s = 0; s < r; ++s) {
 #ifdef HAVE_MPI_H
-        if (mpi_counter++ % mpi__->size() == mpi__->rank()) {
+        if (mine(mpi_counter++)) {
 #endif
           tmp_aa->zero();
           apply(1.0, sector_r, *tmp_aa, {GammaSQ::AnnihilateAlpha}, {s});
@@ -501,7 +512,7 @@ void FormSigmaProdRAS::bHT_branch(shared_ptr<const RASBlockVectors> cc_sector, s
     apply(1.0, *cc_sector, sector_r, {GammaSQ::AnnihilateBeta}, {r});
     if (do_bHT) {
 #ifdef HAVE_MPI_H
-      if (mpi_counter++ % mpi__->size() == mpi__->rank()) {
+      if (mine(mpi_counter++)) {
 #endif
         shared_ptr<const BlockSparseMatrix> Sr = blockops->S_b(cckey, r);
         mat_block_multiply(false, true, phase, sector_r, *Sr, 1.0, *b_sector);
@@ -513,7 +524,7 @@ void FormSigmaProdRAS::bHT_branch(shared_ptr<const RASBlockVectors> cc_sector, s
     if (do_bbHT) {
       for (int s = 0; s < r; ++s) {
 #ifdef HAVE_MPI_H
-        if (mpi_counter++ % mpi__->size() == mpi__->rank()) {
+        if (mine(mpi_counter++)) {
 #endif
           tmp_bb->zero();
           apply(1.0, sector_r, *tmp_bb, {GammaSQ::AnnihilateBeta}, {s});
@@ -529,7 +540,7 @@ void FormSigmaProdRAS::bHT_branch(shared_ptr<const RASBlockVectors> cc_sector, s
     if (do_abHT) {
       for (int s = 0; s < rnorb; ++s) {
 #ifdef HAVE_MPI_H
-        if (mpi_counter++ % mpi__->size() == mpi__->rank()) {
+        if (mine(mpi_counter++)) {
 #endif
           tmp_ab->zero();
           apply(1.0, sector_r, *tmp_ab, {GammaSQ::AnnihilateAlpha}, {s});
@@ -558,7 +569,7 @@ void FormSigmaProdRAS::aexc_branch(shared_ptr<const RASBlockVectors> cc_sector,
     for (int s = 0; s < rnorb; ++s) {
       // apply (r^dagger s)_alpha to the Civecs
 #ifdef HAVE_MPI_H
-      if ((r + s*rnorb) % mpi__->size() == mpi__->rank()) {
+      if (mine(r + s*rnorb)) {
 #endif
         sector_rs.zero();
         apply(1.0, *cc_sector, sector_rs, {GammaSQ::CreateAlpha,GammaSQ::AnnihilateAlpha}, {r,s});
@@ -584,7 +595,7 @@ void FormSigmaProdRAS::bexc_branch(shared_ptr<const RASBlockVectors> cc_sector,
   for (int r = 0; r < rnorb; ++r) {
     for (int s = 0; s < rnorb; ++s) {
 #ifdef HAVE_MPI_H
-      if ((r + s*rnorb) % mpi__->size() == mpi__->rank()) {
+      if (mine(r + s*rnorb)) {
 #endif
         // apply (r^dagger s)_beta to the Civecs
         sector_rs.zero();
@@ -618,7 +629,7 @@ void FormSigmaProdRAS::abflip_branch(shared_ptr<const RASBlockVectors> cc_sector
     for (int s = 0; s < rnorb; ++s) {
       // apply (r^dagger_alpha s_beta) to the civec
 #ifdef HAVE_MPI_H
-      if ((r + s*rnorb) % mpi__->size() == mpi__->rank()) {
+      if (mine(r + s*rnorb)) {
 #endif
         sector_rs.zero();
         apply(1.0, *cc_sector, sector_rs, {GammaSQ::CreateAlpha,GammaSQ::AnnihilateBeta}, {r, s});
@@ -648,7 +659,7 @@ void FormSigmaProdRAS::baflip_branch(shared_ptr<const RASBlockVectors> cc_sector
   for (int r = 0; r < rnorb; ++r) {
     for (int s = 0; s < rnorb; ++s) {
 #ifdef HAVE_MPI_H
-      if ((r + s*rnorb) % mpi__->size() == mpi__->rank()) {
+      if (mine(r + s*rnorb)) {
 #endif
         // apply (r^dagger_beta s_alpha) to the civec
         sector_rs.zero();
@@ -682,7 +693,7 @@ void FormSigmaProdRAS::compute_sigma_3aET(shared_ptr<const RASBlockVectors> cc_s
 
   for (int p = 0; p < lnorb; ++p ) {
 #ifdef HAVE_MPI_H
-    if (p % mpi__->size() == mpi__->rank()) {
+    if (mine(p)) {
 #endif
       tmp_sector.zero();
       const double* jdata = J->element_ptr(0, p);
@@ -718,7 +729,7 @@ void FormSigmaProdRAS::compute_sigma_3aHT(shared_ptr<const RASBlockVectors> cc_s
 
   for (int p = 0; p < lnorb; ++p ) {
 #ifdef HAVE_MPI_H
-    if (p % mpi__->size() == mpi__->rank()) {
+    if (mine(p)) {
 #endif
       tmp_sector.zero();
       const double* jdata = J->element_ptr(0, p);
@@ -762,7 +773,7 @@ void FormSigmaProdRAS::compute_sigma_3bET(shared_ptr<const RASBlockVectors> cc_s
 
   for (int p = 0; p < lnorb; ++p) {
 #ifdef HAVE_MPI_H
-    if (p % mpi__->size() == mpi__->rank()) {
+    if (mine(p)) {
 #endif
       tmp_sector.zero();
       const double* jdata = J->element_ptr(0, p);
@@ -809,7 +820,7 @@ void FormSigmaProdRAS::compute_sigma_3bHT(shared_ptr<const RASBlockVectors> cc_s
 
   for (int p = 0; p < lnorb; ++p ) {
 #ifdef HAVE_MPI_H
-    if (p % mpi__->size() == mpi__->rank()) {
+    if (mine(p)) {
 #endif
       tmp_sector.zero();
       const double* jdata = J->element_ptr(0, p);
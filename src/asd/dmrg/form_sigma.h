@@ -25,6 +25,7 @@
 #ifndef __BAGEL_ASD_DMRG_FORM_SIGMA_H
 #define __BAGEL_ASD_DMRG_FORM_SIGMA_H
 
+#include <set>
 #include <src/asd/dimer/dimer_jop.h>
 #include <src/asd/dmrg/product_civec.h>
 #include <src/asd/dmrg/block_operators.h>
@@ -34,18 +35,53 @@
 
 namespace bagel {
 
+namespace DMRG {
+/// Terms of the product-space Hamiltonian, each acting on one sector of a ProductRASCivec
+enum class SigmaTerm { pure, aET, bET, aHT, bHT, exc, abflip, baflip, aET3, aHT3, bET3, bHT3 };
+
+/// One unit of work in sigma formation: one term applied to one sector of one state
+struct SigmaTask {
+  int state;
+  BlockKey key;                ///< left-block key of the ket sector
+  SigmaTerm term;
+  std::set<BlockKey> targets;  ///< sectors of sigma that are written to
+  double cost;                 ///< estimated number of flops (relative)
+  SigmaTask(const int s, const BlockKey k, const SigmaTerm t, std::set<BlockKey>&& tg, const double c) : state(s), key(k), term(t), targets(tg), cost(c) { }
+};
+}
+
 class FormSigmaProdRAS {
   protected:
     int batchsize_; ///< batchsize used in \f$\alpha\alpha\f$ and \f$\beta\beta\f$ parts of pure RAS
+    /// If true, SigmaTasks are distributed over ranks by estimated cost and over threads; otherwise the states and sectors
+    /// are processed serially and the orbital loops within each term are split over ranks.
+    bool sector_parallel_;
+
+    /// Whether the n-th piece of work inside a term is done on this rank
+    bool mine(const int n) const { return sector_parallel_ || n % mpi__->size() == mpi__->rank(); }
 
   public:
-    FormSigmaProdRAS(const int b = 512) : batchsize_(b) {}
+    FormSigmaProdRAS(const int b = 512, const bool sp = true) : batchsize_(b), sector_parallel_(sp) {}
 
     /// Applies Hamiltonian to cc using the provided MOFile, skipping the vectors marked as converged
     std::vector<std::shared_ptr<ProductRASCivec>> operator()(const std::vector<std::shared_ptr<ProductRASCivec>>& ccvec, std::shared_ptr<const BlockOperators> blockops, std::shared_ptr<DimerJop> jop, const std::vector<bool>& conv) const;
     std::vector<std::shared_ptr<ProductRASCivec>> diagonal(const std::vector<std::shared_ptr<ProductRASCivec>>& ccvec, std::shared_ptr<const BlockOperators> blockops, std::shared_ptr<DimerJop> jop, const std::vector<bool>& conv) const;
 
   private:
+    /// Task-parallel driver used when sector_parallel_ is set
+    std::vector<std::shared_ptr<ProductRASCivec>> compute_tasks(const std::vector<std::shared_ptr<ProductRASCivec>>& ccvec, std::shared_ptr<const BlockOperators> blockops,
+                                                                std::shared_ptr<DimerJop> jop, const std::vector<bool>& conv, const bool diagonal_only) const;
+    /// Lists the tasks in sigma formation for one state
+    void append_tasks(std::vector<DMRG::SigmaTask>& tasks, const int state, std::shared_ptr<const ProductRASCivec> cc, std::shared_ptr<DimerJop> jop, const bool diagonal_only) const;
+    /// Computes one task, accumulating into sigma (which only has to hold the target sectors)
+    void compute_task(const DMRG::SigmaTask& task, std::shared_ptr<const ProductRASCivec> cc, std::shared_ptr<ProductRASCivec> sigma, std::shared_ptr<const BlockOperators> blockops,
+                      std::shared_ptr<DimerJop> jop, const Matrix& g, const std::map<size_t, std::shared_ptr<Sparse_IJ>>& sparse_map) const;
+    /// One-electron part of the pure RAS Hamiltonian with the diagonal two-electron contributions folded in
+    Matrix compute_g(std::shared_ptr<DimerJop> jop, const int norb) const;
+    /// Pure block and pure RAS terms for one sector
+    void pure_sector(std::shared_ptr<const RASBlockVectors> cc_sector, std::shared_ptr<RASBlockVectors> sigma_sector, std::shared_ptr<RASSpace> space,
+                     std::shared_ptr<const BlockOperators> blockops, const Matrix& g, const double* mo2e, const Sparse_IJ& sparseij) const;
+
     // Helper functions for sigma formation
     void pure_block_and_ras(std::shared_ptr<const ProductRASCivec> cc, std::shared_ptr<ProductRASCivec> sigma, std::shared_ptr<const BlockOperators> blockops, std::shared_ptr<DimerJop> jop) const;
     void interaction_terms(std::shared_ptr<const ProductRASCivec> cc, std::shared_ptr<ProductRASCivec> sigma, std::shared_ptr<const BlockOperators> blockops, std::shared_ptr<DimerJop> jop) const;
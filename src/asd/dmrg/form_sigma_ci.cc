@@ -42,10 +42,10 @@ void FormSigmaProdRAS::resolve_H_aa(const RASBlockVectors& cc, RASBlockVectors&
   assert(M == sigma.mdim());
 
 #if HAVE_MPI_H
-  StaticDist dist(M, mpi__->size());
+  StaticDist dist(M, sector_parallel_ ? 1 : mpi__->size());
 
   size_t mstart, mend;
-  tie(mstart, mend) = dist.range(mpi__->rank());
+  tie(mstart, mend) = dist.range(sector_parallel_ ? 0 : mpi__->rank());
 #else
   const size_t mstart = 0;
   const size_t mend = M;
@@ -120,10 +120,10 @@ void FormSigmaProdRAS::resolve_H_ab(const RASBlockVectors& cc, RASBlockVectors&
   assert(M == sigma.mdim());
 
 #if HAVE_MPI_H
-  StaticDist dist(M, mpi__->size());
+  StaticDist dist(M, sector_parallel_ ? 1 : mpi__->size());
 
   size_t mstart, mend;
-  tie(mstart, mend) = dist.range(mpi__->rank());
+  tie(mstart, mend) = dist.range(sector_parallel_ ? 0 : mpi__->rank());
 #else
   const size_t mstart = 0;
   const size_t mend = M;
@@ -0,0 +1,206 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: form_sigma_parallel.cc
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <bagel_config.h>
+#ifdef HAVE_MKL_H
+  #include "mkl_service.h"
+#endif
+#include <src/asd/dmrg/form_sigma.h>
+#include <src/util/parallel/resources.h>
+
+using namespace std;
+using namespace bagel;
+using DMRG::SigmaTask;
+using DMRG::SigmaTerm;
+
+vector<shared_ptr<ProductRASCivec>> FormSigmaProdRAS::compute_tasks(const vector<shared_ptr<ProductRASCivec>>& ccvec, shared_ptr<const BlockOperators> blockops,
+                                                                    shared_ptr<DimerJop> jop, const vector<bool>& conv, const bool diagonal_only) const {
+  Timer ptime(2);
+
+  const int nstate = ccvec.size();
+  vector<shared_ptr<ProductRASCivec>> sigmavec;
+  for_each(ccvec.begin(), ccvec.end(), [&sigmavec] (shared_ptr<const ProductRASCivec> c) { sigmavec.push_back(c->clone()); });
+
+  shared_ptr<RASSpace> space = sigmavec.front()->space();
+  const int norb = space->norb();
+
+  // determinant spaces and Coulomb matrices are created on demand; make sure they exist before the threads start
+  for (auto& sec : sigmavec.front()->sectors()) {
+    const int na = sec.second->det()->nelea();
+    const int nb = sec.second->det()->neleb();
+    for (int a = max(na-2, 0); a <= min(na+2, norb); ++a)
+      for (int b = max(nb-2, 0); b <= min(nb+2, norb); ++b) {
+        space->det(a, b);
+        space->det(b, a);
+      }
+  }
+  if (!diagonal_only)
+    jop->coulomb_matrix<0,1,0,0>();
+
+  const Matrix g = compute_g(jop, norb);
+  map<size_t, shared_ptr<Sparse_IJ>> sparse_map;
+  for (auto& sec : sigmavec.front()->sectors()) {
+    const shared_ptr<const CIStringSet<RASString>> bspace = sec.second->det()->stringspaceb();
+    if (sparse_map.find(bspace->key())==sparse_map.end())
+      sparse_map.emplace(bspace->key(), make_shared<Sparse_IJ>(bspace, bspace));
+  }
+
+  vector<SigmaTask> tasks;
+  for (int istate = 0; istate != nstate; ++istate)
+    if (!conv[istate])
+      append_tasks(tasks, istate, ccvec[istate], jop, diagonal_only);
+
+  // largest first. The ordering (and hence the assignment below) is identical on all ranks
+  stable_sort(tasks.begin(), tasks.end(), [] (const SigmaTask& a, const SigmaTask& b) { return a.cost > b.cost; });
+
+  // each task goes to the rank with the smallest accumulated cost
+  vector<const SigmaTask*> mytasks;
+  vector<double> load(mpi__->size(), 0.0);
+  for (auto& t : tasks) {
+    const int rank = min_element(load.begin(), load.end()) - load.begin();
+    load[rank] += t.cost;
+    if (rank == mpi__->rank())
+      mytasks.push_back(&t);
+  }
+  ptime.tick_print("sigma task setup");
+
+  // one lock per sector of sigma; tasks accumulate into private vectors that only hold their target sectors
+  map<pair<int, BlockKey>, shared_ptr<mutex>> locks;
+  for (int istate = 0; istate != nstate; ++istate)
+    for (auto& sec : sigmavec[istate]->sectors())
+      locks.emplace(make_pair(istate, sec.first), make_shared<mutex>());
+
+  auto run = [&] (const SigmaTask& t) {
+    shared_ptr<ProductRASCivec> cc = ccvec[t.state];
+    auto partial = make_shared<ProductRASCivec>(space, cc->left(), cc->nelea(), cc->neleb(), t.targets);
+    compute_task(t, cc, partial, blockops, jop, g, sparse_map);
+    for (auto& sec : partial->sectors()) {
+      lock_guard<mutex> lock(*locks.at(make_pair(t.state, sec.first)));
+      sigmavec[t.state]->sector(sec.first)->ax_plus_y(1.0, *sec.second);
+    }
+  };
+
+  // threads take the next most expensive task when they become idle
+  atomic<size_t> next(0);
+  auto worker = [&] () {
+    for (size_t i = next++; i < mytasks.size(); i = next++)
+      run(*mytasks[i]);
+  };
+
+#ifdef HAVE_MKL_H
+  const int mkl_num = mkl_get_max_threads();
+  mkl_set_num_threads(1);
+#endif
+  resources__->begin_parallel();
+  const size_t nthreads = min(resources__->max_num_threads(), mytasks.size());
+  list<thread> threads;
+  for (size_t i = 1; i < nthreads; ++i)
+    threads.emplace_back(worker);
+  worker();
+  for (auto& i : threads)
+    i.join();
+  resources__->end_parallel();
+#ifdef HAVE_MKL_H
+  mkl_set_num_threads(mkl_num);
+#endif
+  ptime.tick_print("sigma tasks");
+
+#ifdef HAVE_MPI_H
+  // only the sectors that were written to by some task are reduced
+  set<pair<int, BlockKey>> touched;
+  for (auto& t : tasks)
+    for (auto& k : t.targets)
+      touched.emplace(t.state, k);
+  for (auto& i : touched)
+    sigmavec[i.first]->sector(i.second)->allreduce();
+  ptime.tick_print("sigma reduction");
+#endif
+
+  return sigmavec;
+}
+
+
+void FormSigmaProdRAS::append_tasks(vector<SigmaTask>& tasks, const int state, shared_ptr<const ProductRASCivec> cc, shared_ptr<DimerJop> jop, const bool diagonal_only) const {
+  const double rnorb = cc->space()->norb();
+  const double lnorb = jop->monomer_jop<1>()->nocc();
+
+  for (auto& isec : cc->sectors()) {
+    const BlockKey k = isec.first;
+    const double n = isec.second->size();
+
+    // only the sectors that exist in the product space are targets; the term is skipped when there are none
+    auto add = [&] (const SigmaTerm term, initializer_list<BlockKey> keys, const double cost) {
+      set<BlockKey> targets;
+      for (auto& t : keys)
+        if (cc->contains_block(t)) targets.insert(t);
+      if (!targets.empty())
+        tasks.emplace_back(state, k, term, move(targets), cost);
+    };
+
+    add(SigmaTerm::pure, {k}, n*(isec.second->mdim() + rnorb*rnorb));
+    add(SigmaTerm::exc,  {k}, 2.0*n*rnorb*rnorb);
+    if (diagonal_only) continue;
+
+    add(SigmaTerm::aET,    {BlockKey(k.nelea-1, k.neleb), BlockKey(k.nelea-2, k.neleb)}, n*rnorb*rnorb);
+    add(SigmaTerm::bET,    {BlockKey(k.nelea, k.neleb-1), BlockKey(k.nelea, k.neleb-2), BlockKey(k.nelea-1, k.neleb-1)}, 1.5*n*rnorb*rnorb);
+    add(SigmaTerm::aHT,    {BlockKey(k.nelea+1, k.neleb), BlockKey(k.nelea+2, k.neleb)}, n*rnorb*rnorb);
+    add(SigmaTerm::bHT,    {BlockKey(k.nelea, k.neleb+1), BlockKey(k.nelea, k.neleb+2), BlockKey(k.nelea+1, k.neleb+1)}, 1.5*n*rnorb*rnorb);
+    add(SigmaTerm::abflip, {BlockKey(k.nelea-1, k.neleb+1)}, n*rnorb*rnorb);
+    add(SigmaTerm::baflip, {BlockKey(k.nelea+1, k.neleb-1)}, n*rnorb*rnorb);
+    add(SigmaTerm::aET3,   {BlockKey(k.nelea-1, k.neleb)}, n*lnorb*rnorb*rnorb);
+    add(SigmaTerm::aHT3,   {BlockKey(k.nelea+1, k.neleb)}, n*lnorb*rnorb*rnorb);
+    add(SigmaTerm::bET3,   {BlockKey(k.nelea, k.neleb-1)}, n*lnorb*rnorb*rnorb);
+    add(SigmaTerm::bHT3,   {BlockKey(k.nelea, k.neleb+1)}, n*lnorb*rnorb*rnorb);
+  }
+}
+
+
+void FormSigmaProdRAS::compute_task(const SigmaTask& task, shared_ptr<const ProductRASCivec> cc, shared_ptr<ProductRASCivec> sigma, shared_ptr<const BlockOperators> blockops,
+                                    shared_ptr<DimerJop> jop, const Matrix& g, const map<size_t, shared_ptr<Sparse_IJ>>& sparse_map) const {
+  shared_ptr<const RASBlockVectors> cc_sector = cc->sector(task.key);
+  switch (task.term) {
+    case SigmaTerm::pure:
+      pure_sector(cc_sector, sigma->sector(task.key), sigma->space(), blockops, g, jop->monomer_jop<0>()->mo2e()->data(),
+                  *sparse_map.at(cc_sector->det()->stringspaceb()->key()));
+      break;
+    case SigmaTerm::exc:
+      aexc_branch(cc_sector, sigma, blockops);
+      bexc_branch(cc_sector, sigma, blockops);
+      break;
+    case SigmaTerm::aET:    aET_branch(cc_sector, sigma, blockops); break;
+    case SigmaTerm::bET:    bET_branch(cc_sector, sigma, blockops); break;
+    case SigmaTerm::aHT:    aHT_branch(cc_sector, sigma, blockops); break;
+    case SigmaTerm::bHT:    bHT_branch(cc_sector, sigma, blockops); break;
+    case SigmaTerm::abflip: abflip_branch(cc_sector, sigma, blockops); break;
+    case SigmaTerm::baflip: baflip_branch(cc_sector, sigma, blockops); break;
+    case SigmaTerm::aET3:   compute_sigma_3aET(cc_sector, sigma, blockops, jop); break;
+    case SigmaTerm::aHT3:   compute_sigma_3aHT(cc_sector, sigma, blockops, jop); break;
+    case SigmaTerm::bET3:   compute_sigma_3bET(cc_sector, sigma, blockops, jop); break;
+    case SigmaTerm::bHT3:   compute_sigma_3bHT(cc_sector, sigma, blockops, jop); break;
+  }
+}
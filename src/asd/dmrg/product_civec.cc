@@ -69,6 +69,23 @@ ProductRASCivec::ProductRASCivec(shared_ptr<RASSpace> space, shared_ptr<const DM
 }
 
 
+ProductRASCivec::ProductRASCivec(shared_ptr<RASSpace> space, shared_ptr<const DMRG_Block> left, const int nelea, const int neleb, const set<BlockKey>& keys) :
+  space_(space), left_(left), nelea_(nelea), neleb_(neleb) {
+
+  for (auto& block : left_->blocks()) {
+    if (!keys.count(block.key())) continue;
+    const int na = nelea_ - block.nelea;
+    const int nb = neleb_ - block.neleb;
+
+    if (na >= 0 && na <= space->norb() && nb >= 0 && nb <= space->norb()) {
+      shared_ptr<RASDeterminants> det = space_->det(na, nb);
+      if (det->size() > 0)
+        sectors_.emplace(block, make_shared<RASBlockVectors>(det, block));
+    }
+  }
+}
+
+
 /// Copy-constructor
 ProductRASCivec::ProductRASCivec(const ProductRASCivec& o) : space_(o.space_), left_(o.left_), nelea_(o.nelea_), neleb_(o.neleb_) {
   for (auto& sec : o.sectors_)
@@ -26,6 +26,7 @@
 #define __BAGEL_ASD_DMRG_PRODUCT_RAS_H
 
 #include <algorithm>
+#include <set>
 #include <src/ci/ras/ras_space.h>
 #include <src/ci/ras/civector.h>
 #include <src/asd/dmrg/dmrg_block.h>
@@ -90,6 +91,8 @@ class ProductRASCivec {
 
   public:
     ProductRASCivec(std::shared_ptr<RASSpace> space, std::shared_ptr<const DMRG_Block> left, const int nelea, const int neleb); ///< Constructor
+    /// Constructor that only allocates the sectors listed in keys (used for partial results in sigma formation)
+    ProductRASCivec(std::shared_ptr<RASSpace> space, std::shared_ptr<const DMRG_Block> left, const int nelea, const int neleb, const std::set<BlockKey>& keys);
     ProductRASCivec(const ProductRASCivec& o); ///< Copy-constructor
     ProductRASCivec(ProductRASCivec&& o); ///< Move-constructor
 
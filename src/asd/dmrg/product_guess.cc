@@ -80,7 +80,7 @@ void ProductRASCI::model_guess(vector<shared_ptr<ProductRASCivec>>& out) {
     vector<shared_ptr<ProductRASCivec>> guessvecs = out;
     const double nuc_core = ref_->geom()->nuclear_repulsion() + jop_->core_energy();
     DavidsonDiag<ProductRASCivec> davidson(nstate_, davidson_subspace_);
-    FormSigmaProdRAS form_sigma(batchsize_);
+    FormSigmaProdRAS form_sigma(batchsize_, sector_parallel_);
     cout << "  === Preconverging with particle number preserving terms ===" << endl;
 
     vector<bool> converged(nstate_, false);
@@ -48,6 +48,7 @@ ProductRASCI::ProductRASCI(shared_ptr<const PTree> input, shared_ptr<const Refer
   preconv_thresh_ = input_->get<int>("preconv_thresh", 1.0e-6);
 
   batchsize_ = input_->get<int>("batchsize", 512);
+  sector_parallel_ = input_->get<bool>("sector_parallel", true);
 
   nstate_ = input_->get<int>("nstate", 1);
   nguess_ = input_->get<int>("nguess", nstate_);
@@ -160,7 +161,7 @@ void ProductRASCI::compute() {
   DavidsonDiag<ProductRASCivec> davidson(nstate_, davidson_subspace_);
 
   // Object in charge of forming sigma vector
-  FormSigmaProdRAS form_sigma(batchsize_);
+  FormSigmaProdRAS form_sigma(batchsize_, sector_parallel_);
 
   // main iteration starts here
   cout << "  === ProductRAS-CI iterations ===" << endl << endl;
@@ -52,6 +52,7 @@ class ProductRASCI {
     int preconv_iter_; ///< maximum number of iterations for preconvergence
 
     int batchsize_; ///< batchsize used in sigma_aa and sigma_bb portions of FormSigma
+    bool sector_parallel_; ///< if true, sigma formation is distributed over (sector, term) tasks
 
     int nelea_; ///< total number of \f$\alpha\f$ electrons in product space
     int neleb_; ///< total number of \f$\alpha\f$ electrons in product space
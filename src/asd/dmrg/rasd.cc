@@ -93,7 +93,7 @@ shared_ptr<Matrix> RASD::compute_sigma2e(shared_ptr<const RASDvec> cc, shared_pt
 
 shared_ptr<Matrix> RASD::compute_sigma2e(const vector<shared_ptr<ProductRASCivec>>& cc, shared_ptr<const DimerJop> jop) const {
   const int nstates = cc.size();
-  FormSigmaProdRAS form_2e(input_->get_child("ras")->get<int>("batchsize", 512));
+  FormSigmaProdRAS form_2e(input_->get_child("ras")->get<int>("batchsize", 512), input_->get_child("ras")->get<bool>("sector_parallel", true));
   auto jop_2e = make_shared<DimerJop>(cc.front()->space()->norb(), cc.front()->left()->norb(), jop->mo1e()->clone(), jop->mo2e()->copy());
   shared_ptr<const BlockOperators> blockops = cc.front()->left()->compute_block_ops(jop_2e);
   vector<shared_ptr<ProductRASCivec>> sigma = form_2e(cc, blockops, jop_2e, vector<bool>(nstates, false));
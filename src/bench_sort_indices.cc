@@ -0,0 +1,164 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: bench_sort_indices.cc
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+// Benchmark of sort_indices for the permutations that appear most often in the code generated for SMITH.
+// Each permutation is checked against the straightforward loop, which is also timed for comparison.
+// usage: SortIndicesBench [extent of each index (default 32)] [number of threads (default 1)]
+
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+#include <string>
+#include <src/util/prim_op.h>
+#include <src/util/parallel/resources.h>
+#include <src/util/parallel/mpi_interface.h>
+
+using namespace std;
+using namespace bagel;
+
+static MPI_Interface c;
+MPI_Interface* bagel::mpi__ = &c;
+
+Resources* bagel::resources__;
+
+namespace {
+
+// the loop used by sort_indices before the tiled implementation
+template<int an, int fn, int... perm>
+void reference(const double* unsorted, double* sorted, const array<int, sizeof...(perm)>& dim) {
+  constexpr int N = sizeof...(perm);
+  const array<int,N> p{{perm...}};
+  array<int,N> id;
+  id.fill(0);
+  size_t size = 1;
+  for (auto& i : dim) size *= i;
+  for (size_t iall = 0; iall != size; ++iall) {
+    size_t ib = 0;
+    for (int n = N-1; n >= 0; --n)
+      ib = id[p[n]] + dim[p[n]]*ib;
+    sorted[ib] = an != 0 ? an*sorted[ib] + fn*unsorted[iall] : fn*unsorted[iall];
+    for (int n = 0; n != N && ++id[n] == dim[n]; ++n)
+      id[n] = 0;
+  }
+}
+
+template<class F>
+double timing(F f, const size_t size) {
+  // repeated until at least 0.2 second elapsed
+  int repeat = 0;
+  auto start = chrono::high_resolution_clock::now();
+  double elapsed;
+  do {
+    f();
+    ++repeat;
+    elapsed = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+  } while (elapsed < 0.2);
+  // GB/s counting one read and one write of each element
+  return 2.0 * size * sizeof(double) * repeat / elapsed * 1.0e-9;
+}
+
+template<int an, int fn, int... perm>
+struct Bench {
+  template<typename... Ints>
+  static void run(Ints... extents) {
+    const array<int, sizeof...(perm)> dim{{extents...}};
+    size_t size = 1;
+    for (auto& i : dim) size *= i;
+
+    mt19937 gen(11);
+    uniform_real_distribution<double> dist(-1.0, 1.0);
+    unique_ptr<double[]> in(new double[size]);
+    unique_ptr<double[]> out(new double[size]);
+    unique_ptr<double[]> ref(new double[size]);
+    for (size_t i = 0; i != size; ++i) {
+      in[i] = dist(gen);
+      out[i] = ref[i] = dist(gen);
+    }
+
+    reference<an,fn,perm...>(in.get(), ref.get(), dim);
+    sort_indices<perm...,an,1,fn,1>(in.get(), out.get(), extents...);
+    double error = 0.0;
+    for (size_t i = 0; i != size; ++i)
+      error = max(error, fabs(out[i] - ref[i]));
+
+    const double tref = timing([&]() { reference<an,fn,perm...>(in.get(), ref.get(), dim); }, size);
+    const double tnew = timing([&]() { sort_indices<perm...,an,1,fn,1>(in.get(), out.get(), extents...); }, size);
+
+    string label;
+    for (auto& i : {perm...}) label += to_string(i);
+    label += an ? " +=" : "  =";
+    cout << "  " << setw(8) << left << label << right << setw(12) << size
+         << fixed << setprecision(2) << setw(10) << tref << setw(10) << tnew << " GB/s"
+         << scientific << setprecision(1) << setw(10) << error << endl;
+    if (error > 1.0e-12)
+      throw runtime_error("sort_indices gives wrong results");
+  }
+};
+
+}
+
+
+int main(int argc, char** argv) {
+  const int n = argc > 1 ? stoi(argv[1]) : 32;
+  const int nthreads = argc > 2 ? stoi(argv[2]) : 1;
+  Resources res(nthreads);
+  resources__ = &res;
+
+  cout << "  permutation        size      loop     tiled            error" << endl;
+
+  // the two-index ones are used for each pair of tiles
+  Bench<0,1,1,0>::run(n*n, n*n);
+  Bench<1,1,1,0>::run(n*n, n*n);
+
+  // the four-index ones ordered by the number of appearances in src/smith
+  Bench<0,1,0,1,2,3>::run(n, n, n, n);
+  Bench<1,1,3,0,1,2>::run(n, n, n, n);
+  Bench<1,1,2,3,0,1>::run(n, n, n, n);
+  Bench<0,1,2,3,0,1>::run(n, n, n, n);
+  Bench<0,1,1,0,2,3>::run(n, n, n, n);
+  Bench<0,1,0,3,1,2>::run(n, n, n, n);
+  Bench<0,1,1,2,0,3>::run(n, n, n, n);
+  Bench<1,1,1,2,3,0>::run(n, n, n, n);
+  Bench<0,1,2,0,1,3>::run(n, n, n, n);
+  Bench<0,1,0,2,3,1>::run(n, n, n, n);
+  Bench<0,1,3,0,1,2>::run(n, n, n, n);
+  Bench<1,1,3,2,1,0>::run(n, n, n, n);
+  Bench<0,1,1,3,0,2>::run(n, n, n, n);
+  Bench<0,1,0,2,1,3>::run(n, n, n, n);
+  Bench<0,1,0,1,3,2>::run(n, n, n, n);
+  Bench<0,1,2,1,0,3>::run(n, n, n, n);
+  Bench<1,1,3,2,0,1>::run(n, n, n, n);
+  Bench<1,1,1,0,3,2>::run(n, n, n, n);
+  Bench<1,1,2,0,3,1>::run(n, n, n, n);
+  Bench<0,1,3,1,0,2>::run(n, n, n, n);
+
+  // six-index ones that appear in the three-body terms
+  const int m = max(2, n/4);
+  Bench<1,1,0,1,2,3,4,5>::run(m, m, m, m, m, m);
+  Bench<0,1,0,2,3,1,4,5>::run(m, m, m, m, m, m);
+  Bench<0,1,0,1,3,2,4,5>::run(m, m, m, m, m, m);
+  Bench<1,1,3,4,5,0,1,2>::run(m, m, m, m, m, m);
+  return 0;
+}
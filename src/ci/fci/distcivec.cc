@@ -32,9 +32,7 @@ template<typename DataType>
 DistCivector<DataType>::DistCivector(shared_ptr<const Determinants> det)
   : RMAWindow<DataType>(), det_(det), lena_(det->lena()), lenb_(det->lenb()), dist_(lena_, mpi__->size()),
     astart_(dist_.start(mpi__->rank())), aend_(astart_ + dist_.size(mpi__->rank())) {
-  if (size() == 0)
-    throw runtime_error("Use either Knowles or Harrison for FCI");
-  // create an window
+  // create an window (which may be empty on some of the processes)
   this->initialize();
 }
 
@@ -79,7 +77,8 @@ shared_ptr<DistCivector<DataType>> DistCivector<DataType>::transpose() const {
 
   // send buffer
   unique_ptr<DataType[]> buf(new DataType[max(size(), out->size())]);
-  blas::transpose(local_data(), lenb_, asize(), buf.get());
+  if (size())
+    blas::transpose(local_data(), lenb_, asize(), buf.get());
 
   {
     RMAWindow_bare<DataType> sendwin(size());
@@ -94,6 +94,8 @@ void DistFCI::common_init() {
   // construct a determinant space in which this FCI will be performed.
   space_ = make_shared<HZSpace>(norb_, nelea_, neleb_);
   det_ = space_->finddet(nelea_, neleb_);
+  if (min(det_->lena(), det_->lenb()) < mpi__->size())
+    throw runtime_error("Use either Knowles or Harrison for FCI");
 }
 
 
@@ -168,15 +170,16 @@ void DistFCI::model_guess(vector<shared_ptr<DistCivec>>& out) {
 
     shared_ptr<Matrix> hamiltonian = make_shared<CIHamiltonian>(basis, jop_);
     hamiltonian = make_shared<Matrix>(coeffs % *hamiltonian * coeffs);
-    hamiltonian->diagonalize(eigs);
+    // only the lowest nstate_ roots are needed
+    hamiltonian = hamiltonian->diagonalize_range(eigs, 0, nstate_);
 
 #if 0
     const double nuc_core = geom_->nuclear_repulsion() + jop_->core_energy();
-    for (int i = 0; i < end-start; ++i)
+    for (int i = 0; i < nstate_; ++i)
       cout << setw(12) << setprecision(8) << eigs(i) + nuc_core << endl;
 #endif
 
-    auto coeffs1 = (coeffs * *hamiltonian).slice_copy(0, nstate_);
+    auto coeffs1 = make_shared<Matrix>(coeffs * *hamiltonian);
     mpi__->broadcast(coeffs1->data(), coeffs1->ndim() * coeffs1->mdim(), 0);
     for (int i = 0; i < nguess; ++i) {
       size_t ia = det_->lexical<0>(basis[i].first);
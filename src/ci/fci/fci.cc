@@ -26,6 +26,7 @@
 #include <src/ci/fci/space.h>
 #include <src/ci/fci/modelci.h>
 #include <src/util/combination.hpp>
+#include <src/util/io/checkpoint.h>
 
 using namespace std;
 using namespace bagel;
@@ -134,11 +135,12 @@ void FCI::model_guess(shared_ptr<Dvec> out) {
 
     shared_ptr<Matrix> hamiltonian = make_shared<CIHamiltonian>(basis, jop_);
     hamiltonian = make_shared<Matrix>(coeffs % *hamiltonian * coeffs);
-    hamiltonian->diagonalize(eigs);
+    // only the lowest nstate_ roots are needed
+    hamiltonian = hamiltonian->diagonalize_range(eigs, 0, nstate_);
 
 #if 0
     const double nuc_core = geom_->nuclear_repulsion() + jop_->core_energy();
-    for (int i = 0; i < end-start; ++i)
+    for (int i = 0; i < nstate_; ++i)
       cout << setw(12) << setprecision(8) << eigs(i) + nuc_core << endl;
 #endif
 
@@ -268,6 +270,12 @@ void FCI::compute() {
   // nuclear energy retrieved from geometry
   const double nuc_core = geom_->nuclear_repulsion() + jop_->core_energy();
 
+#ifndef DISABLE_SERIALIZATION
+  // with restart_keep, archives are written in the background and only the last ones are kept
+  const int restart_keep = idata_->get<int>("restart_keep", 0);
+  shared_ptr<Checkpoint> checkpoint = restart_ && restart_keep > 0 ? make_shared<Checkpoint>("fci", restart_keep) : nullptr;
+#endif
+
   // main iteration starts here
   cout << "  === FCI iteration ===" << endl << endl;
   // 0 means not converged
@@ -281,7 +289,13 @@ void FCI::compute() {
     pdebug.tick_print("sigma vector");
 
 #ifndef DISABLE_SERIALIZATION
-    if (restart_) {
+    if (checkpoint) {
+      // CI coefficients are updated in place; the Davidson subspace is shared with the copy
+      shared_ptr<FCI> snapshot = copy();
+      snapshot->cc_ = make_shared<Dvec>(*cc_);
+      snapshot->davidson_ = make_shared<DavidsonDiag<Civec>>(*davidson_);
+      checkpoint->save<Method>(iter, snapshot);
+    } else if (restart_) {
       stringstream ss; ss << "fci_" << iter;
       OArchive ar(ss.str());
       ar << static_cast<Method*>(this);
@@ -28,6 +28,7 @@
 #include <src/ci/fci/dvec.h>
 #include <src/ci/fci/properties.h>
 #include <src/ci/fci/fci_base.h>
+#include <src/wfn/packedrdm.h>
 
 namespace bagel {
 
@@ -54,6 +55,11 @@ class FCI : public FCI_base<Civec,Dvec> {
     // generate spin-adapted guess configurations
     virtual std::vector<std::pair<std::bitset<nbit__>, std::bitset<nbit__>>> detseeds(const int ndet) const;
 
+    // <J|E_kl|I><I|E_ij|0> - delta_il <J|E_kj|0> for kl >= ij and J in [offset, offset+dsize)
+    void rdm34_evec_half(std::shared_ptr<const Dvec> d, std::shared_ptr<Matrix> e, const size_t dsize, const size_t offset) const;
+    // 3RDM between two CI vectors (rdm2 is the 2RDM between the same vectors)
+    std::shared_ptr<RDM<3>> rdm3_from_civec(std::shared_ptr<const Civec> cbra, std::shared_ptr<const Civec> cket, std::shared_ptr<const RDM<2>> rdm2) const;
+
     /* Virtual functions -- these MUST be defined in the derived class*/
     // denominator
     virtual void const_denom() override = 0;
@@ -71,12 +77,18 @@ class FCI : public FCI_base<Civec,Dvec> {
     virtual ~FCI() { }
     virtual void compute() override;
     virtual void update(std::shared_ptr<const Matrix>) = 0;
+    // shallow copy used for checkpointing
+    virtual std::shared_ptr<FCI> copy() const = 0;
 
     // virtual application of Hamiltonian
     virtual std::shared_ptr<Dvec> form_sigma(std::shared_ptr<const Dvec> c, std::shared_ptr<const MOFile> jop, const std::vector<int>& conv) const = 0;
 
     // compute 3 and 4 RDMs
     std::tuple<std::shared_ptr<RDM<3>>, std::shared_ptr<RDM<4>>> rdm34(const int ist, const int jst) const override;
+    // compute 3 and 4 RDMs in the packed format (the full 4 RDM is never formed)
+    std::tuple<std::shared_ptr<PackedRDM<3>>, std::shared_ptr<PackedRDM<4>>> rdm34_packed(const int ist, const int jst) const;
+    // compute 3 RDM and 4 RDM contracted with fock on the last pair, without forming 4 RDM
+    std::tuple<std::shared_ptr<RDM<3>>, std::shared_ptr<RDM<3>>> rdm34f(const int ist, const int jst, std::shared_ptr<const Matrix> fock) const override;
     // compute "alpha" 1 and 2 RDMs <ia ja> and <ia ja, k, l>
     std::tuple<std::shared_ptr<RDM<1>>, std::shared_ptr<RDM<2>>> rdm12_alpha(const int ist, const int jst) const override;
     // compute "alpha" 3 and 4 RDMs <ia ja, k, l, m n>...
@@ -113,6 +125,7 @@ class FCI_bare : public FCI {
 
     void compute() override { assert(false); }
     void update(std::shared_ptr<const Matrix>) override { assert(false); }
+    std::shared_ptr<FCI> copy() const override { assert(false); return nullptr; }
     std::shared_ptr<Dvec> form_sigma(std::shared_ptr<const Dvec>, std::shared_ptr<const MOFile>, const std::vector<int>&) const override { assert(false); return nullptr; }
 };
 
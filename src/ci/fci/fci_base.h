@@ -151,6 +151,8 @@ class FCI_base : public Method {
     void compute_rdm12(const int ist, const int jst);
     // compute 3 and 4 RDMs
     virtual std::tuple<std::shared_ptr<RDM<3>>, std::shared_ptr<RDM<4>>> rdm34(const int ist, const int jst) const = 0;
+    // compute 3 RDM and sum_gh 4RDM(a,b,c,d,e,f,g,h) fock(g,h)
+    virtual std::tuple<std::shared_ptr<RDM<3>>, std::shared_ptr<RDM<3>>> rdm34f(const int ist, const int jst, std::shared_ptr<const Matrix> fock) const = 0;
     // compute "alpha" 1 and 2 RDMs <ia ja> and <ia ja, k, l>
     virtual std::tuple<std::shared_ptr<RDM<1>>, std::shared_ptr<RDM<2>>> rdm12_alpha(const int ist, const int jst) const = 0;
     // compute "alpha" 3 and 4 RDMs <ia ja, k, l, m n>...
@@ -25,6 +25,7 @@
 
 #include <src/ci/fci/fci.h>
 #include <src/util/prim_op.h>
+#include <src/util/taskqueue.h>
 #include <src/util/math/algo.h>
 #include <src/wfn/rdm.h>
 
@@ -68,10 +69,81 @@ tuple<shared_ptr<RDM<1>>, shared_ptr<RDM<2>>>
 }
 
 
+// <J|E_kl|I><I|E_ij|0> - delta_il <J|E_kj|0> for kl >= ij; columns are distributed over processes and threads
+void FCI::rdm34_evec_half(shared_ptr<const Dvec> d, shared_ptr<Matrix> e, const size_t dsize, const size_t offset) const {
+  const int norb2 = norb_ * norb_;
+  const int lena = cc_->det()->lena();
+  const int lenb = cc_->det()->lenb();
+
+  TaskQueue<function<void(void)>> tq(norb2);
+  for (int ij = 0; ij != norb2; ++ij) {
+    tq.emplace_back(
+      [this, &d, &e, ij, norb2, lena, lenb, dsize, offset] () {
+        const int j = ij/norb_;
+        const int i = ij-j*norb_;
+        // first column for this ij
+        int no = ij*norb2 - ij*(ij-1)/2;
+
+        for (int kl = ij; kl != norb2; ++kl, ++no) {
+          if ((kl - ij) % mpi__->size() != mpi__->rank())
+            continue;
+          const int l = kl/norb_;
+          const int k = kl-l*norb_;
+
+          for (auto& iter : cc_->det()->phia(k,l)) {
+            size_t iaJ = iter.source;
+            size_t iaI = iter.target;
+            double sign = static_cast<double>(iter.sign);
+            for (size_t ib = 0; ib != lenb; ++ib) {
+              size_t iI = ib + iaI*lenb;
+              size_t iJ = ib + iaJ*lenb;
+              if ((iJ - offset) < dsize)
+                e->element(iJ-offset, no) += sign * d->data(ij)->data(iI);
+            }
+          }
+
+          for (size_t ia = 0; ia != lena; ++ia) {
+            for (auto& iter : cc_->det()->phib(k,l)) {
+              size_t ibJ = iter.source;
+              size_t ibI = iter.target;
+              double sign = static_cast<double>(iter.sign);
+              size_t iI = ibI + ia*lenb;
+              size_t iJ = ibJ + ia*lenb;
+              if ((iJ - offset) < dsize)
+                e->element(iJ-offset, no) += sign * d->data(ij)->data(iI);
+            }
+          }
+
+          if (i == l) {
+            const int kj = k+j*norb_;
+            for (size_t iJ = offset; iJ != offset+dsize; ++iJ) {
+              e->element(iJ-offset, no) -= d->data(kj)->data(iJ);
+            }
+          }
+        }
+      }
+    );
+  }
+  tq.compute();
+
+  e->allreduce();
+}
+
+
 // computes 3 and 4RDM
 tuple<shared_ptr<RDM<3>>, shared_ptr<RDM<4>>> FCI::rdm34(const int ist, const int jst) const {
+  shared_ptr<PackedRDM<3>> rdm3;
+  shared_ptr<PackedRDM<4>> rdm4;
+  tie(rdm3, rdm4) = rdm34_packed(ist, jst);
+  return make_tuple(rdm3->unpack(), rdm4->unpack());
+}
+
+
+// computes 3 and 4RDM in the packed format. The 4RDM is accumulated directly into the packed storage (see PackedRDM::add);
+// only the 3RDM is kept in the full format while the normal-ordering corrections are applied.
+tuple<shared_ptr<PackedRDM<3>>, shared_ptr<PackedRDM<4>>> FCI::rdm34_packed(const int ist, const int jst) const {
   auto rdm3 = make_shared<RDM<3>>(norb_);
-  auto rdm4 = make_shared<RDM<4>>(norb_);
+  auto rdm4 = make_shared<PackedRDM<4>>(norb_);
 
   auto detex = make_shared<Determinants>(norb_, nelea_, neleb_, false, /*mute=*/true);
   cc_->set_det(detex);
@@ -91,63 +163,6 @@ tuple<shared_ptr<RDM<3>>, shared_ptr<RDM<4>>> FCI::rdm34(const int ist, const in
     sigma_2a2(cket, dket);
   }
 
-  // second make <J|E_kl|I><I|E_ij|0> - delta_il <J|E_kj|0>
-  auto make_evec_half = [this](shared_ptr<Dvec> d, shared_ptr<Matrix> e, const int dsize, const int offset) {
-    const int norb2 = norb_ * norb_;
-    const int lena = cc_->det()->lena();
-    const int lenb = cc_->det()->lenb();
-    int no = 0;
-
-    for (int ij = 0; ij != norb2; ++ij) {
-      const int j = ij/norb_;
-      const int i = ij-j*norb_;
-
-      for (int kl = ij; kl != norb2; ++kl) {
-        if ((kl - ij) % mpi__->size() != mpi__->rank()) {
-          ++no;
-          continue;
-        }
-        const int l = kl/norb_;
-        const int k = kl-l*norb_;
-
-        for (auto& iter : cc_->det()->phia(k,l)) {
-          size_t iaJ = iter.source;
-          size_t iaI = iter.target;
-          double sign = static_cast<double>(iter.sign);
-          for (size_t ib = 0; ib != lenb; ++ib) {
-            size_t iI = ib + iaI*lenb;
-            size_t iJ = ib + iaJ*lenb;
-            if ((iJ - offset) < dsize)
-              e->element(iJ-offset, no) += sign * d->data(ij)->data(iI);
-          }
-        }
-
-        for (size_t ia = 0; ia != lena; ++ia) {
-          for (auto& iter : cc_->det()->phib(k,l)) {
-            size_t ibJ = iter.source;
-            size_t ibI = iter.target;
-            double sign = static_cast<double>(iter.sign);
-            size_t iI = ibI + ia*lenb;
-            size_t iJ = ibJ + ia*lenb;
-            if ((iJ - offset) < dsize)
-              e->element(iJ-offset, no) += sign * d->data(ij)->data(iI);
-          }
-        }
-
-        if (i == l) {
-          const int kj = k+j*norb_;
-          for (size_t iJ = offset; iJ != offset+dsize; ++iJ) {
-            e->element(iJ-offset, no) -= d->data(kj)->data(iJ);
-          }
-        }
-        ++no;
-      }
-    }
-
-    e->allreduce();
-
-  };
-
   // When the number of words in <I|E_ij,kl|0> is larger than (10,10) case (which is 635,040,000)
   const size_t ndet = cbra->det()->size();
   const size_t norb2 = norb_ * norb_;
@@ -170,8 +185,8 @@ tuple<shared_ptr<RDM<3>>, shared_ptr<RDM<4>>> FCI::rdm34(const int ist, const in
     const size_t isize = (ipass != (npass - 1)) ? nsize : ndet - ioffset;
     const size_t halfsize = norb2 * (norb2 + 1) / 2;
     auto eket_half = make_shared<Matrix>(isize, halfsize);
-    make_evec_half(dket, eket_half, isize, ioffset);
- 
+    rdm34_evec_half(dket, eket_half, isize, ioffset);
+
     auto dbram = make_shared<Matrix>(isize, norb2);
     for (size_t ij = 0; ij != norb2; ++ij)
       copy_n(&(dbra->data(ij)->data(ioffset)), isize, dbram->element_ptr(0, ij));
@@ -198,26 +213,23 @@ tuple<shared_ptr<RDM<3>>, shared_ptr<RDM<4>>> FCI::rdm34(const int ist, const in
     shared_ptr<Matrix> ebra_half = eket_half;
     if (cbra != cket) {
       ebra_half = eket_half->clone();
-      make_evec_half(dbra, ebra_half, isize, ioffset);
+      rdm34_evec_half(dbra, ebra_half, isize, ioffset);
     }
     auto tmp4 = make_shared<Matrix>(*ebra_half % *eket_half);
-    auto tmp4_full = make_shared<Matrix>(norb2 * norb2, norb2 * norb2);
 
+    // scatter into the fourth-order RDM (ij,kl,mn,op -> j,i,l,k,m,n,o,p). The (up to) four elements written for each
+    // entry of tmp4 are related by particle exchange, and therefore share one packed element.
     {
+      auto swap = [this](const size_t ij) { return ij/norb_ + (ij%norb_)*norb_; };
       int nklij = 0;
       for (size_t kl = 0; kl != norb2; ++kl) {
         for (size_t ij = kl; ij != norb2; ++ij) {
+          const double fac = ij != kl ? 2.0 : 1.0;
           int nmnop = 0;
-          int klij = kl+ij*norb2;
-          int ijkl = ij+kl*norb2;
           for (size_t mn = 0; mn != norb2; ++mn) {
             for (size_t op = mn; op != norb2; ++op) {
-              int mnop = mn + op*norb2;
-              int opmn = op + mn*norb2;
-              tmp4_full->element(ijkl, mnop) = tmp4->element(nklij, nmnop);
-              tmp4_full->element(klij, mnop) = tmp4->element(nklij, nmnop);
-              tmp4_full->element(ijkl, opmn) = tmp4->element(nklij, nmnop);
-              tmp4_full->element(klij, opmn) = tmp4->element(nklij, nmnop);
+              const double val = tmp4->element(nklij, nmnop) * (op != mn ? fac*2.0 : fac);
+              rdm4->add_pairs(val, {{static_cast<int>(swap(ij)), static_cast<int>(swap(kl)), static_cast<int>(mn), static_cast<int>(op)}});
               ++nmnop;
             }
           }
@@ -225,7 +237,6 @@ tuple<shared_ptr<RDM<3>>, shared_ptr<RDM<4>>> FCI::rdm34(const int ist, const in
         }
       }
     }
-    sort_indices<1,0,3,2,4,1,1,1,1>(tmp4_full->data(), rdm4->data(), norb_, norb_, norb_, norb_, norb2*norb2);
     if (npass > 1) {
       stringstream ss; ss << "RDM evaluation (" << setw(2) << ipass + 1 << "/" << setw(2) << npass << ")";
       timer.tick_print(ss.str());
@@ -246,156 +257,132 @@ tuple<shared_ptr<RDM<3>>, shared_ptr<RDM<4>>> FCI::rdm34(const int ist, const in
   }
 
   {
+    shared_ptr<const RDM<2>> rdm2 = rdm2_->at(ist, jst);
     for (int l = 0; l != norb_; ++l)
       for (int k = 0; k != norb_; ++k)
         for (int j = 0; j != norb_; ++j)
           for (int b = 0; b != norb_; ++b) {
-            blas::ax_plus_y_n(-1.0, rdm3->element_ptr(0,0,0,k,b,l), norb_*norb_*norb_, rdm4->element_ptr(0,0,0,j,j,k,b,l));
-            blas::ax_plus_y_n(-1.0, rdm3->element_ptr(0,0,0,l,b,k), norb_*norb_*norb_, rdm4->element_ptr(0,0,0,j,b,k,j,l));
+            for (int x2 = 0; x2 != norb_; ++x2)
+              for (int x1 = 0; x1 != norb_; ++x1)
+                for (int x0 = 0; x0 != norb_; ++x0) {
+                  rdm4->add(-rdm3->element(x0,x1,x2,k,b,l), x0,x1,x2,j,j,k,b,l);
+                  rdm4->add(-rdm3->element(x0,x1,x2,l,b,k), x0,x1,x2,j,b,k,j,l);
+                }
             for (int i = 0; i != norb_; ++i) {
-              blas::ax_plus_y_n(-1.0, rdm2_->at(ist, jst)->element_ptr(0,k,b,l), norb_, rdm4->element_ptr(0,i,b,j,i,k,j,l));
-              blas::ax_plus_y_n(-1.0, rdm2_->at(ist, jst)->element_ptr(0,l,b,k), norb_, rdm4->element_ptr(0,i,b,j,j,k,i,l));
-              for (int d = 0; d != norb_; ++d) {
-                blas::ax_plus_y_n(-1.0, rdm3->element_ptr(0,k,b,j,d,l), norb_, rdm4->element_ptr(0,i,b,j,i,k,d,l));
-                blas::ax_plus_y_n(-1.0, rdm3->element_ptr(0,l,b,j,d,k), norb_, rdm4->element_ptr(0,i,b,j,d,k,i,l));
+              for (int x = 0; x != norb_; ++x) {
+                rdm4->add(-rdm2->element(x,k,b,l), x,i,b,j,i,k,j,l);
+                rdm4->add(-rdm2->element(x,l,b,k), x,i,b,j,j,k,i,l);
               }
+              for (int d = 0; d != norb_; ++d)
+                for (int x = 0; x != norb_; ++x) {
+                  rdm4->add(-rdm3->element(x,k,b,j,d,l), x,i,b,j,i,k,d,l);
+                  rdm4->add(-rdm3->element(x,l,b,j,d,k), x,i,b,j,d,k,i,l);
+                }
             }
           }
   }
 
   cc_->set_det(det_);
 
-  return make_tuple(rdm3, rdm4);
+  return make_tuple(make_shared<PackedRDM<3>>(*rdm3), rdm4);
 }
 
 
-#if 0
-// computes 3 and 4RDM
-// TODO duplicate code to be cleaned up
-tuple<shared_ptr<RDM<3>>, shared_ptr<RDM<3>>> FCI::rdm34f(const int ist, const int jst, shared_ptr<const Matrix> fock) const {
+// computes 3RDM between two (arbitrary) CI vectors with multipassing
+shared_ptr<RDM<3>> FCI::rdm3_from_civec(shared_ptr<const Civec> cbra, shared_ptr<const Civec> cket, shared_ptr<const RDM<2>> rdm2) const {
   auto rdm3 = make_shared<RDM<3>>(norb_);
-  auto frdm4 = make_shared<RDM<3>>(norb_);
-
-  auto detex = make_shared<Determinants>(norb_, nelea_, neleb_, false, /*mute=*/true);
-  cc_->set_det(detex);
-
-  shared_ptr<Civec> cbra = cc_->data(ist);
-  shared_ptr<Civec> cket = cc_->data(jst);
 
-  // first make <I|E_ij|0>
   auto dbra = make_shared<Dvec>(cbra->det(), norb_*norb_);
   sigma_2a1(cbra, dbra);
   sigma_2a2(cbra, dbra);
 
-  shared_ptr<Dvec> dket = dbra;
-  if (cbra != cket) {
-    dket = dbra->clone();
-    sigma_2a1(cket, dket);
-    sigma_2a2(cket, dket);
-  }
+  auto dket = dbra->clone();
+  sigma_2a1(cket, dket);
+  sigma_2a2(cket, dket);
 
-  // second make <J|E_kl|I><I|E_ij|0> - delta_li <J|E_kj|0>
-  auto make_evec = [this](shared_ptr<Dvec> d, shared_ptr<Dvec> e, shared_ptr<Dvec> tmp) {
-    int ijkl = 0;
-    int ij = 0;
-    for (auto iter = d->dvec().begin(); iter != d->dvec().end(); ++iter, ++ij) {
-      const int j = ij/norb_;
-      const int i = ij-j*norb_;
-      tmp->zero();
-      sigma_2a1(*iter, tmp);
-      sigma_2a2(*iter, tmp);
-      int kl = 0;
-      for (auto t = tmp->dvec().begin(); t != tmp->dvec().end(); ++t, ++ijkl, ++kl) {
-        *e->data(ijkl) = **t;
-        const int l = kl/norb_;
-        const int k = kl-l*norb_;
-        if (l == i) *e->data(ijkl) -= *d->data(k+j*norb_);
-      }
-    }
-  };
-  auto ebra = make_shared<Dvec>(cbra->det(), norb_*norb_*norb_*norb_);
-  auto tmp = make_shared<Dvec>(cbra->det(), norb_*norb_);
-  make_evec(dbra, ebra, tmp);
+  const size_t ndet = cbra->det()->size();
+  const size_t norb2 = norb_ * norb_;
+  const size_t ijmax = 635040001 * 2;
+  const size_t ijnum = ndet * norb2 * norb2;
+  const size_t npass = (ijnum-1) / ijmax + 1;
+  const size_t nsize = (ndet-1) / npass + 1;
 
-  shared_ptr<Dvec> eket = ebra;
-  if (cbra != cket) {
-    eket = ebra->clone();
-    make_evec(dket, eket, tmp);
+  for (size_t ipass = 0; ipass != npass; ++ipass) {
+    const size_t ioffset = ipass * nsize;
+    const size_t isize = (ipass != (npass - 1)) ? nsize : ndet - ioffset;
+    auto eket_half = make_shared<Matrix>(isize, norb2 * (norb2 + 1) / 2);
+    rdm34_evec_half(dket, eket_half, isize, ioffset);
+
+    auto dbram = make_shared<Matrix>(isize, norb2);
+    for (size_t ij = 0; ij != norb2; ++ij)
+      copy_n(&(dbra->data(ij)->data(ioffset)), isize, dbram->element_ptr(0, ij));
+
+    // <0|E_mn|I><I|E_ij < kl|0>
+    auto tmp3 = make_shared<Matrix>(*dbram % *eket_half);
+    auto tmp3_full = make_shared<Matrix>(norb2, norb2 * norb2);
+    for (size_t mn = 0; mn != norb2; ++mn) {
+      int no = 0;
+      for (size_t ij = 0; ij != norb2; ++ij)
+        for (size_t kl = ij; kl != norb2; ++kl, ++no) {
+          tmp3_full->element(mn, ij + kl*norb2) = tmp3->element(mn, no);
+          tmp3_full->element(mn, kl + ij*norb2) = tmp3->element(mn, no);
+        }
+    }
+    sort_indices<1,0,2,1,1,1,1>(tmp3_full->data(), rdm3->data(), norb_, norb_, norb2*norb2);
   }
 
-  // size of the RI space
-  const size_t nri = ebra->lena() * ebra->lenb();
-  assert(nri == dbra->lena()*dbra->lenb());
+  // Eq. 49 of JCP 89 5803
+  for (int i0 = 0; i0 != norb_; ++i0)
+    for (int i1 = 0; i1 != norb_; ++i1)
+      for (int i2 = 0; i2 != norb_; ++i2)
+        for (int i3 = 0; i3 != norb_; ++i3) {
+          blas::ax_plus_y_n(-1.0, rdm2->element_ptr(0, i2, i1, i0), norb_, rdm3->element_ptr(0, i3, i3, i2, i1, i0));
+          blas::ax_plus_y_n(-1.0, rdm2->element_ptr(0, i0, i3, i2), norb_, rdm3->element_ptr(0, i1, i3, i2, i1, i0));
+        }
+  return rdm3;
+}
 
-  // first form <0|E_mn|I><I|E_ij,kl|0>
-  {
-    auto tmp3 = make_shared<RDM<3>>(norb_);
-    auto tmp3v = group(group(*tmp3,2,6),0,2);
-    contract(1.0, group(*dbra,0,2), {0,1}, group(*eket,0,2), {0,2}, 0.0, tmp3v, {1,2});
-    sort_indices<1,0,2,0,1,1,1>(tmp3->data(), rdm3->data(), norb_, norb_, norb_*norb_*norb_*norb_);
 
-    // then perform Eq. 49 of JCP 89 5803 (Werner's MRCI paper)
-    // we assume that rdm2_[ist] is set
-    for (int i0 = 0; i0 != norb_; ++i0)
-      for (int i1 = 0; i1 != norb_; ++i1)
-        for (int i2 = 0; i2 != norb_; ++i2)
-          for (int i3 = 0; i3 != norb_; ++i3) {
-            blas::ax_plus_y_n(-1.0, rdm2_->at(ist, jst)->element_ptr(0, i2, i1, i0), norb_, rdm3->element_ptr(0, i3, i3, i2, i1, i0));
-            blas::ax_plus_y_n(-1.0, rdm2_->at(ist, jst)->element_ptr(0, i0, i3, i2), norb_, rdm3->element_ptr(0, i1, i3, i2, i1, i0));
-          }
-  }
+// computes 3RDM and f_gh <0|E_ab,cd,ef,gh|0>. Using the particle-exchange symmetry of 4RDM,
+//   f_gh <0|E_gh,ab,cd,ef|0> = <F|E_ab,cd,ef|0> - f_ga <0|E_gb,cd,ef|0> - f_gc <0|E_ab,gd,ef|0> - f_ge <0|E_ab,cd,gf|0>
+// where <F| = f_gh <0|E_gh. Only 3RDM-sized intermediates are needed.
+tuple<shared_ptr<RDM<3>>, shared_ptr<RDM<3>>> FCI::rdm34f(const int ist, const int jst, shared_ptr<const Matrix> fock) const {
+  assert(fock->ndim() == norb_ && fock->mdim() == norb_);
+  auto detex = make_shared<Determinants>(norb_, nelea_, neleb_, false, /*mute=*/true);
+  cc_->set_det(detex);
+
+  shared_ptr<const Civec> cbra = cc_->data(ist);
+  shared_ptr<const Civec> cket = cc_->data(jst);
 
-  // 4RDM <0|E_ij,kl|I><I|E_mn,op|0>
-  // now make target:  [0|E_ik,jl,op|0]  =  <0|E_ik,jl|K>[K|E_op|0] - f_nk(<0|E_in,jl,op|0>+d_ol<0|E_in,jp|0>)
-  //                                                                - f_nl(<0|E_ik,jn,op|0>+d_ok<0|E_ip,jn|0>)
-  //                                                                - d_ok [0|E_ip,jl|0]  - d_ol [0|E_ik,jp|0]
+  // we assume that rdm2_[ist, jst] is set
+  shared_ptr<RDM<3>> rdm3 = rdm3_from_civec(cbra, cket, rdm2_->at(ist, jst));
+
+  // |F> = f_gh E_hg|0>; data(m+norb*n) of the Dvec is contracted as <0|E_nm
+  auto fbra = make_shared<Civec>(cbra->det());
   {
-    auto rdm2 = make_shared<RDM<2>>(norb_);
-    dgemv_("T", nri, eket->ij(), 1.0, eket->data(), nri, cbra->data(), 1, 0.0, rdm2->data(), 1);
-
-    // [0|E_ip,jl|0]
-    auto frdm3 = make_shared<RDM<2>>(norb_);
-    auto rdm3view = group(group(*rdm3, 4,6), 0,4);
-    auto frdm3view = group(*frdm3, 0,4);
-    contract(1.0, rdm3view, {0,1}, group(*fock, 0,2), {1}, 0.0, frdm3view, {0});
-
-    // <0|E_ip,jn|0>f_nl (in this order)
-    auto prdm2 = make_shared<RDM<2>>(norb_);
-    auto prdm2v = group(*prdm2, 0,3);
-    contract(1.0, group(*rdm2, 0,3), {0,1}, *fock, {1,2}, 0.0, prdm2v, {0,2});
-
-    // <0|E_ik,jl,on|0>f_np (in this order)
-    auto prdm3 = make_shared<RDM<3>>(norb_);
-    auto prdm3v = group(*prdm3, 0,5);
-    contract(1.0, group(*rdm3, 0,5), {0,1}, *fock, {1,2}, 0.0, prdm3v, {0,2});
-
-    // <0|E_ik,jl|K>[K|E_op|0]
-    auto tmp = make_shared<RDM<3>>(norb_);
-    auto tmpv = group(group(*tmp, 4,6), 0,4);
-    auto feket = dket->clone();
-    dgemv_("N", nri*norb_*norb_, norb_*norb_, 1.0, eket->data(), nri*norb_*norb_, fock->data(), 1, 0.0, feket->data(), 1);
-    contract(1.0, group(*ebra, 0,2), {0,1}, group(*feket, 0,2), {0,2}, 0.0, tmpv, {1,2});
-    sort_indices<1,0,3,2,4,0,1,1,1>(tmp->data(), frdm4->data(), norb_, norb_, norb_, norb_, norb_*norb_);
-
-    sort_indices<2,0,1,1,1,-1,1>(prdm3->data(), frdm4->data(), norb_*norb_, norb_*norb_, norb_*norb_);
-    sort_indices<0,2,1,1,1,-1,1>(prdm3->data(), frdm4->data(), norb_*norb_, norb_*norb_, norb_*norb_);
-
-    auto prdm2t = prdm2->clone();
-    sort_indices<1,0,0,1,1,1>(prdm2->data(), prdm2t->data(), norb_*norb_, norb_*norb_);
-    for (int p = 0; p != norb_; ++p)
-      for (int l = 0; l != norb_; ++l) {
-        blas::ax_plus_y_n(-1.0, prdm2t->element_ptr(0,0,0,p), norb_*norb_*norb_, frdm4->element_ptr(0,0,0,l,l,p));
-        blas::ax_plus_y_n(-1.0, frdm3->element_ptr(0,0,0,p),  norb_*norb_*norb_, frdm4->element_ptr(0,0,0,l,l,p));
-        for (int k = 0; k != norb_; ++k)
-          for (int j = 0; j != norb_; ++j) {
-            blas::ax_plus_y_n(-1.0, prdm2->element_ptr(0,p,j,l), norb_, frdm4->element_ptr(0,k,j,l,k,p));
-            blas::ax_plus_y_n(-1.0, frdm3->element_ptr(0,p,j,l), norb_, frdm4->element_ptr(0,k,j,l,k,p));
-          }
-      }
+    auto dbra = make_shared<Dvec>(cbra->det(), norb_*norb_);
+    sigma_2a1(cbra, dbra);
+    sigma_2a2(cbra, dbra);
+    for (int n = 0; n != norb_; ++n)
+      for (int m = 0; m != norb_; ++m)
+        fbra->ax_plus_y(fock->element(n, m), *dbra->data(m+norb_*n));
   }
+  shared_ptr<RDM<2>> frdm2 = get<1>(compute_rdm12_from_civec(fbra, cket));
+  shared_ptr<RDM<3>> frdm4 = rdm3_from_civec(fbra, cket, frdm2);
+
+  // f_ga <0|E_gb,cd,ef|0> and its permutations
+  const size_t norb5 = norb_*norb_*norb_*norb_*norb_;
+  dgemm_("T", "N", norb_, norb5, norb_, -1.0, fock->data(), norb_, rdm3->data(), norb_, 1.0, frdm4->data(), norb_);
+  auto tmp = rdm3->clone();
+  sort_indices<2,1,0,3,4,5,0,1,1,1>(rdm3->data(), tmp->data(), norb_, norb_, norb_, norb_, norb_, norb_);
+  auto tmp2 = rdm3->clone();
+  dgemm_("T", "N", norb_, norb5, norb_, -1.0, fock->data(), norb_, tmp->data(), norb_, 0.0, tmp2->data(), norb_);
+  sort_indices<2,1,0,3,4,5,1,1,1,1>(tmp2->data(), frdm4->data(), norb_, norb_, norb_, norb_, norb_, norb_);
+  sort_indices<4,1,2,3,0,5,0,1,1,1>(rdm3->data(), tmp->data(), norb_, norb_, norb_, norb_, norb_, norb_);
+  dgemm_("T", "N", norb_, norb5, norb_, -1.0, fock->data(), norb_, tmp->data(), norb_, 0.0, tmp2->data(), norb_);
+  sort_indices<4,1,2,3,0,5,1,1,1,1>(tmp2->data(), frdm4->data(), norb_, norb_, norb_, norb_, norb_, norb_);
 
   cc_->set_det(det_);
 
   return make_tuple(rdm3, frdm4);
 }
-#endif
@@ -79,6 +79,7 @@ class HarrisonZarrabian : public FCI {
     }
 
     virtual void update(std::shared_ptr<const Matrix>) override;
+    std::shared_ptr<FCI> copy() const override { return std::make_shared<HarrisonZarrabian>(*this); }
 };
 
 }
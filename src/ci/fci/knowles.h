@@ -79,6 +79,7 @@ class KnowlesHandy : public FCI {
     }
 
     void update(std::shared_ptr<const Matrix>) override;
+    std::shared_ptr<FCI> copy() const override { return std::make_shared<KnowlesHandy>(*this); }
 };
 
 }
@@ -0,0 +1,204 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: distzharrison.cc
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <src/ci/zfci/distzharrison.h>
+#include <src/util/math/davidson.h>
+
+using namespace std;
+using namespace bagel;
+
+DistZHarrison::DistZHarrison(shared_ptr<const PTree> idat, shared_ptr<const Geometry> g, shared_ptr<const Reference> r, const int ncore, const int norb,
+                             shared_ptr<const RelCoeff_Block> coeff_zcas, const bool store)
+ : ZHarrison(idat, g, r, ncore, norb, coeff_zcas, store) {
+#ifndef HAVE_MPI_H
+  throw logic_error("DistZHarrison can be used only with MPI");
+#endif
+  if (restart_)
+    throw runtime_error("Restart is not implemented in the distributed relativistic FCI");
+  cout << "    * Parallel algorithm will be used." << endl << endl;
+}
+
+
+// same as ZHarrison::generate_guess except that the elements are set on the processes that own them
+void DistZHarrison::generate_guess(const int nelea, const int neleb, const int nstate, vector<shared_ptr<RelZDistCivec>>& out, const int offset) {
+  int ndet = nstate*10;
+  int oindex = offset;
+  const bool spin_adapt = idata_->get<bool>("spin_adapt", true);
+  shared_ptr<const Determinants> cdet = space_->finddet(nelea, neleb);
+  while (oindex < offset+nstate) {
+    vector<pair<bitset<nbit__>, bitset<nbit__>>> bits = detseeds(ndet, nelea, neleb);
+
+    // Spin adapt detseeds
+    oindex = offset;
+    vector<pair<bitset<nbit__>,bitset<nbit__>>> done;
+    for (auto& it : bits) {
+      bitset<nbit__> alpha = it.second;
+      bitset<nbit__> beta = it.first;
+      bitset<nbit__> open_bit = (alpha^beta);
+
+      // This can happen if all possible determinants are checked without finding nstate acceptable ones.
+      if (alpha.count() + beta.count() != nele_)
+        throw logic_error("DistZHarrison::generate_guess produced an invalid determinant.  Check the number of states being requested.");
+
+      pair<bitset<nbit__>,bitset<nbit__>> config = spin_adapt ? make_pair(open_bit, alpha & beta) : it;
+      if (find(done.begin(), done.end(), config) != done.end()) continue;
+      done.push_back(config);
+
+      // make sure that we have enough unpaired alpha
+      const int unpairalpha = (alpha ^ (alpha & beta)).count();
+      const int unpairbeta  = (beta ^ (alpha & beta)).count();
+      if (unpairalpha-unpairbeta < nelea-neleb) continue;
+
+      pair<vector<tuple<int, int, int>>, double> adapt;
+      if (spin_adapt) {
+        adapt = cdet->spin_adapt(nelea-neleb, alpha, beta);
+      } else {
+        adapt.first = vector<tuple<int, int, int>>(1, make_tuple(cdet->lexical<1>(beta), cdet->lexical<0>(alpha), 1));
+        adapt.second = 1.0;
+      }
+
+      shared_ptr<ZDistCivec> target = out[oindex]->find(nelea, neleb);
+      const double fac = adapt.second;
+      for (auto& iter : adapt.first) {
+        const int aloc = get<1>(iter) - target->astart();
+        if (aloc >= 0 && aloc < target->asize())
+          target->set_local(aloc, get<0>(iter), get<2>(iter)*fac);
+      }
+      cout << "     guess " << setw(3) << oindex << ":   closed " <<
+            setw(20) << left << print_bit(alpha&beta, norb_) << " open " << setw(20) << print_bit(open_bit, norb_) << right << endl;
+
+      ++oindex;
+      if (oindex == offset+nstate) break;
+    }
+
+    if (oindex < offset+nstate) {
+      for (int i = offset; i != oindex; ++i)
+        out[i]->find(nelea, neleb)->zero();
+      ndet *= 4;
+    }
+  }
+  cout << endl;
+}
+
+
+void DistZHarrison::compute() {
+  Timer pdebug(2);
+
+  if (geom_->nirrep() > 1) throw runtime_error("ZFCI: C1 only at the moment.");
+
+  // Creating an initial CI vector
+  vector<shared_ptr<RelZDistCivec>> cc(nstate_);
+  for (auto& i : cc)
+    i = make_shared<RelZDistCivec>(space_);
+
+  // find determinants that have small diagonal energies
+  int offset = 0;
+  for (auto& i : guess_sectors()) {
+    generate_guess(get<0>(i), get<1>(i), get<2>(i), cc, offset);
+    offset += get<2>(i);
+  }
+  pdebug.tick_print("guess generation");
+
+  // nuclear energy retrieved from geometry
+  const double nuc_core = geom_->nuclear_repulsion() + jop_->core_energy();
+
+  // Davidson utility
+  DavidsonDiag<RelZDistCivec, ZMatrix> davidson(nstate_, davidson_subspace_);
+
+  // main iteration starts here
+  cout << "  === Relativistic FCI iteration ===" << endl << endl;
+  // 0 means not converged
+  vector<int> conv(nstate_,0);
+
+  for (int iter = 0; iter != max_iter_; ++iter) {
+    Timer fcitime;
+
+    // form a sigma vector given cc
+    vector<shared_ptr<RelZDistCivec>> sigma = form_sigma(cc, jop_, conv);
+    pdebug.tick_print("sigma vector");
+
+    vector<shared_ptr<const RelZDistCivec>> ccn, sigman;
+    for (int i = 0; i != nstate_; ++i) {
+      ccn.push_back(conv[i] ? nullptr : cc[i]);
+      sigman.push_back(conv[i] ? nullptr : sigma[i]);
+    }
+    const vector<double> energies = davidson.compute(ccn, sigman);
+    // get residual and new vectors
+    vector<shared_ptr<RelZDistCivec>> errvec = davidson.residual();
+    pdebug.tick_print("davidson");
+
+    // compute errors
+    vector<double> errors;
+    for (int i = 0; i != nstate_; ++i) {
+      errors.push_back(errvec[i]->rms());
+      conv[i] = static_cast<int>(errors[i] < thresh_);
+    }
+    pdebug.tick_print("error");
+
+    if (!*min_element(conv.begin(), conv.end())) {
+      // denominator scaling (local data only)
+      for (int ist = 0; ist != nstate_; ++ist) {
+        if (conv[ist]) continue;
+        auto ctmp = errvec[ist]->clone();
+        for (auto& ib : space_->detmap()) {
+          const int na = ib.second->nelea();
+          const int nb = ib.second->neleb();
+          shared_ptr<const ZDistCivec> source = errvec[ist]->find(na, nb);
+          const size_t size = source->size();
+          const complex<double>* source_array = source->local_data();
+          const double* denom_array = denom_->find(na, nb)->data() + source->astart()*source->lenb();
+          const double en = energies[ist];
+          unique_ptr<complex<double>[]> target_array(new complex<double>[size]);
+          for (size_t i = 0; i != size; ++i)
+            target_array[i] = source_array[i] / min(en - denom_array[i], -0.1);
+          ctmp->find(na, nb)->accumulate_buffer(1.0, target_array);
+        }
+        ctmp->normalize();
+        cc[ist] = ctmp;
+      }
+    }
+    pdebug.tick_print("denominator");
+
+    // printing out
+    if (nstate_ != 1 && iter) cout << endl;
+    for (int i = 0; i != nstate_; ++i) {
+      cout << setw(7) << iter << setw(4) << i << " " << setw(2) << (conv[i] ? "*" : " ")
+                              << setw(17) << fixed << setprecision(8) << energies[i]+nuc_core << "   "
+                              << setw(10) << scientific << setprecision(2) << errors[i] << fixed << setw(10) << setprecision(2)
+                              << fcitime.tick() << endl;
+      energy_[i] = energies[i]+nuc_core;
+    }
+    if (*min_element(conv.begin(), conv.end())) break;
+  }
+  // main iteration ends here
+
+  // the converged vectors are collected on every process
+  vector<shared_ptr<RelZDvec>> cv;
+  for (auto& i : davidson.civec())
+    cv.push_back(i->reldvec());
+  cc_ = make_shared<RelZDvec>(cv);
+  cc_->print(print_thresh_);
+
+  analyze_aniso();
+}
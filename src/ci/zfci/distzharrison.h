@@ -0,0 +1,60 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: distzharrison.h
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __SRC_ZFCI_DISTZHARRISON_H
+#define __SRC_ZFCI_DISTZHARRISON_H
+
+#include <src/ci/zfci/zharrison.h>
+#include <src/ci/zfci/reldistcivec.h>
+
+namespace bagel {
+
+// Distributed-memory relativistic FCI, which is to ZHarrison what DistFCI is to HarrisonZarrabian.
+// The CI vectors of all the Kramers sectors (and thus the Davidson subspace) are distributed by alpha strings
+// using RMA windows. The alpha-alpha and beta-beta parts of the sigma vector are computed locally (the former
+// after transposition); the other couplings are computed for each intermediate alpha string by threads, while
+// the CI rows for the next batch of strings are being fetched and the sigma rows are being accumulated.
+// The converged vectors are collected into cc_ so that the RDM and CASSCF functions of ZHarrison can be used.
+class DistZHarrison : public ZHarrison {
+  protected:
+    void generate_guess(const int nelea, const int neleb, const int nstate, std::vector<std::shared_ptr<RelZDistCivec>>& out, const int offset);
+
+    // beta-beta contributions with local data only; trans indicates that cc is transposed
+    void sigma_bb(std::shared_ptr<const ZDistCivec> cc, std::shared_ptr<ZDistCivec> sigma, std::shared_ptr<const RelMOFile> jop, const bool trans) const;
+    void sigma_one(std::shared_ptr<const ZDistCivec> cc, std::shared_ptr<RelZDistCivec> sigmavec, std::shared_ptr<const RelMOFile> jop,
+                   const bool diag, const bool trans) const;
+
+  public:
+    DistZHarrison(std::shared_ptr<const PTree> a, std::shared_ptr<const Geometry> g, std::shared_ptr<const Reference> b,
+                  const int ncore = -1, const int nocc = -1, std::shared_ptr<const RelCoeff_Block> coeff_zcas = nullptr, const bool store = false);
+
+    std::vector<std::shared_ptr<RelZDistCivec>> form_sigma(const std::vector<std::shared_ptr<RelZDistCivec>>& cc, std::shared_ptr<const RelMOFile> jop,
+                                                           const std::vector<int>& conv) const;
+
+    void compute() override;
+};
+
+}
+
+#endif
@@ -0,0 +1,245 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: distzharrison_sigma.cc
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <src/ci/zfci/distzharrison.h>
+#include <src/ci/zfci/distzharrison_task.h>
+#include <src/util/taskqueue.h>
+#include <src/util/prim_op.h>
+
+using namespace std;
+using namespace bagel;
+
+namespace {
+
+// Tasks are processed in batches. The CI rows for the next batch are requested before the current batch is
+// computed by threads, and the sigma rows are sent while the following batches are being processed.
+template<typename TaskType, typename Factory>
+void compute_distributed(const vector<bitset<nbit__>>& strings, Factory factory) {
+  const size_t nbatch = max(static_cast<size_t>(1), 4*resources__->max_num_threads());
+
+  auto make_batch = [&](const size_t start) {
+    vector<shared_ptr<TaskType>> out;
+    for (size_t i = start; i < min(start+nbatch, strings.size()); ++i)
+      out.push_back(factory(strings[i]));
+    return out;
+  };
+
+  list<shared_ptr<RMATask<complex<double>>>> acctasks;
+  vector<shared_ptr<TaskType>> current = make_batch(0);
+  for (size_t start = 0; start < strings.size(); start += nbatch) {
+    vector<shared_ptr<TaskType>> next = make_batch(start+nbatch);
+
+    TaskQueue<shared_ptr<TaskType>> tasks(current.size());
+    for (auto& i : current) {
+      i->wait();
+      tasks.emplace_back(i);
+    }
+    tasks.compute();
+
+    for (auto& i : current)
+      acctasks.splice(acctasks.end(), i->accumulate());
+    acctasks.remove_if([](shared_ptr<RMATask<complex<double>>> i) { return i->test(); });
+
+    current = move(next);
+  }
+  for (auto& i : acctasks)
+    i->wait();
+}
+
+}
+
+
+vector<shared_ptr<RelZDistCivec>> DistZHarrison::form_sigma(const vector<shared_ptr<RelZDistCivec>>& ccvec, shared_ptr<const RelMOFile> jop,
+                                                             const vector<int>& conv) const {
+  vector<shared_ptr<RelZDistCivec>> sigmavec(nstate_);
+
+  for (int istate = 0; istate != nstate_; ++istate) {
+    if (conv[istate]) continue;
+    sigmavec[istate] = make_shared<RelZDistCivec>(space_);
+    auto sigmavec_trans = sigmavec[istate]->clone(); // important note: the space stays the same after transposition
+
+    for (auto& isp : space_->detmap()) {
+      const int nelea = isp.second->nelea();
+      const int neleb = isp.second->neleb();
+
+      shared_ptr<const ZDistCivec> cc = ccvec[istate]->find(nelea, neleb);
+      sigma_one(cc, sigmavec[istate], jop, /*diag*/true, /*transpose*/false);
+
+      shared_ptr<const ZDistCivec> cc_trans = cc->transpose();
+      sigma_one(cc_trans, sigmavec_trans, jop, /*diag*/false, /*transpose*/true);
+    }
+
+    for (auto& isp : space_->detmap()) {
+      const int nelea = isp.second->nelea();
+      const int neleb = isp.second->neleb();
+      sigmavec[istate]->find(nelea, neleb)->ax_plus_y(1.0, *sigmavec_trans->find(neleb, nelea)->transpose());
+    }
+  }
+
+  return sigmavec;
+}
+
+
+void DistZHarrison::sigma_one(shared_ptr<const ZDistCivec> cc, shared_ptr<RelZDistCivec> sigmavec, shared_ptr<const RelMOFile> jop,
+                              const bool diag, const bool trans) const {
+  Timer pdebug(2);
+
+  const int nelea = cc->det()->nelea();
+  const int neleb = cc->det()->neleb();
+  shared_ptr<const Determinants> base_det = space_->finddet(nelea, neleb);
+  shared_ptr<ZDistCivec> sigma = sigmavec->find(nelea, neleb);
+
+  sigma_bb(cc, sigma, jop, trans);
+  pdebug.tick_print("taskbb");
+
+  const bool noab = (nelea == 0 || neleb == 0);
+  const bool noaa =  nelea <= 1 || neleb+1 > norb_;
+
+  const bool output1 = nelea-1 >= 0 && neleb+1 <= norb_;
+
+  // intermediate alpha strings are distributed in a round-robin fashion
+  auto my_strings = [](const vector<bitset<nbit__>>& all) {
+    vector<bitset<nbit__>> out;
+    for (size_t i = mpi__->rank(); i < all.size(); i += mpi__->size())
+      out.push_back(all[i]);
+    return out;
+  };
+
+  if (nelea >= 1 && ((!noab && diag) || output1)) {
+    shared_ptr<const Determinants> int_det = !noab ? int_space_->finddet(nelea-1, neleb-1) : nullptr;
+    shared_ptr<const Determinants> out_det = output1 ? space_->finddet(nelea-1, neleb+1) : nullptr;
+    shared_ptr<ZDistCivec> sigma_1 = output1 ? sigmavec->find(nelea-1, neleb+1) : nullptr;
+
+    // (a^+ b^+ b a) and (a^+ b^+ a b) contributions
+    shared_ptr<ZMatrix> hab;
+    if (!noab && diag) {
+      hab = make_shared<ZMatrix>(*jop->mo2e("0101"));
+      sort_indices<1,0,2,3,1,1,-1,1>(jop->mo2e("1001")->data(), hab->data(), norb_, norb_, norb_, norb_);
+    }
+
+    // (b^+b^+ b a) and (b^+ a) contributions
+    shared_ptr<const ZMatrix> hbb, h1;
+    if (output1) {
+      bitset<4> bit4("1101");
+      bitset<2> bit2("10");
+      hbb = jop->mo2e(trans ? ~bit4 : bit4);
+      h1 = jop->mo1e(trans ? ~bit2 : bit2);
+    }
+
+    compute_distributed<DistZTask1>(my_strings((int_det ? int_det : out_det)->string_bits_a()),
+      [&](const bitset<nbit__>& a) { return make_shared<DistZTask1>(a, base_det, int_det, out_det, hab, hbb, h1, cc, sigma, sigma_1); });
+    pdebug.tick_print("task1");
+  }
+
+  if (!noaa) {
+    shared_ptr<const Determinants> int_det = int_space_->finddet(nelea-2, neleb);
+    shared_ptr<const Determinants> out1_det = space_->finddet(nelea-1, neleb+1);
+    shared_ptr<const Determinants> out2_det = neleb+2 <= norb_ ? space_->finddet(nelea-2, neleb+2) : nullptr;
+    shared_ptr<ZDistCivec> sigma_1 = sigmavec->find(nelea-1, neleb+1);
+    shared_ptr<ZDistCivec> sigma_2 = out2_det ? sigmavec->find(nelea-2, neleb+2) : nullptr;
+
+    // (a^+ b^+ a a) and (b^+ b^+ a a) contributions
+    bitset<4> bit4ab("0100");
+    bitset<4> bit4bb("1100");
+    shared_ptr<const ZMatrix> hab = jop->mo2e(trans ? ~bit4ab : bit4ab);
+    shared_ptr<const ZMatrix> hbb = out2_det ? jop->mo2e(trans ? ~bit4bb : bit4bb) : nullptr;
+
+    compute_distributed<DistZTask2>(my_strings(int_det->string_bits_a()),
+      [&](const bitset<nbit__>& a) { return make_shared<DistZTask2>(a, base_det, int_det, out1_det, out2_det, hab, hbb, cc, sigma_1, sigma_2); });
+    pdebug.tick_print("task2");
+  }
+}
+
+
+void DistZHarrison::sigma_bb(shared_ptr<const ZDistCivec> cc, shared_ptr<ZDistCivec> sigma, shared_ptr<const RelMOFile> jop, const bool trans) const {
+  shared_ptr<const Determinants> det = space_->finddet(cc->det()->nelea(), cc->det()->neleb());
+  const size_t la = cc->asize();
+  const size_t lb = cc->lenb();
+
+  bitset<2> bit2("11");
+  bitset<4> bit4("1111");
+  if (trans) { bit2 = ~bit2; bit4 = ~bit4; }
+
+  shared_ptr<const ZMatrix> h1 = jop->mo1e(bit2);
+  auto h2 = make_shared<ZMatrix>(*jop->mo2e(bit4));
+  sort_indices<1,0,2,3,1,1,-1,1>(jop->mo2e(bit4)->data(), h2->data(), norb_, norb_, norb_, norb_);
+
+  // local data with beta strings as the slower index
+  const complex<double>* cdata = cc->local_data();
+  unique_ptr<complex<double>[]> source(new complex<double>[la*lb]);
+  unique_ptr<complex<double>[]> target(new complex<double>[la*lb]);
+  fill_n(target.get(), la*lb, 0.0);
+  if (la)
+    blas::transpose(cdata, lb, la, source.get());
+
+  // same as HZTaskAA, but for the beta strings
+  const int norb = norb_;
+  TaskQueue<function<void(void)>> tq(lb);
+  size_t bindex = 0;
+  for (auto& b : det->string_bits_b()) {
+    complex<double>* out = target.get() + la*bindex++;
+    const complex<double>* in = source.get();
+    tq.emplace_back(
+      [&det, &h1, &h2, b, out, in, la, norb] () {
+        for (int i = 0; i < norb; ++i) {
+          if (!b[i]) continue;
+          bitset<nbit__> ibs = b; ibs.reset(i);
+          for (int j = 0; j < norb; ++j) {
+            if (ibs[j]) continue;
+            bitset<nbit__> sourcestring = ibs; sourcestring.set(j);
+            const complex<double> hc = h1->element(i, j) * static_cast<double>(Determinants::sign(sourcestring, i, j));
+            blas::ax_plus_y_n(hc, in+la*det->lexical<1>(sourcestring), la, out);
+          }
+        }
+
+        for (int i = 0; i != norb; ++i) {
+          if (!b[i]) continue;
+          for (int j = 0; j < i; ++j) {
+            if (!b[j]) continue;
+            const int ij_phase = Determinants::sign(b, i, j);
+            bitset<nbit__> string_ij = b;
+            string_ij.reset(i); string_ij.reset(j);
+            for (int l = 0; l != norb; ++l) {
+              if (string_ij[l]) continue;
+              for (int k = 0; k < l; ++k) {
+                if (string_ij[k]) continue;
+                const int kl_phase = Determinants::sign(string_ij, l, k);
+                const double phase = -static_cast<double>(ij_phase*kl_phase);
+                bitset<nbit__> string_ijkl = string_ij;
+                string_ijkl.set(k); string_ijkl.set(l);
+                const complex<double> temp = phase * h2->data()[i+norb*(j+norb*(k+norb*l))];
+                blas::ax_plus_y_n(temp, in+la*det->lexical<1>(string_ijkl), la, out);
+              }
+            }
+          }
+        }
+      }
+    );
+  }
+  tq.compute();
+
+  if (la)
+    blas::transpose(target.get(), la, lb, source.get());
+  sigma->accumulate_buffer(1.0, source);
+}
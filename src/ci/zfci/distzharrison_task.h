@@ -0,0 +1,308 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: distzharrison_task.h
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __SRC_ZFCI_DISTZHARRISON_TASK_H
+#define __SRC_ZFCI_DISTZHARRISON_TASK_H
+
+#include <bitset>
+#include <memory>
+#include <src/util/f77.h>
+#include <src/util/math/zmatrix.h>
+#include <src/ci/fci/distcivec.h>
+
+namespace bagel {
+
+// Tasks for the distributed relativistic FCI. Each of them takes one intermediate alpha string, from which
+// one or two alpha electrons have been annihilated. The rows of the CI vector that are needed are requested
+// in the constructor (non-blocking), compute() works only on the local buffers (and can be run by threads),
+// and accumulate() sends the resulting rows of the sigma vectors (non-blocking).
+class DistZTask_base {
+  protected:
+    const std::bitset<nbit__> astring_;
+    std::shared_ptr<const Determinants> base_det_;
+    // orbitals that are not occupied in astring_
+    std::vector<int> unocc_;
+
+    std::unique_ptr<std::complex<double>[]> buf_;
+    std::vector<std::shared_ptr<RMATask<std::complex<double>>>> requests_;
+
+    // output rows (target vector, alpha string index, data)
+    std::vector<std::tuple<std::shared_ptr<ZDistCivec>, size_t, std::unique_ptr<std::complex<double>[]>>> out_;
+
+    // rows of e_ij(b) = E(b, i+norb*j) are mapped onto sigma by b+_i b+_j
+    void create_bb(std::shared_ptr<const Determinants> int_det, std::shared_ptr<const Determinants> target_det,
+                   const std::complex<double>* e, std::complex<double>* target) const {
+      const int norb = base_det_->norb();
+      const size_t lbs = int_det->lenb();
+      size_t bindex = 0;
+      for (auto& b : target_det->string_bits_b()) {
+        for (int i = 0; i < norb; ++i) {
+          if (!b[i]) continue;
+          for (int j = 0; j < i; ++j) {
+            if (!b[j]) continue;
+            std::bitset<nbit__> cb = b;
+            cb.reset(i); cb.reset(j);
+            const double sign = Determinants::sign(b, i, j);
+            const size_t bdlex = int_det->lexical<1>(cb);
+            target[bindex] += sign * (e[bdlex+lbs*(j+norb*i)] - e[bdlex+lbs*(i+norb*j)]);
+          }
+        }
+        ++bindex;
+      }
+    }
+
+  public:
+    DistZTask_base(const std::bitset<nbit__> astring, std::shared_ptr<const Determinants> base_det) : astring_(astring), base_det_(base_det) {
+      for (int i = 0; i != base_det->norb(); ++i)
+        if (!astring[i])
+          unocc_.push_back(i);
+    }
+
+    void wait() {
+      for (auto& i : requests_)
+        i->wait();
+    }
+
+    std::list<std::shared_ptr<RMATask<std::complex<double>>>> accumulate() {
+      std::list<std::shared_ptr<RMATask<std::complex<double>>>> out;
+      for (auto& i : out_)
+        out.push_back(std::get<0>(i)->rma_radd(std::move(std::get<2>(i)), std::get<1>(i)));
+      out_.clear();
+      return out;
+    }
+};
+
+
+// One alpha electron is annihilated from the CI vector in sector (na, nb). Contributions to
+//   (na, nb)     from a+_i b+_j b_l a_k (only when diag is set)
+//   (na-1, nb+1) from b+_i b+_j b_l a_k and b+_j a_i
+class DistZTask1 : public DistZTask_base {
+  protected:
+    // (na-1, nb-1), or nullptr if there is no beta electron
+    std::shared_ptr<const Determinants> int_det_;
+    // (na-1, nb+1), or nullptr if the sector does not exist
+    std::shared_ptr<const Determinants> out_det_;
+
+    std::shared_ptr<const ZMatrix> hab_;
+    std::shared_ptr<const ZMatrix> hbb_;
+    std::shared_ptr<const ZMatrix> h1_;
+
+    std::shared_ptr<ZDistCivec> sigma_;
+    std::shared_ptr<ZDistCivec> sigma1_;
+
+  public:
+    DistZTask1(const std::bitset<nbit__> astring, std::shared_ptr<const Determinants> base_det, std::shared_ptr<const Determinants> int_det,
+               std::shared_ptr<const Determinants> out_det, std::shared_ptr<const ZMatrix> hab, std::shared_ptr<const ZMatrix> hbb,
+               std::shared_ptr<const ZMatrix> h1, std::shared_ptr<const ZDistCivec> cc, std::shared_ptr<ZDistCivec> sigma, std::shared_ptr<ZDistCivec> sigma1)
+     : DistZTask_base(astring, base_det), int_det_(int_det), out_det_(out_det), hab_(hab), hbb_(hbb), h1_(h1), sigma_(sigma), sigma1_(sigma1) {
+      const size_t lbs = base_det->lenb();
+      buf_ = std::unique_ptr<std::complex<double>[]>(new std::complex<double>[lbs*unocc_.size()]);
+      for (int k = 0; k != unocc_.size(); ++k) {
+        std::bitset<nbit__> tmp = astring; tmp.set(unocc_[k]);
+        requests_.push_back(cc->rma_rget(buf_.get()+lbs*k, base_det->lexical<0>(tmp)));
+      }
+    }
+
+    void compute() {
+      const int norb = base_det_->norb();
+      const int nk = unocc_.size();
+      const size_t lbs = base_det_->lenb();
+
+      std::vector<double> asign(nk);
+      for (int k = 0; k != nk; ++k)
+        asign[k] = Determinants::sign(astring_, -1, unocc_[k]);
+
+      std::unique_ptr<std::complex<double>[]> out1;
+      if (out_det_) {
+        out1 = std::unique_ptr<std::complex<double>[]>(new std::complex<double>[out_det_->lenb()]);
+        std::fill_n(out1.get(), out_det_->lenb(), 0.0);
+      }
+
+      if (int_det_) {
+        const size_t lbt = int_det_->lenb();
+        const int nn = nk*norb;
+        // d(b, k+nk*l) = b_l a_k |C>, where k runs over the unoccupied orbitals
+        std::unique_ptr<std::complex<double>[]> d(new std::complex<double>[lbt*nn]);
+        std::fill_n(d.get(), lbt*nn, 0.0);
+        for (int l = 0; l != norb; ++l)
+          for (int k = 0; k != nk; ++k)
+            for (auto& b : int_det_->phiupb(l))
+              d[b.source+lbt*(k+nk*l)] += (asign[k] * b.sign) * buf_[b.target+lbs*k];
+
+        if (hab_) {
+          std::unique_ptr<std::complex<double>[]> h(new std::complex<double>[nn*nn]);
+          for (int l = 0; l != norb; ++l)
+            for (int k = 0; k != nk; ++k)
+              for (int j = 0; j != norb; ++j)
+                for (int i = 0; i != nk; ++i)
+                  h[i+nk*j+nn*(k+nk*l)] = hab_->element(unocc_[i]+norb*j, unocc_[k]+norb*l);
+          std::unique_ptr<std::complex<double>[]> e(new std::complex<double>[lbt*nn]);
+          zgemm3m_("N", "T", lbt, nn, nn, 1.0, d.get(), lbt, h.get(), nn, 0.0, e.get(), lbt);
+
+          // a+_i b+_j
+          for (int i = 0; i != nk; ++i) {
+            std::unique_ptr<std::complex<double>[]> row(new std::complex<double>[lbs]);
+            std::fill_n(row.get(), lbs, 0.0);
+            for (int j = 0; j != norb; ++j)
+              for (auto& b : int_det_->phiupb(j))
+                row[b.target] += (asign[i] * b.sign) * e[b.source+lbt*(i+nk*j)];
+            std::bitset<nbit__> atarget = astring_; atarget.set(unocc_[i]);
+            out_.emplace_back(sigma_, base_det_->lexical<0>(atarget), std::move(row));
+          }
+        }
+
+        if (out_det_) {
+          const int n2 = norb*norb;
+          std::unique_ptr<std::complex<double>[]> h(new std::complex<double>[n2*nn]);
+          for (int l = 0; l != norb; ++l)
+            for (int k = 0; k != nk; ++k)
+              for (int ij = 0; ij != n2; ++ij)
+                h[ij+n2*(k+nk*l)] = hbb_->element(ij, unocc_[k]+norb*l);
+          std::unique_ptr<std::complex<double>[]> e(new std::complex<double>[lbt*n2]);
+          zgemm3m_("N", "T", lbt, n2, nn, 1.0, d.get(), lbt, h.get(), n2, 0.0, e.get(), lbt);
+          create_bb(int_det_, out_det_, e.get(), out1.get());
+        }
+      }
+
+      if (out_det_) {
+        // b+_j a_i
+        const double bfac = (out_det_->nelea() & 1) ? -1.0 : 1.0;
+        for (int i = 0; i != nk; ++i) {
+          const std::complex<double>* source = buf_.get()+lbs*i;
+          for (int j = 0; j != norb; ++j) {
+            const std::complex<double> hji = h1_->element(j, unocc_[i]) * (asign[i] * bfac);
+            size_t bindex = 0;
+            for (auto& b : base_det_->string_bits_b()) {
+              if (!b[j]) {
+                std::bitset<nbit__> cb = b; cb.set(j);
+                out1[out_det_->lexical<1>(cb)] += static_cast<double>(Determinants::sign(b, -1, j)) * hji * source[bindex];
+              }
+              ++bindex;
+            }
+          }
+        }
+        out_.emplace_back(sigma1_, out_det_->lexical<0>(astring_), std::move(out1));
+      }
+    }
+};
+
+
+// Two alpha electrons are annihilated from the CI vector in sector (na, nb). Contributions to
+//   (na-1, nb+1) from a+_i b+_j a_l a_k
+//   (na-2, nb+2) from b+_i b+_j a_l a_k
+class DistZTask2 : public DistZTask_base {
+  protected:
+    // (na-2, nb)
+    std::shared_ptr<const Determinants> int_det_;
+    // (na-1, nb+1)
+    std::shared_ptr<const Determinants> out1_det_;
+    // (na-2, nb+2), or nullptr if the sector does not exist
+    std::shared_ptr<const Determinants> out2_det_;
+
+    std::shared_ptr<const ZMatrix> hab_;
+    std::shared_ptr<const ZMatrix> hbb_;
+
+    std::shared_ptr<ZDistCivec> sigma1_;
+    std::shared_ptr<ZDistCivec> sigma2_;
+
+  public:
+    DistZTask2(const std::bitset<nbit__> astring, std::shared_ptr<const Determinants> base_det, std::shared_ptr<const Determinants> int_det,
+               std::shared_ptr<const Determinants> out1_det, std::shared_ptr<const Determinants> out2_det, std::shared_ptr<const ZMatrix> hab,
+               std::shared_ptr<const ZMatrix> hbb, std::shared_ptr<const ZDistCivec> cc, std::shared_ptr<ZDistCivec> sigma1, std::shared_ptr<ZDistCivec> sigma2)
+     : DistZTask_base(astring, base_det), int_det_(int_det), out1_det_(out1_det), out2_det_(out2_det), hab_(hab), hbb_(hbb), sigma1_(sigma1), sigma2_(sigma2) {
+      const size_t lbs = base_det->lenb();
+      const int nk = unocc_.size();
+      buf_ = std::unique_ptr<std::complex<double>[]>(new std::complex<double>[lbs*nk*(nk-1)/2]);
+      for (int k = 0, kl = 0; k != nk; ++k)
+        for (int l = 0; l < k; ++l, ++kl) {
+          std::bitset<nbit__> tmp = astring; tmp.set(unocc_[k]); tmp.set(unocc_[l]);
+          requests_.push_back(cc->rma_rget(buf_.get()+lbs*kl, base_det->lexical<0>(tmp)));
+        }
+    }
+
+    void compute() {
+      const int norb = base_det_->norb();
+      const int nk = unocc_.size();
+      const size_t lbs = base_det_->lenb();
+      assert(lbs == int_det_->lenb());
+
+      // d(b, l+nk*k) = a_k a_l |C>
+      const int nn = nk*nk;
+      std::unique_ptr<std::complex<double>[]> d(new std::complex<double>[lbs*nn]);
+      std::fill_n(d.get(), lbs*nn, 0.0);
+      for (int k = 0; k != nk; ++k)
+        for (int l = 0; l != nk; ++l) {
+          if (k == l) continue;
+          const int kl = k > l ? k*(k-1)/2+l : l*(l-1)/2+k;
+          const double factor = Determinants::sign(astring_, unocc_[k], unocc_[l]) * (k < l ? -1.0 : 1.0);
+          blas::ax_plus_y_n(factor, buf_.get()+lbs*kl, lbs, d.get()+lbs*(l+nk*k));
+        }
+
+      // a+_i b+_j
+      {
+        const int mm = nk*norb;
+        std::unique_ptr<std::complex<double>[]> h(new std::complex<double>[mm*nn]);
+        for (int k = 0; k != nk; ++k)
+          for (int l = 0; l != nk; ++l)
+            for (int j = 0; j != norb; ++j)
+              for (int i = 0; i != nk; ++i)
+                h[i+nk*j+mm*(l+nk*k)] = hab_->element(unocc_[i]+norb*j, unocc_[l]+norb*unocc_[k]);
+        std::unique_ptr<std::complex<double>[]> e(new std::complex<double>[lbs*mm]);
+        zgemm3m_("N", "T", lbs, mm, nn, 1.0, d.get(), lbs, h.get(), mm, 0.0, e.get(), lbs);
+
+        const size_t lbt = out1_det_->lenb();
+        for (int i = 0; i != nk; ++i) {
+          std::unique_ptr<std::complex<double>[]> row(new std::complex<double>[lbt]);
+          std::fill_n(row.get(), lbt, 0.0);
+          const double asign = Determinants::sign(astring_, -1, unocc_[i]);
+          for (int j = 0; j != norb; ++j)
+            for (auto& b : int_det_->phiupb(j))
+              row[b.target] += (asign * b.sign) * e[b.source+lbs*(i+nk*j)];
+          std::bitset<nbit__> atarget = astring_; atarget.set(unocc_[i]);
+          out_.emplace_back(sigma1_, out1_det_->lexical<0>(atarget), std::move(row));
+        }
+      }
+
+      // b+_i b+_j
+      if (out2_det_) {
+        const int n2 = norb*norb;
+        std::unique_ptr<std::complex<double>[]> h(new std::complex<double>[n2*nn]);
+        for (int k = 0; k != nk; ++k)
+          for (int l = 0; l != nk; ++l)
+            for (int ij = 0; ij != n2; ++ij)
+              h[ij+n2*(l+nk*k)] = 0.5 * hbb_->element(ij, unocc_[l]+norb*unocc_[k]);
+        std::unique_ptr<std::complex<double>[]> e(new std::complex<double>[lbs*n2]);
+        zgemm3m_("N", "T", lbs, n2, nn, 1.0, d.get(), lbs, h.get(), n2, 0.0, e.get(), lbs);
+
+        std::unique_ptr<std::complex<double>[]> row(new std::complex<double>[out2_det_->lenb()]);
+        std::fill_n(row.get(), out2_det_->lenb(), 0.0);
+        create_bb(int_det_, out2_det_, e.get(), row.get());
+        out_.emplace_back(sigma2_, out2_det_->lexical<0>(astring_), std::move(row));
+      }
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,97 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: reldistcivec.cc
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <numeric>
+#include <src/ci/zfci/reldistcivec.h>
+
+using namespace std;
+using namespace bagel;
+
+RelZDistCivec::RelZDistCivec(shared_ptr<const Space_base> space) : space_(space) {
+  for (auto& isp : space->detmap())
+    civecs_.emplace(make_pair(isp.second->nelea(), isp.second->neleb()), make_shared<ZDistCivec>(isp.second));
+}
+
+
+RelZDistCivec::RelZDistCivec(const RelZDistCivec& o) : space_(o.space_) {
+  for (auto& i : o.civecs_)
+    civecs_.emplace(i.first, i.second->copy());
+}
+
+
+void RelZDistCivec::zero() {
+  for (auto& i : civecs_)
+    i.second->zero();
+}
+
+
+void RelZDistCivec::scale(const complex<double> a) {
+  for (auto& i : civecs_)
+    i.second->scale(a);
+}
+
+
+size_t RelZDistCivec::size() const {
+  return accumulate(civecs_.begin(), civecs_.end(), 0ull, [](size_t i, const MapType::value_type& o) { return i+o.second->global_size(); });
+}
+
+
+complex<double> RelZDistCivec::dot_product(const RelZDistCivec& o) const {
+  complex<double> out = 0.0;
+  auto iter = o.civecs_.begin();
+  for (auto& i : civecs_) {
+    assert(i.first == iter->first);
+    out += i.second->dot_product(*iter->second);
+    ++iter;
+  }
+  return out;
+}
+
+
+void RelZDistCivec::ax_plus_y(const complex<double> a, const RelZDistCivec& o) {
+  auto iter = o.civecs_.begin();
+  for (auto& i : civecs_) {
+    assert(i.first == iter->first);
+    i.second->ax_plus_y(a, *iter->second);
+    ++iter;
+  }
+}
+
+
+double RelZDistCivec::normalize() {
+  const double norm = this->norm();
+  const double scal = (norm*norm<1.0e-60 ? 0.0 : 1.0/norm);
+  scale(complex<double>(scal));
+  return norm;
+}
+
+
+shared_ptr<RelZDvec> RelZDistCivec::reldvec() const {
+  auto out = make_shared<RelZDvec>(space_, 1);
+  for (auto& i : civecs_) {
+    shared_ptr<const ZCivec> c = i.second->civec();
+    copy_n(c->data(), c->size(), out->find(i.first.first, i.first.second)->data(0)->data());
+  }
+  return out;
+}
@@ -0,0 +1,80 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: reldistcivec.h
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __SRC_ZFCI_RELDISTCIVEC_H
+#define __SRC_ZFCI_RELDISTCIVEC_H
+
+#include <src/ci/fci/distcivec.h>
+#include <src/ci/zfci/reldvec.h>
+
+namespace bagel {
+
+// One relativistic CI vector: a distributed vector for each Kramers sector (nelea, neleb) of the space.
+// Each of them is distributed over processes by alpha strings (see DistCivector).
+class RelZDistCivec {
+  protected:
+    using MapType = std::map<std::pair<int,int>, std::shared_ptr<ZDistCivec>>;
+
+    MapType civecs_;
+    std::shared_ptr<const Space_base> space_;
+
+  public:
+    RelZDistCivec(std::shared_ptr<const Space_base> space);
+    RelZDistCivec(const RelZDistCivec& o);
+
+    std::shared_ptr<RelZDistCivec> clone() const { return std::make_shared<RelZDistCivec>(space_); }
+    std::shared_ptr<RelZDistCivec> copy() const { return std::make_shared<RelZDistCivec>(*this); }
+
+    std::shared_ptr<ZDistCivec> find(int a, int b) { return civecs_.at({a, b}); }
+    std::shared_ptr<const ZDistCivec> find(int a, int b) const { return civecs_.at({a, b}); }
+
+    std::shared_ptr<const Space_base> space() const { return space_; }
+    const MapType& civecs() const { return civecs_; }
+
+    void zero();
+    void scale(const std::complex<double> a);
+
+    size_t size() const;
+    double norm() const { return std::sqrt(detail::real(dot_product(*this))); }
+    double variance() const { return detail::real(dot_product(*this)) / size(); }
+    double rms() const { return std::sqrt(variance()); }
+
+    std::complex<double> dot_product(std::shared_ptr<const RelZDistCivec> o) const { return dot_product(*o); }
+    std::complex<double> dot_product(const RelZDistCivec& o) const;
+
+    void ax_plus_y(const std::complex<double> a, std::shared_ptr<const RelZDistCivec> o) { ax_plus_y(a, *o); }
+    void ax_plus_y(const std::complex<double> a, const RelZDistCivec& o);
+
+    void project_out(std::shared_ptr<const RelZDistCivec> o) { ax_plus_y(-dot_product(*o), *o); }
+    double normalize();
+
+    // collects the distributed vectors into a RelZDvec with one state on every process
+    std::shared_ptr<RelZDvec> reldvec() const;
+
+    void synchronize() { /* do nothing */ }
+};
+
+}
+
+#endif
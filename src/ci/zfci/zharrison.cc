@@ -256,44 +256,11 @@ void ZHarrison::compute() {
     // Creating an initial CI vector
     cc_ = make_shared<RelZDvec>(space_, nstate_); // B runs first
 
-    // TODO really we should check the number of states for each S value, rather than total number
-    const static Comb combination;
-    const size_t max_states = combination(2*norb_, nele_);
-    if (nstate_ > max_states) {
-      const string space = "(" + to_string(nele_) + "," + to_string(norb_) + ")";
-      throw runtime_error("Wrong states specified - a " + space + " active space can only produce " + to_string(max_states) + " eigenstates.");
-    }
-
     // find determinants that have small diagonal energies
     int offset = 0;
-    for (int ispin = 0; ispin != states_.size(); ++ispin) {
-      int nstate = 0;
-      for (int i = ispin; i != states_.size(); ++i)
-        nstate += states_[i];
-
-      if (nstate == 0)
-        continue;
-
-      if ((geom_->nele()+ispin-charge_) % 2 == 1) {
-        if (states_[ispin] == 0) {
-          continue;
-        } else {
-          if ((geom_->nele()-charge_) % 2 == 0) throw runtime_error("Wrong states specified - only integer spins are allowed for even electron counts.");
-          else throw runtime_error("Wrong states specified - only half-integer spins are allowed for odd electron counts.");
-        }
-      }
-
-      const int nelea = (geom_->nele()+ispin-charge_)/2 - ncore_;
-      const int neleb = (geom_->nele()-ispin-charge_)/2 - ncore_;
-      if (neleb < 0) throw runtime_error("Wrong states specified - there are not enough active electrons for the requested spin state.");
-      if (nelea > norb_) throw runtime_error("Wrong states specified - there are not enough active orbitals for the requested spin state.");
-
-      generate_guess(nelea, neleb, nstate, cc_, offset);
-      offset += nstate;
-      if (nelea != neleb) {
-        generate_guess(neleb, nelea, nstate, cc_, offset);
-        offset += nstate;
-      }
+    for (auto& i : guess_sectors()) {
+      generate_guess(get<0>(i), get<1>(i), get<2>(i), cc_, offset);
+      offset += get<2>(i);
     }
     pdebug.tick_print("guess generation");
 
@@ -387,7 +354,51 @@ void ZHarrison::compute() {
   }
 #endif
 
+  analyze_aniso();
+}
+
+
+vector<tuple<int,int,int>> ZHarrison::guess_sectors() const {
+  // TODO really we should check the number of states for each S value, rather than total number
+  const static Comb combination;
+  const size_t max_states = combination(2*norb_, nele_);
+  if (nstate_ > max_states) {
+    const string space = "(" + to_string(nele_) + "," + to_string(norb_) + ")";
+    throw runtime_error("Wrong states specified - a " + space + " active space can only produce " + to_string(max_states) + " eigenstates.");
+  }
+
+  vector<tuple<int,int,int>> out;
+  for (int ispin = 0; ispin != states_.size(); ++ispin) {
+    int nstate = 0;
+    for (int i = ispin; i != states_.size(); ++i)
+      nstate += states_[i];
+
+    if (nstate == 0)
+      continue;
+
+    if ((geom_->nele()+ispin-charge_) % 2 == 1) {
+      if (states_[ispin] == 0) {
+        continue;
+      } else {
+        if ((geom_->nele()-charge_) % 2 == 0) throw runtime_error("Wrong states specified - only integer spins are allowed for even electron counts.");
+        else throw runtime_error("Wrong states specified - only half-integer spins are allowed for odd electron counts.");
+      }
+    }
+
+    const int nelea = (geom_->nele()+ispin-charge_)/2 - ncore_;
+    const int neleb = (geom_->nele()-ispin-charge_)/2 - ncore_;
+    if (neleb < 0) throw runtime_error("Wrong states specified - there are not enough active electrons for the requested spin state.");
+    if (nelea > norb_) throw runtime_error("Wrong states specified - there are not enough active orbitals for the requested spin state.");
+
+    out.emplace_back(nelea, neleb, nstate);
+    if (nelea != neleb)
+      out.emplace_back(neleb, nelea, nstate);
+  }
+  return out;
+}
+
 
+void ZHarrison::analyze_aniso() {
   // TODO When the Property class is implemented, this should be one
   shared_ptr<const PTree> aniso_data = idata_->get_child_optional("aniso");
   if (aniso_data) {
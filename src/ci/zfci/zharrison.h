@@ -131,9 +131,15 @@ class ZHarrison : public Method {
     // generate spin-adapted guess configurations
     std::vector<std::pair<std::bitset<nbit__>, std::bitset<nbit__>>> detseeds(const int ndet, const int nelea, const int neleb) const;
 
+    // (nelea, neleb, nstate) of the guess vectors in the order they are generated
+    std::vector<std::tuple<int,int,int>> guess_sectors() const;
+
     // print functions
     void print_header() const;
 
+    // pseudospin analysis if requested in the input
+    void analyze_aniso();
+
     void const_denom();
 
     // run-time functions.
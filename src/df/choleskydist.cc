@@ -0,0 +1,261 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: choleskydist.cc
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+
+#include <functional>
+#include <src/df/choleskydist.h>
+#include <src/df/dfdistt.h>
+#include <src/integral/rys/eribatch.h>
+#include <src/util/taskqueue.h>
+#include <src/util/f77.h>
+
+using namespace std;
+using namespace bagel;
+
+namespace {
+// shell pairs whose diagonal is smaller than this fraction of the largest one are not used as pivots in the same iteration
+const double span = 1.0e-2;
+// maximum number of columns computed in one iteration
+const int maxcolumns = 256;
+}
+
+
+CholeskyDist::Vectors CholeskyDist::decompose(const int nbas, const vector<shared_ptr<const Atom>>& atoms, const double thresh) {
+  Timer time;
+
+  vector<shared_ptr<const Shell>> shells;
+  vector<int> offset;
+  int n = 0;
+  for (auto& a : atoms)
+    for (auto& s : a->shells()) {
+      shells.push_back(s);
+      offset.push_back(n);
+      n += s->nbasis();
+    }
+  assert(n == nbas);
+  const int nshell = shells.size();
+  const size_t npair = static_cast<size_t>(nbas)*nbas;
+
+  // rows r+nbas*s are distributed by the shell of s
+  const int myrank = mpi__->rank();
+  const int nproc = mpi__->size();
+  StaticDist sdist(nbas, nproc);
+  vector<int> shellstart(nproc+1, nshell);
+  vector<size_t> rowstart(nproc+1, npair);
+  for (int r = 0; r != nproc; ++r) {
+    shellstart[r] = lower_bound(offset.begin(), offset.end(), sdist.start(r)) - offset.begin();
+    rowstart[r] = shellstart[r] == nshell ? npair : static_cast<size_t>(offset[shellstart[r]])*nbas;
+  }
+  auto rowdist = make_shared<const StaticDist>(rowstart);
+  const size_t rstart = rowstart[myrank];
+  const size_t nrow = rowdist->size(myrank);
+  auto row = [&](const int i, const int r, const int j, const int s) { return offset[i]+r + nbas*static_cast<size_t>(offset[j]+s) - rstart; };
+
+  // diagonal (rs|rs) and its square root for each pair of shells (used for screening)
+  vector<double> diag(nrow);
+  vector<double> schwarz(nshell*nshell, 0.0);
+  {
+    TaskQueue<function<void(void)>> tasks(nshell*(shellstart[myrank+1]-shellstart[myrank]));
+    for (int j = shellstart[myrank]; j != shellstart[myrank+1]; ++j)
+      for (int i = 0; i != nshell; ++i)
+        tasks.emplace_back([&, i, j]() {
+          ERIBatch eri(array<shared_ptr<const Shell>,4>{{shells[i], shells[j], shells[i], shells[j]}}, 1.0);
+          eri.compute();
+          const double* data = eri.data();
+          const int ni = shells[i]->nbasis();
+          const int nj = shells[j]->nbasis();
+          double mx = 0.0;
+          for (int s = 0; s != nj; ++s)
+            for (int r = 0; r != ni; ++r) {
+              const double d = data[r+ni*(s+nj*(r+ni*s))];
+              diag[row(i, r, j, s)] = d;
+              mx = max(mx, d);
+            }
+          schwarz[i+nshell*j] = sqrt(mx);
+        });
+    tasks.compute();
+    mpi__->allreduce(schwarz.data(), schwarz.size());
+  }
+  const double screen = min(1.0e-12, 1.0e-3*thresh);
+  time.tick_print("Cholesky diagonal");
+
+  // local part of the vectors (nrow x nvec)
+  vector<double> lvec;
+  int nvec = 0;
+  while (true) {
+    // largest remaining diagonal for each shell pair
+    vector<double> dmax(nshell*nshell, 0.0);
+    for (int j = shellstart[myrank]; j != shellstart[myrank+1]; ++j)
+      for (int i = 0; i != nshell; ++i)
+        for (int s = 0; s != shells[j]->nbasis(); ++s)
+          for (int r = 0; r != shells[i]->nbasis(); ++r)
+            dmax[i+nshell*j] = max(dmax[i+nshell*j], diag[row(i, r, j, s)]);
+    mpi__->allreduce(dmax.data(), dmax.size());
+    const double gmax = *max_element(dmax.begin(), dmax.end());
+    if (gmax < thresh || static_cast<size_t>(nvec) >= npair)
+      break;
+    const double cut = max(thresh, span*gmax);
+
+    // candidate shell pairs (kl and lk give the same columns), the largest first
+    vector<int> cand;
+    for (int l = 0; l != nshell; ++l)
+      for (int k = l; k != nshell; ++k)
+        if (dmax[k+nshell*l] >= cut)
+          cand.push_back(k+nshell*l);
+    stable_sort(cand.begin(), cand.end(), [&dmax](const int a, const int b) { return dmax[a] > dmax[b]; });
+
+    vector<int> qpair;
+    vector<size_t> qrow;
+    for (auto& c : cand) {
+      const int k = c % nshell;
+      const int l = c / nshell;
+      const int nk = shells[k]->nbasis();
+      const int nl = shells[l]->nbasis();
+      if (!qrow.empty() && qrow.size()+nk*nl > maxcolumns)
+        break;
+      qpair.push_back(c);
+      for (int u = 0; u != nl; ++u)
+        for (int t = 0; t != nk; ++t)
+          qrow.push_back(offset[k]+t + nbas*static_cast<size_t>(offset[l]+u));
+    }
+    const int nq = qrow.size();
+
+    // columns (rs|tu) for the local rows
+    vector<double> mcol(nrow*nq, 0.0);
+    {
+      TaskQueue<function<void(void)>> tasks(qpair.size()*nshell*(shellstart[myrank+1]-shellstart[myrank]));
+      int q0 = 0;
+      for (auto& c : qpair) {
+        const int k = c % nshell;
+        const int l = c / nshell;
+        for (int j = shellstart[myrank]; j != shellstart[myrank+1]; ++j)
+          for (int i = 0; i != nshell; ++i) {
+            if (schwarz[i+nshell*j]*schwarz[c] < screen) continue;
+            tasks.emplace_back([&, i, j, k, l, q0]() {
+              ERIBatch eri(array<shared_ptr<const Shell>,4>{{shells[i], shells[j], shells[k], shells[l]}}, 1.0);
+              eri.compute();
+              const double* data = eri.data();
+              const int ni = shells[i]->nbasis();
+              const int nj = shells[j]->nbasis();
+              for (int q = 0; q != shells[k]->nbasis()*shells[l]->nbasis(); ++q)
+                for (int s = 0; s != nj; ++s)
+                  copy_n(data+ni*(s+nj*q), ni, mcol.data()+row(i, 0, j, s)+nrow*(q0+q));
+            });
+          }
+        q0 += shells[k]->nbasis()*shells[l]->nbasis();
+      }
+      tasks.compute();
+    }
+
+    // subtract the contributions of the vectors so far
+    auto local = [&](const size_t p) { return p >= rstart && p < rstart+nrow; };
+    if (nvec) {
+      vector<double> lq(nq*nvec, 0.0);
+      for (int q = 0; q != nq; ++q)
+        if (local(qrow[q]))
+          for (int v = 0; v != nvec; ++v)
+            lq[q+nq*v] = lvec[qrow[q]-rstart+nrow*v];
+      mpi__->allreduce(lq.data(), lq.size());
+      if (nrow)
+        dgemm_("N", "T", nrow, nq, nvec, -1.0, lvec.data(), nrow, lq.data(), nq, 1.0, mcol.data(), nrow);
+    }
+
+    // pivoted Cholesky decomposition of the block of the candidate rows and columns
+    vector<double> g(nq*nq, 0.0);
+    for (int q = 0; q != nq; ++q)
+      if (local(qrow[q]))
+        for (int p = 0; p != nq; ++p)
+          g[q+nq*p] = mcol[qrow[q]-rstart+nrow*p];
+    mpi__->allreduce(g.data(), g.size());
+
+    vector<int> piv;
+    vector<double> lg;
+    vector<double> gd(nq);
+    for (int q = 0; q != nq; ++q)
+      gd[q] = g[q+nq*q];
+    while (static_cast<int>(piv.size()) != nq) {
+      const int p = max_element(gd.begin(), gd.end()) - gd.begin();
+      if (gd[p] < cut) break;
+      const int m = piv.size();
+      const double fac = 1.0/sqrt(gd[p]);
+      lg.resize(nq*(m+1));
+      double* col = lg.data()+nq*m;
+      for (int q = 0; q != nq; ++q) {
+        col[q] = g[q+nq*p];
+        for (int k = 0; k != m; ++k)
+          col[q] -= lg[q+nq*k] * lg[p+nq*k];
+        col[q] *= fac;
+        gd[q] -= col[q]*col[q];
+      }
+      for (auto& i : piv) gd[i] = 0.0;
+      gd[p] = 0.0;
+      piv.push_back(p);
+    }
+    const int m = piv.size();
+    if (m == 0) break;
+
+    // new vectors: L_new T^T = M(:,piv), where T(k,k') = lg(piv[k],k') is lower triangular
+    lvec.resize(nrow*(nvec+m));
+    double* lnew = lvec.data()+nrow*nvec;
+    if (nrow)
+      for (int k = 0; k != m; ++k) {
+        copy_n(mcol.data()+nrow*piv[k], nrow, lnew+nrow*k);
+        if (k)
+          dgemv_("N", nrow, k, -1.0, lnew, nrow, lg.data()+piv[k], nq, 1.0, lnew+nrow*k, 1);
+        dscal_(nrow, 1.0/lg[piv[k]+nq*k], lnew+nrow*k, 1);
+      }
+    for (int k = 0; k != m; ++k)
+      for (size_t x = 0; x != nrow; ++x)
+        diag[x] -= lnew[x+nrow*k]*lnew[x+nrow*k];
+    nvec += m;
+  }
+  if (nvec == 0)
+    throw runtime_error("Cholesky decomposition of the two-electron integrals yields no vectors; check cholesky_thresh");
+
+  cout << "    * Cholesky decomposition with threshold " << scientific << setprecision(1) << thresh << " yields "
+       << nvec << " vectors" << endl;
+  time.tick_print("Cholesky vectors");
+
+  auto out = make_shared<Matrix>(nvec, nrow, true);
+  if (nrow)
+    blas::transpose(lvec.data(), nrow, nvec, out->data());
+  return {out, rowdist};
+}
+
+
+CholeskyDist::CholeskyDist(const int nbas, const Vectors& vectors) : DFDist(nbas, vectors.first->ndim()) {
+  const int myrank = mpi__->rank();
+  auto adist = make_shared<const StaticDist>(naux_, mpi__->size());
+  block_.push_back(make_shared<DFBlock>(adist, adist, adist->size(myrank), nbas, nbas, adist->start(myrank), 0, 0));
+
+  // from the distribution over pairs to the distribution over vectors
+  auto view = make_shared<DFDist>(nbas, naux_, block_.front());
+  DFDistT trans(naux_, vectors.second, nbas, nbas, view);
+  copy_n(vectors.first->data(), vectors.first->size(), trans.data());
+  trans.get_paralleldf(view);
+
+  // (rs|tu) = sum_P L^P_rs L^P_tu; there is no metric
+  data2_ = make_shared<Matrix>(naux_, naux_, serial_);
+  data2_->unit();
+}
@@ -0,0 +1,54 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: choleskydist.h
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+
+#ifndef __SRC_DF_CHOLESKYDIST_H
+#define __SRC_DF_CHOLESKYDIST_H
+
+#include <src/df/df.h>
+
+namespace bagel {
+
+/// Three-index integrals from the pivoted Cholesky decomposition of the AO two-electron integrals.
+/** The Cholesky vectors satisfy (rs|tu) = sum_P L^P_rs L^P_tu to within the threshold on the diagonal (rs|rs).
+    They are stored in the layout of the fitted 3-index integrals with the identity as the 2-index part,
+    so that this class can be used wherever DFDist is used. While the vectors are generated, the pairs rs are distributed
+    over processes by the shells of s; the result is then redistributed over the vectors as in DFDist_ints. */
+class CholeskyDist : public DFDist {
+  protected:
+    using Vectors = std::pair<std::shared_ptr<const Matrix>, std::shared_ptr<const StaticDist>>;
+
+    // returns the local part of the vectors (nvec x number of local pairs) and the distribution of pairs
+    static Vectors decompose(const int nbas, const std::vector<std::shared_ptr<const Atom>>& atoms, const double thresh);
+
+    CholeskyDist(const int nbas, const Vectors& vectors);
+
+  public:
+    CholeskyDist(const int nbas, const std::vector<std::shared_ptr<const Atom>>& atoms, const double thresh)
+      : CholeskyDist(nbas, decompose(nbas, atoms, thresh)) { }
+};
+
+}
+
+#endif
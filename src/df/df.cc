@@ -76,6 +76,56 @@ tuple<int, vector<shared_ptr<const Shell>>> DFDist::get_ashell(const vector<shar
 }
 
 
+vector<shared_ptr<const ShellPair>> DFDist::significant_pairs(const vector<shared_ptr<const Shell>>& b1shell, const vector<shared_ptr<const Shell>>& b2shell) const {
+  // candidates are selected by the Gaussian-product prefactor of the most diffuse primitives, so that the
+  // Schwarz integrals are only computed for O(N) pairs. The tolerance is the same as in ShellPair.
+  const double tol = 20.0 / log10(exp(1));
+  vector<pair<int,int>> candidates;
+  vector<array<int,2>> offsets;
+  int j2 = 0;
+  for (int s2 = 0; s2 != b2shell.size(); ++s2) {
+    const double e2 = *min_element(b2shell[s2]->exponents().begin(), b2shell[s2]->exponents().end());
+    int j1 = 0;
+    for (int s1 = 0; s1 != b1shell.size() && j1 <= j2; ++s1) {
+      const double e1 = *min_element(b1shell[s1]->exponents().begin(), b1shell[s1]->exponents().end());
+      const array<double,3>& p1 = b1shell[s1]->position();
+      const array<double,3>& p2 = b2shell[s2]->position();
+      const double rsq = pow(p1[0]-p2[0], 2) + pow(p1[1]-p2[1], 2) + pow(p1[2]-p2[2], 2);
+      if (e1*e2/(e1+e2)*rsq < tol) {
+        candidates.emplace_back(s1, s2);
+        offsets.push_back({{j1, j2}});
+      }
+      j1 += b1shell[s1]->nbasis();
+    }
+    j2 += b2shell[s2]->nbasis();
+  }
+
+  vector<shared_ptr<const ShellPair>> out(candidates.size());
+  TaskQueue<function<void(void)>> tasks(candidates.size());
+  for (size_t i = 0; i != candidates.size(); ++i)
+    tasks.emplace_back([&, i] {
+      out[i] = make_shared<const ShellPair>(array<shared_ptr<const Shell>,2>{{b1shell[candidates[i].first], b2shell[candidates[i].second]}}, offsets[i], candidates[i]);
+    });
+  tasks.compute();
+  return out;
+}
+
+
+vector<double> DFDist::aux_schwarz(const vector<shared_ptr<const Shell>>& ashell) const {
+  auto b3 = make_shared<const Shell>(ashell.front()->spherical());
+  vector<double> out;
+  for (auto& i0 : ashell) {
+    ERIBatch eribatch(array<shared_ptr<const Shell>,4>{{i0, b3, i0, b3}}, 1.0);
+    eribatch.compute();
+    double maxval = 0.0;
+    for (const double* eridata = eribatch.data(); eridata != eribatch.data()+eribatch.data_size(); ++eridata)
+      maxval = max(maxval, fabs(*eridata));
+    out.push_back(sqrt(maxval));
+  }
+  return out;
+}
+
+
 void DFDist::compute_2index(const vector<shared_ptr<const Shell>>& ashell, const double throverlap, const bool compute_inverse) {
   Timer time;
 
@@ -146,6 +196,15 @@ shared_ptr<DFHalfDist> DFDist::compute_half_transform(const MatView c) const {
 }
 
 
+shared_ptr<DFHalfDist> DFDist::compute_half_transform_single(const MatView c) const {
+  const int nocc = c.extent(1);
+  auto out = make_shared<DFHalfDist>(df_ ? df_ : shared_from_this(), nocc);
+  for (auto& i : block_)
+    out->add_block(i->transform_second_single(c));
+  return out;
+}
+
+
 shared_ptr<DFHalfDist> DFDist::compute_half_transform_swap(const MatView c) const {
   const int nocc = c.extent(1);
   auto out = make_shared<DFHalfDist>(df_ ? df_ : shared_from_this(), nocc);
@@ -155,6 +214,93 @@ shared_ptr<DFHalfDist> DFDist::compute_half_transform_swap(const MatView c) cons
 }
 
 
+shared_ptr<DFFullDist> DFDist::compute_full_transform(const MatView c1, const MatView c2, const int number_of_j) const {
+  if (number_of_j < 0 || number_of_j > 2)
+    throw logic_error("wrong number of J in DFDist::compute_full_transform");
+
+  // J is applied on the fly when all the auxiliary functions are local
+  const bool local = all_of(block_.begin(), block_.end(), [this](shared_ptr<const DFBlock> b) { return b->asize() == naux_; });
+  shared_ptr<const Matrix> data2 = df_ ? df_->data2() : data2_;
+  if (number_of_j && !data2)
+    throw logic_error("DFDist::compute_full_transform was called without 2-index integrals");
+  shared_ptr<const Matrix> d;
+  if (number_of_j && local)
+    d = number_of_j == 1 ? data2 : make_shared<Matrix>(*data2 * *data2);
+
+  auto out = make_shared<DFFullDist>(df_ ? df_ : shared_from_this(), c1.extent(1), c2.extent(1));
+  for (auto& i : block_)
+    out->add_block(i->transform_second_third(c1, c2, d));
+
+  if (number_of_j && !local)
+    out = number_of_j == 1 ? out->apply_J() : out->apply_JJ();
+  return out;
+}
+
+
+shared_ptr<Matrix> DFDist::compute_Kop_local(const MatView c, const vector<vector<pair<int,int>>>& crange,
+                                             const vector<vector<pair<int,int>>>& krange, const double a) const {
+  if (block_.size() != 1) throw logic_error("so far assumes block_.size() == 1");
+  const int nocc = c.extent(1);
+  assert(crange.size() == static_cast<size_t>(nocc) && krange.size() == static_cast<size_t>(nocc) && c.extent(0) == nindex2_);
+
+  // offsets of the significant AOs of each orbital in the packed index
+  vector<size_t> poffset(nocc+1, 0);
+  for (int i = 0; i != nocc; ++i)
+    poffset[i+1] = accumulate(krange[i].begin(), krange[i].end(), poffset[i], [](const size_t n, const pair<int,int>& r) { return n+r.second-r.first; });
+  const size_t npack = poffset.back();
+
+  auto out = make_shared<Matrix>(nindex1_, nindex2_);
+  if (npack == 0)
+    return out;
+
+  // (P|ir) = sum_s (P|rs) c(s,i) for the significant r of each orbital, packed over i and r
+  shared_ptr<const DFBlock> blk = block_[0];
+  const size_t asize = blk->asize();
+  auto packed = make_shared<DFBlock>(blk->adist_shell(), blk->adist(), asize, 1, npack, blk->astart(), 0, 0, blk->averaged());
+  packed->zero();
+  const Matrix cmat(c);
+  TaskQueue<function<void(void)>> tasks(nocc);
+  for (int i = 0; i != nocc; ++i)
+    tasks.emplace_back([&, i]() {
+      for (auto& srange : crange[i])
+        for (int s = srange.first; s != srange.second; ++s) {
+          double* target = packed->data() + asize*poffset[i];
+          for (auto& r : krange[i]) {
+            const size_t n = asize*(r.second-r.first);
+            blas::ax_plus_y_n(cmat(s, i), blk->data()+asize*(r.first+nindex1_*s), n, target);
+            target += n;
+          }
+        }
+    });
+  tasks.compute();
+
+  auto half = make_shared<DFFullDist>(df_ ? df_ : shared_from_this(), 1, npack);
+  half->add_block(packed);
+  shared_ptr<const DFBlock> jhalf = half->apply_J()->block(0);
+
+  // K(r,s) += a sum_P (P|ir)(P|is) within the significant block of each orbital
+  for (int i = 0; i != nocc; ++i) {
+    const size_t n = poffset[i+1]-poffset[i];
+    if (n == 0 || asize == 0) continue;
+    Matrix tmp(n, n, true);
+    dgemm_("T", "N", n, n, asize, a, jhalf->data()+asize*poffset[i], asize, jhalf->data()+asize*poffset[i], asize, 0.0, tmp.data(), n);
+    size_t ioff = 0;
+    for (auto& rj : krange[i]) {
+      for (int j = rj.first; j != rj.second; ++j, ++ioff) {
+        const double* source = tmp.element_ptr(0, ioff);
+        for (auto& ri : krange[i]) {
+          blas::ax_plus_y_n(1.0, source, ri.second-ri.first, out->element_ptr(ri.first, j));
+          source += ri.second-ri.first;
+        }
+      }
+    }
+  }
+  if (!serial_)
+    out->allreduce();
+  return out;
+}
+
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 
@@ -183,6 +329,14 @@ shared_ptr<DFHalfDist> DFHalfDist::clone() const {
 }
 
 
+shared_ptr<DFHalfDist> DFHalfDist::slice(const int start, const int fence) const {
+  auto out = make_shared<DFHalfDist>(df_, fence-start);
+  for (auto& i : block_)
+    out->add_block(i->slice_b1(start, fence));
+  return out;
+}
+
+
 shared_ptr<DFDist> DFHalfDist::back_transform(const MatView c) const{
   assert(df_->nindex1() == c.extent(0));
   auto out = make_shared<DFDist>(df_);
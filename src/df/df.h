@@ -27,6 +27,7 @@
 
 #include <src/df/paralleldf.h>
 #include <src/molecule/atom.h>
+#include <src/molecule/shellpair.h>
 
 namespace bagel {
 
@@ -45,6 +46,12 @@ class DFDist : public ParallelDF {
 
     std::tuple<int, std::vector<std::shared_ptr<const Shell>>> get_ashell(const std::vector<std::shared_ptr<const Shell>>& all);
 
+    // shell pairs (b1, b2) with offset(0) <= offset(1) whose products are not negligible, together with their Schwarz integrals
+    std::vector<std::shared_ptr<const ShellPair>> significant_pairs(const std::vector<std::shared_ptr<const Shell>>& b1shell,
+                                                                    const std::vector<std::shared_ptr<const Shell>>& b2shell) const;
+    // (P|P)^1/2 for each auxiliary shell P
+    std::vector<double> aux_schwarz(const std::vector<std::shared_ptr<const Shell>>& ashell) const;
+
   public:
     DFDist(const int nbas, const int naux, const std::shared_ptr<DFBlock> block = nullptr, std::shared_ptr<const ParallelDF> df = nullptr, std::shared_ptr<Matrix> data2 = nullptr,
            const bool serial = false) : ParallelDF(naux, nbas, nbas, df, data2, serial) {
@@ -63,12 +70,23 @@ class DFDist : public ParallelDF {
     std::shared_ptr<DFHalfDist> compute_half_transform(const MatView c) const;
     template<typename T, class = typename std::enable_if<btas::is_boxtensor<T>::value>::type>
     std::shared_ptr<DFHalfDist> compute_half_transform(std::shared_ptr<T> c) const { return compute_half_transform(*c); }
+    // the same as above in single precision (see DFBlock::transform_second_single)
+    std::shared_ptr<DFHalfDist> compute_half_transform_single(const MatView c) const;
 
     // compute half transform using the third index. You get DFHalfDist with gamma/i/s (i.e., index are reordered)
     std::shared_ptr<DFHalfDist> compute_half_transform_swap(const MatView c) const;
     template<typename T, class = typename std::enable_if<btas::is_boxtensor<T>::value>::type>
     std::shared_ptr<DFHalfDist> compute_half_transform_swap(std::shared_ptr<T> c) const { return compute_half_transform_swap(*c); }
 
+    // half and second transformations at once. The half-transformed integrals are not stored but streamed over the auxiliary index.
+    // number_of_j is the number of J^{-1/2} applied to the result (0, 1, or 2; cf. apply_J and apply_JJ)
+    std::shared_ptr<DFFullDist> compute_full_transform(const MatView c1, const MatView c2, const int number_of_j = 0) const;
+
+    // exchange operator a sum_i (ri|si) from localized orbitals c, restricted to the significant AOs of each orbital.
+    // crange[i] are the ranges of AOs with significant coefficients in c(:,i), and krange[i] are the ranges of r and s for orbital i.
+    std::shared_ptr<Matrix> compute_Kop_local(const MatView c, const std::vector<std::vector<std::pair<int,int>>>& crange,
+                                              const std::vector<std::vector<std::pair<int,int>>>& krange, const double a) const;
+
     std::shared_ptr<DFDist> copy() const;
     std::shared_ptr<DFDist> clone() const;
 
@@ -93,29 +111,48 @@ class DFDist_ints : public DFDist {
                         const size_t astart, const double thresh, const bool compute_inv) {
       Timer time;
 
-      // making a task list
-      TaskQueue<DFIntTask<TBatch,TBatch::Nblocks()>> tasks(b1shell.size()*b2shell.size()*ashell.size());
-
       auto i3 = std::make_shared<const Shell>(ashell.front()->spherical());
 
       // due to performance issue, we need to reshape it to array
       std::array<std::shared_ptr<DFBlock>,TBatch::Nblocks()> blk;
       for (int i = 0; i != TBatch::Nblocks(); ++i) blk[i] = block_[i];
 
-      int j2 = 0;
-      for (auto& i2 : b2shell) {
-        int j1 = 0;
-        for (auto& i1 : b1shell) {
-          if (TBatch::Nblocks() > 1 || j1 <= j2) {
+      // making a task list
+      TaskQueue<DFIntTask<TBatch,TBatch::Nblocks()>> tasks(b1shell.size()*b2shell.size()*ashell.size());
+
+      if (TBatch::Nblocks() == 1) {
+        // Schwarz screening, |(P|ab)| <= (P|P)^1/2 (ab|ab)^1/2, using the significant shell pairs
+        const std::vector<double> aschwarz = aux_schwarz(ashell);
+        const double amax = *std::max_element(aschwarz.begin(), aschwarz.end());
+
+        for (auto& b : blk)
+          b->zero();
+
+        for (auto& p : significant_pairs(b1shell, b2shell)) {
+          const double pschwarz = std::sqrt(p->schwarz());
+          if (pschwarz*amax < schwarz_thresh__) continue;
+          int j0 = 0;
+          for (int k = 0; k != ashell.size(); ++k) {
+            if (pschwarz*aschwarz[k] >= schwarz_thresh__)
+              tasks.emplace_back((std::array<std::shared_ptr<const Shell>,4>{{i3, ashell[k], p->shell(0), p->shell(1)}}), (std::array<int,3>{{p->offset(1), p->offset(0), j0}}), blk);
+            j0 += ashell[k]->nbasis();
+          }
+        }
+      } else {
+        // the batches with more than one block consist of derivative integrals, for which (ab|ab) is not a bound
+        int j2 = 0;
+        for (auto& i2 : b2shell) {
+          int j1 = 0;
+          for (auto& i1 : b1shell) {
             int j0 = 0;
             for (auto& i0 : ashell) {
               tasks.emplace_back((std::array<std::shared_ptr<const Shell>,4>{{i3, i0, i1, i2}}), (std::array<int,3>{{j2, j1, j0}}), blk);
               j0 += i0->nbasis();
             }
+            j1 += i1->nbasis();
           }
-          j1 += i1->nbasis();
+          j2 += i2->nbasis();
         }
-        j2 += i2->nbasis();
       }
       time.tick_print("3-index ints prep");
       tasks.compute();
@@ -186,6 +223,9 @@ class DFHalfDist : public ParallelDF {
     std::shared_ptr<DFHalfDist> copy() const;
     std::shared_ptr<DFHalfDist> clone() const;
 
+    // returns the integrals with the occupied indices in [start, fence)
+    std::shared_ptr<DFHalfDist> slice(const int start, const int fence) const;
+
     void rotate_occ(const std::shared_ptr<const Matrix> d);
     std::shared_ptr<DFHalfDist> apply_density(const std::shared_ptr<const Matrix> d) const;
 
@@ -22,6 +22,7 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 //
 
+#include <functional>
 #include <src/df/dfblock.h>
 
 using namespace bagel;
@@ -54,6 +55,55 @@ DFBlock::DFBlock(const DFBlock& o)
 }
 
 
+shared_ptr<DFBlock> DFBlock::transform_second_third(const MatView c1, const MatView c2, shared_ptr<const Matrix> d, const size_t maxsize) const {
+  assert(c1.extent(0) == b1size() && c2.extent(0) == b2size());
+  assert(c1.range().ordinal().contiguous() && c2.range().ordinal().contiguous());
+  assert(b1start_ == 0 && b2start_ == 0);
+  assert(!d || (astart_ == 0 && d->ndim() == asize() && d->mdim() == asize()));
+
+  const size_t n1 = c1.extent(1);
+  const size_t n2 = c2.extent(1);
+  auto out = make_shared<DFBlock>(adist_shell_, adist_, asize(), n1, n2, astart_, 0, 0, averaged_);
+  if (asize() == 0 || n1 == 0 || n2 == 0)
+    return out;
+  if (d)
+    out->zero();
+
+  const size_t nbatch = max<size_t>(1, min(asize(), maxsize/max<size_t>(1, n1*b2size())));
+  // the result is written directly when there is only one batch
+  const bool direct = nbatch == asize() && !d;
+  unique_ptr<double[]> half(new double[nbatch*n1*b2size()]);
+  unique_ptr<double[]> full(direct ? nullptr : new double[nbatch*n1*n2]);
+
+  for (size_t a0 = 0; a0 < asize(); a0 += nbatch) {
+    const size_t na = min(nbatch, asize()-a0);
+    // (a i|r) = (a s|r) c1(s,i)
+    for (size_t r = 0; r != b2size(); ++r)
+      dgemm_("N", "N", na, n1, b1size(), 1.0, data()+a0+asize()*b1size()*r, asize(), c1.data(), b1size(), 0.0, half.get()+na*n1*r, na);
+    // (a i|j) = (a i|r) c2(r,j)
+    double* target = direct ? out->data() : full.get();
+    dgemm_("N", "N", na*n1, n2, b2size(), 1.0, half.get(), na*n1, c2.data(), b2size(), 0.0, target, na*n1);
+    if (d) {
+      dgemm_("N", "N", asize(), n1*n2, na, 1.0, d->element_ptr(0, a0), asize(), full.get(), na, 1.0, out->data(), asize());
+    } else if (!direct) {
+      for (size_t ij = 0; ij != n1*n2; ++ij)
+        copy_n(full.get()+na*ij, na, out->data()+a0+asize()*ij);
+    }
+  }
+  return out;
+}
+
+
+shared_ptr<DFBlock> DFBlock::slice_b1(const size_t start, const size_t fence) const {
+  assert(start <= fence && fence <= b1size());
+  const size_t n = fence - start;
+  auto out = make_shared<DFBlock>(adist_shell_, adist_, asize(), n, b2size(), astart_, b1start_, b2start_, averaged_);
+  for (size_t b2 = 0; b2 != b2size(); ++b2)
+    copy_n(data()+asize()*(start+b1size()*b2), asize()*n, out->data()+asize()*n*b2);
+  return out;
+}
+
+
 shared_ptr<DFBlock> DFBlock::transform_second(const MatView cmat, const bool trans) const {
   assert(trans ? cmat.extent(1) : cmat.extent(0) == b1size());
   assert(cmat.range().ordinal().contiguous());
@@ -72,6 +122,35 @@ shared_ptr<DFBlock> DFBlock::transform_second(const MatView cmat, const bool tra
 }
 
 
+shared_ptr<DFBlock> DFBlock::transform_second_single(const MatView cmat) const {
+  assert(cmat.extent(0) == b1size());
+  assert(cmat.range().ordinal().contiguous());
+  assert(b1start_ == 0);
+  const int nocc = cmat.extent(1);
+  auto out = make_shared<DFBlock>(adist_shell_, adist_, asize(), nocc, b2size(), astart_, 0, b2start_, averaged_);
+  if (size() == 0 || nocc == 0)
+    return out;
+
+  const vector<float> c(cmat.data(), cmat.data()+cmat.size());
+  StaticDist dist(b2size(), min<size_t>(b2size(), resources__->max_num_threads()*4));
+  vector<pair<size_t, size_t>> table = dist.atable();
+  TaskQueue<function<void(void)>> tasks(table.size());
+  for (auto& t : table)
+    tasks.emplace_back([this, &c, &out, t, nocc]() {
+      const size_t nin = asize()*b1size();
+      const size_t nout = asize()*nocc;
+      vector<float> in(nin*t.second);
+      vector<float> res(nout*t.second);
+      copy_n(data()+nin*t.first, nin*t.second, in.begin());
+      for (size_t r = 0; r != t.second; ++r)
+        sgemm_("N", "N", asize(), nocc, b1size(), 1.0f, in.data()+nin*r, asize(), c.data(), b1size(), 0.0f, res.data()+nout*r, asize());
+      std::copy(res.begin(), res.end(), out->data()+nout*t.first);
+    });
+  tasks.compute();
+  return out;
+}
+
+
 shared_ptr<DFBlock> DFBlock::transform_third(const MatView cmat, const bool trans) const {
   assert(trans ? cmat.extent(1) : cmat.extent(0) == b2size());
   assert(cmat.range().ordinal().contiguous());
@@ -342,6 +421,33 @@ shared_ptr<Matrix> DFBlock::form_2index(const shared_ptr<const DFBlock> o, const
 }
 
 
+shared_ptr<Matrix> DFBlock::form_2index_single(const shared_ptr<const DFBlock> o, const double a, const size_t maxsize) const {
+  if (asize() != o->asize() || b1size() != o->b1size()) throw logic_error("illegal call of DFBlock::form_2index_single");
+  auto target = make_shared<Matrix>(b2size(), o->b2size());
+  if (asize() == 0 || b1size() == 0)
+    return target;
+
+  // target(r,s) = a * sum_{P,i} (P i|r) (P i|s), in batches of the auxiliary index
+  const bool same = o.get() == this;
+  const size_t nbatch = max<size_t>(1, min(asize(), maxsize/max<size_t>(1, b1size()*max(b2size(), o->b2size()))));
+  vector<float> left(nbatch*b1size()*b2size());
+  vector<float> right(same ? 0 : nbatch*b1size()*o->b2size());
+  vector<float> part(b2size()*o->b2size());
+  for (size_t a0 = 0; a0 < asize(); a0 += nbatch) {
+    const size_t na = min(nbatch, asize()-a0);
+    const size_t k = na*b1size();
+    for (size_t ir = 0; ir != b1size()*b2size(); ++ir)
+      copy_n(data()+a0+asize()*ir, na, left.begin()+na*ir);
+    if (!same)
+      for (size_t is = 0; is != b1size()*o->b2size(); ++is)
+        copy_n(o->data()+a0+asize()*is, na, right.begin()+na*is);
+    sgemm_("T", "N", b2size(), o->b2size(), k, static_cast<float>(a), left.data(), k, same ? left.data() : right.data(), k, 0.0f, part.data(), b2size());
+    transform(part.begin(), part.end(), target->data(), target->data(), [](const float p, const double t) { return t + p; });
+  }
+  return target;
+}
+
+
 shared_ptr<Matrix> DFBlock::form_4index(const shared_ptr<const DFBlock> o, const double a) const {
   if (asize() != o->asize()) throw logic_error("illegal call of DFBlock::form_4index");
   auto target = make_shared<Matrix>(b1size()*b2size(), o->b1size()*o->b2size());
@@ -402,6 +508,14 @@ shared_ptr<Matrix> DFBlock::form_mat(const Tensor1<double>& fit) const {
 }
 
 
+shared_ptr<Matrix> DFBlock::form_mat(const Matrix& fit) const {
+  assert(fit.ndim() == asize());
+  auto out = make_shared<Matrix>(b1size()*b2size(), fit.mdim(), true);
+  contract(1.0, group(*this,1,3), {1,0}, fit, {1,2}, 0.0, *out, {0,2});
+  return out;
+}
+
+
 void DFBlock::contrib_apply_J(const shared_ptr<const DFBlock> o, const shared_ptr<const Matrix> d) {
   if (b1size() != o->b1size() || b2size() != o->b2size()) throw logic_error("illegal call of DFBlock::contrib_apply_J");
   assert(astart_ == 0 && o->astart_ == 0);
@@ -85,6 +85,8 @@ class DFBlock : public btas::Tensor3<double> {
 
     // dist
     const std::shared_ptr<const StaticDist>& adist_now() const { return averaged_ ? adist_ : adist_shell_; }
+    const std::shared_ptr<const StaticDist>& adist_shell() const { return adist_shell_; }
+    const std::shared_ptr<const StaticDist>& adist() const { return adist_; }
 
 
     // some math functions
@@ -119,8 +121,16 @@ class DFBlock : public btas::Tensor3<double> {
     std::shared_ptr<DFBlock> clone() const;
     std::shared_ptr<DFBlock> copy() const;
 
+    // returns a block with b1 in [start, fence)
+    std::shared_ptr<DFBlock> slice_b1(const size_t start, const size_t fence) const;
+
     std::shared_ptr<DFBlock> transform_second(const MatView c, const bool trans = false) const;
+    // the same as transform_second, but the products are computed in single precision (the block is converted in batches of b2)
+    std::shared_ptr<DFBlock> transform_second_single(const MatView c) const;
     std::shared_ptr<DFBlock> transform_third(const MatView c, const bool trans = false) const;
+    // transform_second(c1) followed by transform_third(c2), streamed over batches of the auxiliary index so that at most
+    // maxsize elements of the half-transformed integrals are held at a time. If given, d(P,Q) is applied to the auxiliary index (requires all of them to be local).
+    std::shared_ptr<DFBlock> transform_second_third(const MatView c1, const MatView c2, std::shared_ptr<const Matrix> d = nullptr, const size_t maxsize = 1lu<<24) const;
 
     // add ab^+  to this.
     void add_direct_product(const VecView a, const MatView b, const double fac);
@@ -137,6 +147,8 @@ class DFBlock : public btas::Tensor3<double> {
 
     // Form 2- and 4-index integrals
     std::shared_ptr<Matrix> form_2index(const std::shared_ptr<const DFBlock> o, const double a) const;
+    // the same as form_2index, but with single-precision products that are accumulated in double precision over batches of the auxiliary index
+    std::shared_ptr<Matrix> form_2index_single(const std::shared_ptr<const DFBlock> o, const double a, const size_t maxsize = 1lu<<24) const;
     std::shared_ptr<Matrix> form_4index(const std::shared_ptr<const DFBlock> o, const double a) const;
     // slowest index of o is fixed to n
     std::shared_ptr<Matrix> form_4index_1fixed(const std::shared_ptr<const DFBlock> o, const double a, const size_t n) const;
@@ -146,6 +158,8 @@ class DFBlock : public btas::Tensor3<double> {
 
     std::shared_ptr<VectorB> form_vec(const std::shared_ptr<const Matrix> den) const;
     std::shared_ptr<Matrix> form_mat(const btas::Tensor1<double>& fit) const;
+    // one column (b1*b2) for each column of fit
+    std::shared_ptr<Matrix> form_mat(const Matrix& fit) const;
 
     void contrib_apply_J(const std::shared_ptr<const DFBlock> o, const std::shared_ptr<const Matrix> mat);
 
@@ -44,6 +44,15 @@ shared_ptr<Matrix> ParallelDF::form_2index(shared_ptr<const ParallelDF> o, const
 }
 
 
+shared_ptr<Matrix> ParallelDF::form_2index_single(shared_ptr<const ParallelDF> o, const double a) const {
+  if (block_.size() != 1 || o->block_.size() != 1) throw logic_error("so far assumes block_.size() == 1");
+  shared_ptr<Matrix> out = block_[0]->form_2index_single(o->block_[0], a);
+  if (!serial_)
+    out->allreduce();
+  return out;
+}
+
+
 shared_ptr<Matrix> ParallelDF::form_4index(shared_ptr<const ParallelDF> o, const double a, const bool swap) const {
   if (block_.size() != 1 || o->block_.size() != 1) throw logic_error("so far assumes block_.size() == 1");
   shared_ptr<Matrix> out = (!swap) ? block_[0]->form_4index(o->block_[0], a) : o->block_[0]->form_4index(block_[0], a);
@@ -134,6 +143,28 @@ shared_ptr<Matrix> ParallelDF::compute_Jop_from_cd(shared_ptr<const VectorB> tmp
 }
 
 
+vector<shared_ptr<Matrix>> ParallelDF::compute_Jop_from_cd(const vector<shared_ptr<const VectorB>>& cd) const {
+  if (block_.size() != 1) throw logic_error("compute_Jop so far assumes block_.size() == 1");
+  const size_t astart = block_[0]->astart();
+  const size_t asize = block_[0]->asize();
+  Matrix fit(asize, cd.size(), true);
+  for (int i = 0; i != cd.size(); ++i)
+    copy_n(cd[i]->data()+astart, asize, fit.element_ptr(0, i));
+  shared_ptr<Matrix> all = block_[0]->form_mat(fit);
+  // all reduce
+  if (!serial_)
+    all->allreduce();
+
+  vector<shared_ptr<Matrix>> out;
+  for (int i = 0; i != cd.size(); ++i) {
+    auto mat = make_shared<Matrix>(block_[0]->b1size(), block_[0]->b2size());
+    copy_n(all->element_ptr(0, i), mat->size(), mat->data());
+    out.push_back(mat);
+  }
+  return out;
+}
+
+
 shared_ptr<VectorB> ParallelDF::compute_cd(const shared_ptr<const Matrix> den, shared_ptr<const Matrix> dat2, const int number_of_j) const {
   if (!dat2 && !data2_) throw logic_error("ParallelDF::compute_cd was called without 2-index integrals");
   if (!dat2) dat2 = data2_;
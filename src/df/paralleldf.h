@@ -70,6 +70,8 @@ class ParallelDF : public std::enable_shared_from_this<ParallelDF> {
     void add_block(std::shared_ptr<DFBlock> o);
 
     std::shared_ptr<Matrix> form_2index(std::shared_ptr<const ParallelDF> o, const double a, const bool swap = false) const;
+    // single-precision version of the above (see DFBlock::form_2index_single)
+    std::shared_ptr<Matrix> form_2index_single(std::shared_ptr<const ParallelDF> o, const double a) const;
     std::shared_ptr<Matrix> form_4index(std::shared_ptr<const ParallelDF> o, const double a, const bool swap = false) const;
     std::shared_ptr<Matrix> form_aux_2index(std::shared_ptr<const ParallelDF> o, const double a) const;
 
@@ -90,6 +92,8 @@ class ParallelDF : public std::enable_shared_from_this<ParallelDF> {
     std::shared_ptr<Matrix> compute_Jop(const std::shared_ptr<const Matrix> den) const;
     std::shared_ptr<Matrix> compute_Jop(const std::shared_ptr<const ParallelDF> o, const std::shared_ptr<const Matrix> den, const bool onlyonce = false) const;
     std::shared_ptr<Matrix> compute_Jop_from_cd(std::shared_ptr<const VectorB> cd) const;
+    // J operators for several fitted densities with a single pass over the integrals
+    std::vector<std::shared_ptr<Matrix>> compute_Jop_from_cd(const std::vector<std::shared_ptr<const VectorB>>& cd) const;
     std::shared_ptr<VectorB> compute_cd(const std::shared_ptr<const Matrix> den, std::shared_ptr<const Matrix> dat2 = nullptr, const int number_of_j = 2) const;
 
     void average_3index() {
@@ -40,16 +40,13 @@ shared_ptr<GradFile> GradEval<RHF>::compute() {
 
   //- TWO ELECTRON PART -//
   const bool external_half = static_cast<bool>(task_->half());
-  shared_ptr<const DFHalfDist> half;
+  shared_ptr<const DFFullDist> qij;
   if (external_half) {
-    half = task_->half();
+    qij = task_->half()->compute_second_transform(coeff_occ)->apply_J();
     task_->discard_half();
   } else {
-    half = geom_->df()->compute_half_transform(coeff_occ);
+    qij = geom_->df()->compute_full_transform(coeff_occ, coeff_occ, 2);
   }
-
-  shared_ptr<const DFFullDist> qij = external_half ? half->compute_second_transform(coeff_occ)->apply_J()
-                                                   : half->compute_second_transform(coeff_occ)->apply_JJ();
   shared_ptr<const DFFullDist> qijd = qij->apply_closed_2RDM();
   shared_ptr<const Matrix> qq  = qij->form_aux_2index(qijd, 1.0);
   shared_ptr<const DFHalfDist> qrs_1 = qijd->back_transform(coeff_occ);
@@ -74,8 +71,7 @@ shared_ptr<GradFile> GradEval<UHF>::compute() {
   shared_ptr<const Matrix> erdm1 = task_->compute_erdm1();
 
   //- TWO ELECTRON PART -//
-  shared_ptr<const DFHalfDist> half = geom_->df()->compute_half_transform(coeff_occ);
-  shared_ptr<const DFFullDist> qij  = half->compute_second_transform(coeff_occ)->apply_JJ();
+  shared_ptr<const DFFullDist> qij  = geom_->df()->compute_full_transform(coeff_occ, coeff_occ, 2);
   shared_ptr<const DFFullDist> qijd = qij->apply_uhf_2RDM(*ref_->rdm1(1), *ref_->rdm1(2)); // 1 and 2: alpha and beta
   shared_ptr<const Matrix> qq  = qij->form_aux_2index(qijd, 1.0);
   shared_ptr<const DFDist> qrs = qijd->back_transform(coeff_occ)->back_transform(coeff_occ);
@@ -98,8 +94,7 @@ shared_ptr<GradFile> GradEval<ROHF>::compute() {
   shared_ptr<const Matrix> erdm1 = task_->compute_erdm1();
 
   //- TWO ELECTRON PART -//
-  shared_ptr<const DFHalfDist> half = geom_->df()->compute_half_transform(coeff_occ);
-  shared_ptr<const DFFullDist> qij  = half->compute_second_transform(coeff_occ)->apply_JJ();
+  shared_ptr<const DFFullDist> qij  = geom_->df()->compute_full_transform(coeff_occ, coeff_occ, 2);
   shared_ptr<const DFFullDist> qijd = qij->apply_uhf_2RDM(*ref_->rdm1(1), *ref_->rdm1(2)); // 1 and 2: alpha and beta
   shared_ptr<const Matrix> qq  = qij->form_aux_2index(qijd, 1.0);
   shared_ptr<const DFDist> qrs = qijd->back_transform(coeff_occ)->back_transform(coeff_occ);
@@ -122,8 +117,7 @@ shared_ptr<GradFile> GradEval<KS>::compute() {
   shared_ptr<const Matrix> erdm1 = ref_->coeff()->form_weighted_density_rhf(ref_->nocc(), ref_->eig());
 
   //- TWO ELECTRON PART -//
-  shared_ptr<const DFHalfDist> half = geom_->df()->compute_half_transform(coeff_occ);
-  shared_ptr<const DFFullDist> qij  = half->compute_second_transform(coeff_occ)->apply_JJ();
+  shared_ptr<const DFFullDist> qij  = geom_->df()->compute_full_transform(coeff_occ, coeff_occ, 2);
   // ... exchange needs to be scaled.
   shared_ptr<const DFFullDist> qijd = qij->apply_closed_2RDM(task_->func()->scale_ex());
   shared_ptr<const Matrix> qq  = qij->form_aux_2index(qijd, 1.0);
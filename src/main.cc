@@ -27,6 +27,7 @@
 #include <src/grad/force.h>
 #include <src/grad/hess.h>
 #include <src/opt/optimize.h>
+#include <src/opt/neb.h>
 #include <src/wfn/localization.h>
 #include <src/asd/construct_asd.h>
 #include <src/asd/orbital/construct_asd_orbopt.h>
@@ -142,6 +143,11 @@ int main(int argc, char** argv) {
         auto opt = make_shared<Optimize>(itree, geom, ref);
         opt->compute();
 
+      } else if (title == "neb") {
+
+        auto neb = make_shared<NEB>(itree, geom, ref);
+        neb->compute();
+
       } else if (title == "force" || title == "nacme" || title == "dgrad") {
 
         auto opt = make_shared<Force>(itree, geom, ref);
@@ -56,9 +56,9 @@ Atom::Atom(shared_ptr<const PTree> inp, const bool spherical, const bool angstro
     nbasis_ = 0;
     lmax_ = 0;
   } else {
-    shared_ptr<const PTree> basisset = (basis_ == defbas.first) ? defbas.second : PTree::read_basis(basis_);
     string na = name_;
     na[0] = toupper(na[0]);
+    shared_ptr<const PTree> basisset = (basis_ == defbas.first) ? defbas.second : PTree::read_basis(basis_, {na});
     (!use_ecp_basis_) ? basis_init(basisset->get_child(na)) : basis_init_ECP(basisset->get_child(na));
     if (!use_ecp_basis_ && ecp) {
       ecp_parameters_ = make_shared<const ECP>();
@@ -86,8 +86,8 @@ Atom::Atom(const Atom& old, const bool spherical, const string bas, const pair<s
         if (name_ == key) basis_ = i->data();
       }
     string na = name_;
-    shared_ptr<const PTree> basisset = (basis_ == defbas.first) ? defbas.second : PTree::read_basis(basis_);
     na[0] = toupper(na[0]);
+    shared_ptr<const PTree> basisset = (basis_ == defbas.first) ? defbas.second : PTree::read_basis(basis_, {na});
     (!use_ecp_basis_) ? basis_init(basisset->get_child(na)) : basis_init_ECP(basisset->get_child(na));
   }
 }
@@ -256,7 +256,7 @@ Atom::Atom(const bool sph, const string nm, const array<double,3>& p, const stri
 
   string na = name_;
   na[0] = toupper(na[0]);
-  shared_ptr<const PTree> basisset = (basis_ == defbas.first) ? defbas.second : PTree::read_basis(basis_);
+  shared_ptr<const PTree> basisset = (basis_ == defbas.first) ? defbas.second : PTree::read_basis(basis_, {na});
   if (basis_.find("ecp") != string::npos) use_ecp_basis_ = true;
   (!use_ecp_basis_) ? basis_init(basisset->get_child(na)) : basis_init_ECP(basisset->get_child(na));
 
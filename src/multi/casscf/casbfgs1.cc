@@ -65,6 +65,15 @@ void CASBFGS1::compute() {
       fci_time.tick_print("FCI and RDMs");
     }
 
+    // The active Fock operator is invariant to the rotation among active orbitals and only requires the 1RDM,
+    // so it is built while natural orbitals and Qvec are computed below.
+    future<shared_ptr<const Matrix>> afockao;
+    if (nact_) {
+      auto acoeff = make_shared<const Matrix>(coeff_->slice(nclosed_, nocc_));
+      auto rdm1 = make_shared<const RDM<1>>(*fci_->rdm1_av());
+      afockao = async(stage_policy(), [this, acoeff, rdm1]() -> shared_ptr<const Matrix> { return compute_active_fock(*acoeff, rdm1); });
+    }
+
     shared_ptr<Matrix> natorb_mat = x->clone();
     natorb_mat->unit();
     if (nact_) {
@@ -86,19 +95,18 @@ void CASBFGS1::compute() {
     // * core Fock operator
     shared_ptr<const Matrix> cfockao = nact_ ? fci_->jop()->core_fock() : make_shared<const Fock<1>>(geom_, hcore_, nullptr, ccoeff, /*store*/false, /*rhf*/true);
     shared_ptr<const Matrix> cfock = make_shared<Matrix>(*coeff_ % *cfockao * *coeff_);
+    // * Q_xr = 2(xs|tu)P_rs,tu (x=general, mo)
+    shared_ptr<const Qvec> qxr;
+    if (nact_) {
+      qxr = make_shared<const Qvec>(coeff_->mdim(), nact_, coeff_, nclosed_, fci_, fci_->rdm2_av());
+    }
     // * active Fock operator
     shared_ptr<const Matrix> afock;
     if (nact_) {
-      auto afockao = compute_active_fock(coeff_->slice(nclosed_, nocc_), fci_->rdm1_av());
-      afock = make_shared<Matrix>(*coeff_ % *afockao * *coeff_);
+      afock = make_shared<Matrix>(*coeff_ % *afockao.get() * *coeff_);
     } else {
       afock = cfock->clone();
     }
-    // * Q_xr = 2(xs|tu)P_rs,tu (x=general, mo)
-    shared_ptr<const Qvec> qxr;
-    if (nact_) {
-      qxr = make_shared<const Qvec>(coeff_->mdim(), nact_, coeff_, nclosed_, fci_, fci_->rdm2_av());
-    }
 
     // grad(a/i) (eq.4.3a): 4(cfock_ai+afock_ai)
     grad_vc(cfock, afock, sigma);
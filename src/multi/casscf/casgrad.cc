@@ -98,8 +98,7 @@ shared_ptr<GradFile> GradEval<CASSCF>::compute() {
     shared_ptr<const Matrix> erdm1 = make_shared<Matrix>(ocoeff * f ^ ocoeff);
 
     //- TWO ELECTRON PART -//
-    shared_ptr<const DFHalfDist> half = geom_->df()->compute_half_transform(ocoeff);
-    shared_ptr<const DFFullDist> qij  = half->compute_second_transform(ocoeff)->apply_JJ();
+    shared_ptr<const DFFullDist> qij  = geom_->df()->compute_full_transform(ocoeff, ocoeff, 2);
     shared_ptr<const DFFullDist> qijd = qij->apply_2rdm(*ref_->rdm2(0), *ref_->rdm1(0), nclosed, nact);
     shared_ptr<const Matrix> qq  = qij->form_aux_2index(qijd, 1.0);
     shared_ptr<const DFDist> qrs = qijd->back_transform(ocoeff)->back_transform(ocoeff);
@@ -201,22 +201,29 @@ void CASSCF::one_body_operators(shared_ptr<Matrix>& f, shared_ptr<Matrix>& fact,
 
   shared_ptr<Matrix> finact;
 
-  // get quantity Q_xr = 2(xs|tu)P_rs,tu (x=general)
-  // note: this should be after natorb transformation.
-  auto qxr = make_shared<Qvec>(coeff_->mdim(), nact_, coeff_, nclosed_, fci_, fci_->rdm2_av());
-
+  // the active Fock operator only requires the 1RDM; it is built while Qvec is computed
+  future<shared_ptr<const Matrix>> fact_ao;
   {
-    // Fock operators
     // make a matrix that contains rdm1_av
     auto rdm1mat = make_shared<Matrix>(nact_, nact_);
     copy_n(fci_->rdm1_av()->data(), rdm1mat->size(), rdm1mat->data());
     rdm1mat->sqrt();
     rdm1mat->scale(1.0/sqrt(2.0));
-    auto acoeff = coeff_->slice(nclosed_, nclosed_+nact_);
+    auto acoeff = make_shared<const Matrix>(coeff_->slice(nclosed_, nclosed_+nact_) * *rdm1mat);
+    auto hcore = hcore_->clone();
+    fact_ao = async(stage_policy(), [this, acoeff, hcore]() -> shared_ptr<const Matrix> {
+      return make_shared<Fock<1>>(geom_, hcore, nullptr, *acoeff, false, /*rhf*/true);
+    });
+  }
 
+  // get quantity Q_xr = 2(xs|tu)P_rs,tu (x=general)
+  // note: this should be after natorb transformation.
+  auto qxr = make_shared<Qvec>(coeff_->mdim(), nact_, coeff_, nclosed_, fci_, fci_->rdm2_av());
+
+  {
+    // Fock operators
     finact = make_shared<Matrix>(*coeff_ % *fci_->jop()->core_fock() * *coeff_);
-    auto fact_ao = make_shared<Fock<1>>(geom_, hcore_->clone(), nullptr, acoeff * *rdm1mat, false, /*rhf*/true);
-    f = make_shared<Matrix>(*finact + *coeff_% *fact_ao * *coeff_);
+    f = make_shared<Matrix>(*finact + *coeff_% *fact_ao.get() * *coeff_);
   }
   {
     // active-x Fock operator Dts finact_sx + Qtx
@@ -30,6 +30,7 @@
 #ifndef __BAGEL_CASSCF_CASSCF_H
 #define __BAGEL_CASSCF_CASSCF_H
 
+#include <future>
 #include <src/wfn/reference.h>
 #include <src/util/muffle.h>
 #include <src/ci/fci/knowles.h>
@@ -71,6 +72,10 @@ class CASSCF : public Method, public std::enable_shared_from_this<CASSCF> {
     std::shared_ptr<const Coeff> semi_canonical_orb() const;
     std::shared_ptr<const Matrix> spin_density() const;
 
+    // Independent stages of a macroiteration (e.g., the active Fock build and Qvec) are run concurrently with a single process.
+    // With several processes they are deferred, since each of them involves collective communication that has to be ordered.
+    static std::launch stage_policy() { return mpi__->size() == 1 ? std::launch::async : std::launch::deferred; }
+
     // energy
     std::vector<double> energy_;
     double rms_grad_;
@@ -77,17 +77,20 @@ void CASSecond::compute() {
     // compute denominator...
     shared_ptr<const RotFile> denom = compute_denom(half, half_1j, halfa, cfock, afock);
 
-    AugHess<RotFile> solver(max_micro_iter_, grad);
-    // initial trial vector
-    shared_ptr<RotFile> trot = apply_denom(grad, denom, 0.001, 1.0);
-    trot->normalize();
+    AugHess<RotFile> solver(max_micro_iter_*(block_micro_ ? 3 : 1), grad);
+    // initial trial vector; normalized before splitting, since close to convergence its norm is below the threshold in AugHess::orthog
+    shared_ptr<RotFile> guess = apply_denom(grad, denom, 0.001, 1.0);
+    guess->normalize();
+    vector<shared_ptr<RotFile>> trot = split_trial(guess);
+    solver.orthog(trot);
 
     for (int miter = 0; miter != max_micro_iter_; ++miter) {
       Timer mtimer;
-      shared_ptr<const RotFile> sigma = compute_hess_trial(trot, half, halfa, cfock, afock, qxr);
+      const vector<shared_ptr<const RotFile>> ctrot(trot.begin(), trot.end());
+      const vector<shared_ptr<RotFile>> sigma = compute_hess_trial(ctrot, half, halfa, cfock, afock, qxr);
       shared_ptr<const RotFile> residual;
       double lambda, epsilon, stepsize;
-      tie(residual, lambda, epsilon, stepsize) = solver.compute_residual(trot, sigma);
+      tie(residual, lambda, epsilon, stepsize) = solver.compute_residual(ctrot, vector<shared_ptr<const RotFile>>(sigma.begin(), sigma.end()));
       const double err = residual->norm() / lambda;
       muffle_->unmute();
       if (!miter) cout << endl;
@@ -100,11 +103,10 @@ void CASSecond::compute() {
       if (err < max(thresh_micro_, stepsize*thresh_microstep_))
         break;
 
-      trot = apply_denom(residual, denom, -epsilon, 1.0/lambda);
-      for (int i = 0; i != 10; ++i) {
-        const double norm = solver.orthog(trot);
-        if (norm > 0.25) break;
-      }
+      trot = split_trial(apply_denom(residual, denom, -epsilon, 1.0/lambda));
+      solver.orthog(trot);
+      if (trot.empty())
+        break;
     }
 
     shared_ptr<RotFile> sol = solver.civec();
@@ -154,6 +156,24 @@ shared_ptr<RotFile> CASSecond::apply_denom(shared_ptr<const RotFile> grad, share
 }
 
 
+vector<shared_ptr<RotFile>> CASSecond::split_trial(shared_ptr<const RotFile> trot) const {
+  vector<shared_ptr<RotFile>> out;
+  if (!block_micro_ || !nclosed_) {
+    out.push_back(trot->copy());
+  } else {
+    // each part has its own coefficient in the subspace
+    const int size[3] = {nclosed_*nact_, nvirt_*nact_, nvirt_*nclosed_};
+    const double* source[3] = {trot->ptr_ca(), trot->ptr_va(), trot->ptr_vc()};
+    for (int i = 0; i != 3; ++i) {
+      shared_ptr<RotFile> part = trot->clone();
+      copy_n(source[i], size[i], part->data()+(source[i]-trot->data()));
+      out.push_back(part);
+    }
+  }
+  return out;
+}
+
+
 shared_ptr<RotFile> CASSecond::compute_gradient(shared_ptr<const Matrix> cfock, shared_ptr<const Matrix> afock, shared_ptr<const Matrix> qxr) const {
   auto sigma = make_shared<RotFile>(nclosed_, nact_, nvirt_);
   shared_ptr<const RDM<1>> rdm1 = fci_->rdm1_av();
@@ -282,13 +302,18 @@ shared_ptr<RotFile> CASSecond::compute_denom(shared_ptr<const DFHalfDist> half,
 }
 
 
-shared_ptr<RotFile> CASSecond::compute_hess_trial(shared_ptr<const RotFile> trot, shared_ptr<const DFHalfDist> half, shared_ptr<const DFHalfDist> halfa,
-                                                  shared_ptr<const Matrix> cfock, shared_ptr<const Matrix> afock, shared_ptr<const Matrix> qxr) const {
-  shared_ptr<RotFile> sigma = trot->clone();
-
-  shared_ptr<const Matrix> va = trot->va_mat();
-  shared_ptr<const Matrix> ca = nclosed_ ? trot->ca_mat() : nullptr;
-  shared_ptr<const Matrix> vc = nclosed_ ? trot->vc_mat() : nullptr;
+vector<shared_ptr<RotFile>> CASSecond::compute_hess_trial(const vector<shared_ptr<const RotFile>>& trot, shared_ptr<const DFHalfDist> half,
+                                                          shared_ptr<const DFHalfDist> halfa, shared_ptr<const Matrix> cfock, shared_ptr<const Matrix> afock,
+                                                          shared_ptr<const Matrix> qxr) const {
+  const int ntrial = trot.size();
+  vector<shared_ptr<RotFile>> out;
+  vector<shared_ptr<const Matrix>> vas, cas, vcs;
+  for (auto& t : trot) {
+    out.push_back(t->clone());
+    vas.push_back(t->va_mat());
+    cas.push_back(nclosed_ ? t->ca_mat() : nullptr);
+    vcs.push_back(nclosed_ ? t->vc_mat() : nullptr);
+  }
 
   shared_ptr<const Matrix> fcaa = cfock->get_submatrix(nclosed_, nclosed_, nact_, nact_);
   shared_ptr<const Matrix> faaa = afock->get_submatrix(nclosed_, nclosed_, nact_, nact_);
@@ -310,94 +335,133 @@ shared_ptr<RotFile> CASSecond::compute_hess_trial(shared_ptr<const RotFile> trot
   Matrix rdm1(nact_, nact_);
   copy_n(fci_->rdm1_av()->data(), nact_*nact_, rdm1.data());
 
-  // lambda for computing g(D)
-  auto compute_gd = [&,this](shared_ptr<const DFHalfDist> halft, shared_ptr<const DFHalfDist> halfjj, const MatView pcoeff) {
+  // lambda for the half transformation of all the trial vectors in one pass
+  auto compute_half = [&,this](const vector<Matrix>& tcoeff) {
+    const int nocc = tcoeff.front().mdim();
+    Matrix tall(tcoeff.front().ndim(), nocc*ntrial);
+    for (int n = 0; n != ntrial; ++n)
+      tall.copy_block(0, nocc*n, tall.ndim(), nocc, tcoeff[n]);
+    shared_ptr<const DFHalfDist> halfall = geom_->df()->compute_half_transform(tall);
+    vector<shared_ptr<const DFHalfDist>> halft;
+    for (int n = 0; n != ntrial; ++n)
+      halft.push_back(ntrial == 1 ? halfall : halfall->slice(nocc*n, nocc*(n+1)));
+    return halft;
+  };
+
+  // lambda for computing g(D); the J operators of all the trial vectors are computed in one pass
+  auto compute_gd = [&,this](const vector<shared_ptr<const DFHalfDist>>& halft, shared_ptr<const DFHalfDist> halfjj, const MatView pcoeff) {
     shared_ptr<const Matrix> pcoefft = make_shared<Matrix>(pcoeff)->transpose();
-    shared_ptr<Matrix> gd = geom_->df()->compute_Jop(halft, pcoefft);
-    shared_ptr<Matrix> ex0 = halfjj->form_2index(halft, 1.0);
-    ex0->symmetrize();
-    gd->ax_plus_y(-0.5, ex0);
+    vector<shared_ptr<const VectorB>> cd;
+    for (auto& h : halft)
+      cd.push_back(h->compute_cd(pcoefft, geom_->df()->data2()));
+    vector<shared_ptr<Matrix>> gd = geom_->df()->compute_Jop_from_cd(cd);
+    for (int n = 0; n != ntrial; ++n) {
+      shared_ptr<Matrix> ex0 = halfjj->form_2index(halft[n], 1.0);
+      ex0->symmetrize();
+      gd[n]->ax_plus_y(-0.5, ex0);
+    }
     return gd;
   };
 
   // g(t_vc) operator and g(t_ac) operator
   if (nclosed_) {
-    const Matrix tcoeff = vcoeff * *vc + acoeff * *ca->transpose();
-    auto halft = geom_->df()->compute_half_transform(tcoeff);
-    const Matrix gt = *compute_gd(halft, half, ccoeff);
-    sigma->ax_plus_y_ca(32.0, ccoeff % gt * acoeff);
-    sigma->ax_plus_y_vc(32.0, vcoeff % gt * ccoeff);
-    sigma->ax_plus_y_va(16.0, vcoeff % gt * acoeff * rdm1);
-    sigma->ax_plus_y_ca(-16.0, ccoeff % gt * acoeff * rdm1);
+    vector<Matrix> tcoeff;
+    for (int n = 0; n != ntrial; ++n)
+      tcoeff.push_back(vcoeff * *vcs[n] + acoeff * *cas[n]->transpose());
+    const vector<shared_ptr<Matrix>> gt = compute_gd(compute_half(tcoeff), half, ccoeff);
+    for (int n = 0; n != ntrial; ++n) {
+      out[n]->ax_plus_y_ca(32.0, ccoeff % *gt[n] * acoeff);
+      out[n]->ax_plus_y_vc(32.0, vcoeff % *gt[n] * ccoeff);
+      out[n]->ax_plus_y_va(16.0, vcoeff % *gt[n] * acoeff * rdm1);
+      out[n]->ax_plus_y_ca(-16.0, ccoeff % *gt[n] * acoeff * rdm1);
+    }
   }
   // g(t_va - t_ca)
-  const Matrix tcoeff = nclosed_ ? (vcoeff * *va - ccoeff * *ca) : vcoeff * *va;
-  shared_ptr<const DFHalfDist> halfta = geom_->df()->compute_half_transform(tcoeff);
+  vector<Matrix> tcoeff;
+  for (int n = 0; n != ntrial; ++n)
+    tcoeff.push_back(nclosed_ ? (vcoeff * *vas[n] - ccoeff * *cas[n]) : vcoeff * *vas[n]);
+  const vector<shared_ptr<const DFHalfDist>> halftas = compute_half(tcoeff);
   if (nclosed_) {
-    shared_ptr<DFHalfDist> halftad = halfta->copy();
-    halftad->rotate_occ(make_shared<Matrix>(rdm1));
-    const Matrix gt = *compute_gd(halftad, halfa, acoeff);
-    sigma->ax_plus_y_ca(16.0, ccoeff % gt * acoeff);
-    sigma->ax_plus_y_vc(16.0, vcoeff % gt * ccoeff);
-  }
-  // terms with Qvec
-  {
-    shared_ptr<const Matrix> qaa = qxr->cut(nclosed_, nocc_);
-    sigma->ax_plus_y_va(-2.0, *va ^ *qaa);
-    sigma->ax_plus_y_va(-2.0, *va * *qaa);
-    if (nclosed_) {
-      shared_ptr<const Matrix> qva = qxr->cut(nocc_, nocc_+nvirt_);
-      shared_ptr<const Matrix> qca = qxr->cut(0, nclosed_);
-      sigma->ax_plus_y_vc(-2.0, *va ^ *qca);
-      sigma->ax_plus_y_va(-2.0, *vc * *qca);
-      sigma->ax_plus_y_ca(-2.0, *vc % *qva);
-      sigma->ax_plus_y_vc(-2.0, *qva ^ *ca);
-      sigma->ax_plus_y_ca(-2.0, *ca ^ *qaa);
-      sigma->ax_plus_y_ca(-2.0, *ca * *qaa);
+    vector<shared_ptr<const DFHalfDist>> halftad;
+    for (auto& h : halftas) {
+      shared_ptr<DFHalfDist> tmp = h->copy();
+      tmp->rotate_occ(make_shared<Matrix>(rdm1));
+      halftad.push_back(tmp);
+    }
+    const vector<shared_ptr<Matrix>> gt = compute_gd(halftad, halfa, acoeff);
+    for (int n = 0; n != ntrial; ++n) {
+      out[n]->ax_plus_y_ca(16.0, ccoeff % *gt[n] * acoeff);
+      out[n]->ax_plus_y_vc(16.0, vcoeff % *gt[n] * ccoeff);
     }
-  }
-  // compute Q' and Q''
-  {
-    shared_ptr<const DFFullDist> fullaa = halfa->compute_second_transform(acoeff);
-    shared_ptr<DFFullDist> fullta = halfta->compute_second_transform(acoeff);
-    shared_ptr<const DFFullDist> fulltas = fullta->swap();
-    fullta->ax_plus_y(1.0, fulltas);
-    shared_ptr<const DFFullDist> fullaaD = fullaa->apply_2rdm(*fci_->rdm2_av());
-    shared_ptr<const DFFullDist> fulltaD = fullta->apply_2rdm(*fci_->rdm2_av());
-    shared_ptr<const Matrix> qp  = halfa->form_2index(fulltaD, 1.0);
-    shared_ptr<const Matrix> qpp = halfta->form_2index(fullaaD, 1.0);
-
-    sigma->ax_plus_y_va( 4.0, vcoeff % (*qp + *qpp));
-    if (nclosed_)
-      sigma->ax_plus_y_ca(-4.0, ccoeff % (*qp + *qpp));
   }
 
-  // next 1-electron contribution...
-  {
-    sigma->ax_plus_y_va( 4.0, *fcvv * *va * rdm1);
-    sigma->ax_plus_y_va(-2.0, *va * (rdm1 * *fcaa + *fcaa * rdm1));
-    if (nclosed_) {
-      sigma->ax_plus_y_ca( 8.0, *ca * (*fcaa + *faaa));
-      sigma->ax_plus_y_ca( 8.0, *vc % (*fcva + *fava));
-      sigma->ax_plus_y_vc(-8.0, *vc * (*fccc + *facc));
-      sigma->ax_plus_y_va(-4.0, *vc * (*fcca + *faca));
-      sigma->ax_plus_y_vc(-4.0, *va ^ (*fcca + *faca));
-      sigma->ax_plus_y_ca(-2.0, *ca * (rdm1 * *fcaa + *fcaa * rdm1));
-      sigma->ax_plus_y_vc( 8.0, (*fcvv + *favv) * *vc);
-      sigma->ax_plus_y_ca(-8.0, (*fccc + *facc) * *ca);
-      sigma->ax_plus_y_va( 4.0, (*fcvc + *favc) * *ca);
-      sigma->ax_plus_y_ca( 4.0, (*fcvc + *favc) % *va);
-      sigma->ax_plus_y_vc( 4.0, (*fcva + *fava) ^ *ca);
-      sigma->ax_plus_y_vc( 4.0, (*fcva + *fava) ^ *ca);
-      sigma->ax_plus_y_ca( 4.0, *fccc * *ca * rdm1);
-      sigma->ax_plus_y_ca(-4.0, *fcvc % *va * rdm1);
-      sigma->ax_plus_y_va(-4.0, *fcvc * *ca * rdm1);
-      sigma->ax_plus_y_vc(-2.0, *fcva * rdm1 ^ *ca);
-      sigma->ax_plus_y_vc(-2.0, *va * rdm1 ^ *fcca);
-      sigma->ax_plus_y_ca(-2.0, *vc % *fcva * rdm1);
-      sigma->ax_plus_y_va(-2.0, *vc * *fcca * rdm1);
+  shared_ptr<const DFFullDist> fullaa = halfa->compute_second_transform(acoeff);
+  shared_ptr<const DFFullDist> fullaaD = fullaa->apply_2rdm(*fci_->rdm2_av());
+
+  for (int n = 0; n != ntrial; ++n) {
+    shared_ptr<RotFile> sigma = out[n];
+    shared_ptr<const Matrix> va = vas[n];
+    shared_ptr<const Matrix> ca = cas[n];
+    shared_ptr<const Matrix> vc = vcs[n];
+    shared_ptr<const DFHalfDist> halfta = halftas[n];
+
+    // terms with Qvec
+    {
+      shared_ptr<const Matrix> qaa = qxr->cut(nclosed_, nocc_);
+      sigma->ax_plus_y_va(-2.0, *va ^ *qaa);
+      sigma->ax_plus_y_va(-2.0, *va * *qaa);
+      if (nclosed_) {
+        shared_ptr<const Matrix> qva = qxr->cut(nocc_, nocc_+nvirt_);
+        shared_ptr<const Matrix> qca = qxr->cut(0, nclosed_);
+        sigma->ax_plus_y_vc(-2.0, *va ^ *qca);
+        sigma->ax_plus_y_va(-2.0, *vc * *qca);
+        sigma->ax_plus_y_ca(-2.0, *vc % *qva);
+        sigma->ax_plus_y_vc(-2.0, *qva ^ *ca);
+        sigma->ax_plus_y_ca(-2.0, *ca ^ *qaa);
+        sigma->ax_plus_y_ca(-2.0, *ca * *qaa);
+      }
     }
+    // compute Q' and Q''
+    {
+      shared_ptr<DFFullDist> fullta = halfta->compute_second_transform(acoeff);
+      shared_ptr<const DFFullDist> fulltas = fullta->swap();
+      fullta->ax_plus_y(1.0, fulltas);
+      shared_ptr<const DFFullDist> fulltaD = fullta->apply_2rdm(*fci_->rdm2_av());
+      shared_ptr<const Matrix> qp  = halfa->form_2index(fulltaD, 1.0);
+      shared_ptr<const Matrix> qpp = halfta->form_2index(fullaaD, 1.0);
+
+      sigma->ax_plus_y_va( 4.0, vcoeff % (*qp + *qpp));
+      if (nclosed_)
+        sigma->ax_plus_y_ca(-4.0, ccoeff % (*qp + *qpp));
+    }
+
+    // next 1-electron contribution...
+    {
+      sigma->ax_plus_y_va( 4.0, *fcvv * *va * rdm1);
+      sigma->ax_plus_y_va(-2.0, *va * (rdm1 * *fcaa + *fcaa * rdm1));
+      if (nclosed_) {
+        sigma->ax_plus_y_ca( 8.0, *ca * (*fcaa + *faaa));
+        sigma->ax_plus_y_ca( 8.0, *vc % (*fcva + *fava));
+        sigma->ax_plus_y_vc(-8.0, *vc * (*fccc + *facc));
+        sigma->ax_plus_y_va(-4.0, *vc * (*fcca + *faca));
+        sigma->ax_plus_y_vc(-4.0, *va ^ (*fcca + *faca));
+        sigma->ax_plus_y_ca(-2.0, *ca * (rdm1 * *fcaa + *fcaa * rdm1));
+        sigma->ax_plus_y_vc( 8.0, (*fcvv + *favv) * *vc);
+        sigma->ax_plus_y_ca(-8.0, (*fccc + *facc) * *ca);
+        sigma->ax_plus_y_va( 4.0, (*fcvc + *favc) * *ca);
+        sigma->ax_plus_y_ca( 4.0, (*fcvc + *favc) % *va);
+        sigma->ax_plus_y_vc( 4.0, (*fcva + *fava) ^ *ca);
+        sigma->ax_plus_y_vc( 4.0, (*fcva + *fava) ^ *ca);
+        sigma->ax_plus_y_ca( 4.0, *fccc * *ca * rdm1);
+        sigma->ax_plus_y_ca(-4.0, *fcvc % *va * rdm1);
+        sigma->ax_plus_y_va(-4.0, *fcvc * *ca * rdm1);
+        sigma->ax_plus_y_vc(-2.0, *fcva * rdm1 ^ *ca);
+        sigma->ax_plus_y_vc(-2.0, *va * rdm1 ^ *fcca);
+        sigma->ax_plus_y_ca(-2.0, *vc % *fcva * rdm1);
+        sigma->ax_plus_y_va(-2.0, *vc * *fcca * rdm1);
+      }
+    }
+    sigma->scale(0.5);
   }
-  sigma->scale(0.5);
-  return sigma;
+  return out;
 }
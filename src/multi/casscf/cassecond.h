@@ -37,15 +37,20 @@ class CASSecond : public CASSCF {
   protected:
     // convergence threshold for micro iteration relative to stepsize
     double thresh_microstep_;
+    // if true, the closed-active, active-virtual, and closed-virtual parts of a trial vector are added to the subspace separately
+    bool block_micro_;
 
     // compute orbital gradient
     std::shared_ptr<RotFile> compute_gradient(std::shared_ptr<const Matrix> cfock, std::shared_ptr<const Matrix> afock, std::shared_ptr<const Matrix> qxr) const;
     // compute exact diagonal Hessian
     std::shared_ptr<RotFile> compute_denom(std::shared_ptr<const DFHalfDist> half, std::shared_ptr<const DFHalfDist> half_1j, std::shared_ptr<const DFHalfDist> halfa,
                                            std::shared_ptr<const Matrix> cfock, std::shared_ptr<const Matrix> afock) const;
-    // compute H*t (Hessian times trial vector)
-    std::shared_ptr<RotFile> compute_hess_trial(std::shared_ptr<const RotFile> trot, std::shared_ptr<const DFHalfDist> half, std::shared_ptr<const DFHalfDist> halfa,
-                                                std::shared_ptr<const Matrix> cfock, std::shared_ptr<const Matrix> afock, std::shared_ptr<const Matrix> qxr) const;
+    // compute H*t (Hessian times trial vector) for a block of trial vectors with one pass over the DF integrals
+    std::vector<std::shared_ptr<RotFile>> compute_hess_trial(const std::vector<std::shared_ptr<const RotFile>>& trot, std::shared_ptr<const DFHalfDist> half,
+                                                             std::shared_ptr<const DFHalfDist> halfa, std::shared_ptr<const Matrix> cfock, std::shared_ptr<const Matrix> afock,
+                                                             std::shared_ptr<const Matrix> qxr) const;
+    // returns a block of new trial vectors
+    std::vector<std::shared_ptr<RotFile>> split_trial(std::shared_ptr<const RotFile> trot) const;
     // apply denominator in microiterations
     std::shared_ptr<RotFile> apply_denom(std::shared_ptr<const RotFile> grad, std::shared_ptr<const RotFile> denom, const double shift, const double scale) const;
 
@@ -56,6 +61,7 @@ class CASSecond : public CASSCF {
       // overwriting thresh_micro
       thresh_micro_ = idata_->get<double>("thresh_micro", thresh_*0.5);
       thresh_microstep_ = idata_->get<double>("thresh_microstep", 1.0e-4);
+      block_micro_ = idata_->get<bool>("block_micro", true);
     }
 
     void compute() override;
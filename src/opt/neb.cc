@@ -0,0 +1,344 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: neb.cc
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <tuple>
+#include <iomanip>
+#include <algorithm>
+#include <src/opt/neb.h>
+#include <src/grad/gradeval.h>
+#include <src/wfn/construct_method.h>
+#include <src/util/muffle.h>
+#include <src/util/parallel/staticdist.h>
+
+using namespace std;
+using namespace bagel;
+
+namespace {
+
+using GradResult = tuple<shared_ptr<const Matrix>, double, shared_ptr<const Reference>>;
+
+template<typename T>
+GradResult gradeval(shared_ptr<const PTree> cinput, shared_ptr<const Geometry> geom, shared_ptr<const Reference> ref, const int target) {
+  GradEval<T> eval(cinput, geom, ref, target);
+  shared_ptr<const Matrix> grad = eval.compute();
+  return make_tuple(grad, eval.energy(), eval.ref());
+}
+
+GradResult compute_gradient(const string method, shared_ptr<const PTree> cinput, shared_ptr<const Geometry> geom, shared_ptr<const Reference> ref, const int target) {
+  if (method == "uhf")
+    return gradeval<UHF>(cinput, geom, ref, target);
+  else if (method == "rohf")
+    return gradeval<ROHF>(cinput, geom, ref, target);
+  else if (method == "hf")
+    return gradeval<RHF>(cinput, geom, ref, target);
+  else if (method == "ks")
+    return gradeval<KS>(cinput, geom, ref, target);
+  else if (method == "dhf")
+    return gradeval<Dirac>(cinput, geom, ref, target);
+  else if (method == "mp2")
+    return gradeval<MP2Grad>(cinput, geom, ref, target);
+  else if (method == "casscf")
+    return gradeval<CASSCF>(cinput, geom, ref, target);
+  else if (method == "caspt2")
+    return gradeval<CASPT2Grad>(cinput, geom, ref, target);
+  throw runtime_error("analytical gradients are not available for " + method + " (neb)");
+}
+
+double max_abs(const Matrix& o) {
+  double out = 0.0;
+  for (size_t i = 0; i != o.size(); ++i)
+    out = max(out, fabs(o.data()[i]));
+  return out;
+}
+
+}
+
+
+NEB::NEB(shared_ptr<const PTree> idata, shared_ptr<const Geometry> geom, shared_ptr<const Reference> ref)
+  : idata_(idata), input_(idata->get_child("method")), geom_(geom), ref_(ref) {
+
+  if (!geom_)
+    throw runtime_error("molecule block is missing");
+  if (geom_->dkh())
+    throw runtime_error("Analytical gradients have not been implemented with the DKH Hamiltonian yet");
+
+  algorithm_ = to_lower(idata->get<string>("algorithm", "neb"));
+  if (algorithm_ != "neb" && algorithm_ != "string")
+    throw runtime_error("Reaction path algorithm should be \"neb\" or \"string\"");
+
+  nimage_ = idata->get<int>("nimage", 10);
+  if (nimage_ < 3)
+    throw runtime_error("at least three images are needed for reaction path optimization");
+  ngroup_ = min(idata->get<int>("ngroup", mpi__->size()), nimage_-2);
+  if (ngroup_ < 1 || ngroup_ > mpi__->size())
+    throw runtime_error("ngroup should be between 1 and the number of processes");
+
+  maxiter_ = idata->get<int>("maxiter", 100);
+  target_state_ = idata->get<int>("target", 0);
+  spring_ = idata->get<double>("spring", 0.1);
+  timestep_ = idata->get<double>("timestep", 1.0);
+  maxstep_ = idata->get<double>("maxstep", 0.1);
+  thresh_grad_ = idata->get<double>("maxgrad", 0.0005);
+  climbing_ = algorithm_ == "neb" && idata->get<bool>("climbing", true);
+  thresh_climbing_ = idata->get<double>("thresh_climbing", 0.005);
+  scratch_ = idata->get<bool>("scratch", false);
+
+  // product geometry in the same format as the molecule block
+  auto product = make_shared<const Geometry>(*geom_, idata->get_child("product"));
+  if (product->natom() != geom_->natom())
+    throw runtime_error("the reactant and product should have the same atoms");
+
+  // initial path by linear interpolation in Cartesian coordinates
+  auto reactant = make_shared<Matrix>(*geom_->xyz());
+  auto diff = make_shared<Matrix>(*product->xyz() - *reactant);
+  for (int i = 0; i != nimage_; ++i)
+    images_.push_back(make_shared<const Matrix>(*reactant + *diff * (static_cast<double>(i)/(nimage_-1))));
+
+  energy_.resize(nimage_, 0.0);
+  grad_.resize(nimage_);
+  refs_.resize(nimage_);
+}
+
+
+void NEB::evaluate(const bool endpoints) {
+  const int natom = geom_->natom();
+  const size_t unit = 1 + 3*natom;
+  vector<double> buf(nimage_*unit, 0.0);
+
+  // contiguous blocks of the interior images so that each group keeps the same images over iterations
+  StaticDist dist(nimage_-2, ngroup_);
+  vector<vector<int>> blocks(ngroup_);
+  for (int g = 0; g != ngroup_; ++g)
+    for (size_t i = dist.start(g); i != dist.start(g)+dist.size(g); ++i)
+      blocks[g].push_back(i+1);
+  if (endpoints) {
+    blocks.front().insert(blocks.front().begin(), 0);
+    blocks.back().push_back(nimage_-1);
+  }
+
+  mpi__->split(ngroup_);
+  const vector<int>& block = blocks[mpi__->group()];
+  for (auto iter = block.begin(); iter != block.end(); ++iter) {
+    const int i = *iter;
+    Muffle muffle("neb_image" + to_string(i) + ".log", /*append*/true);
+
+    auto displ = make_shared<Matrix>(*images_[i] - *geom_->xyz());
+    shared_ptr<const Geometry> current = make_shared<const Geometry>(*geom_, displ, make_shared<const PTree>(), /*rotate*/false);
+
+    // the reference of the previous iteration, or the one of the neighbour that has just been computed
+    shared_ptr<const Reference> prev = refs_[i];
+    if (!prev && iter != block.begin())
+      prev = refs_[*(iter-1)];
+    if (!prev)
+      prev = ref_;
+
+    shared_ptr<PTree> cinput;
+    shared_ptr<const Reference> ref;
+    if (!prev || scratch_) {
+      auto m = input_->begin();
+      for ( ; m != --input_->end(); ++m) {
+        const string title = to_lower((*m)->get<string>("title", ""));
+        if (title != "molecule") {
+          shared_ptr<Method> c = construct_method(title, *m, current, ref);
+          if (!c) throw runtime_error("unknown method in reaction path optimization");
+          c->compute();
+          ref = c->conv_to_ref();
+        } else {
+          current = make_shared<const Geometry>(*current, *m);
+          if (ref) ref = ref->project_coeff(current);
+        }
+      }
+      cinput = make_shared<PTree>(**m);
+    } else {
+      ref = prev->project_coeff(current);
+      cinput = make_shared<PTree>(**input_->rbegin());
+    }
+    cinput->put("gradient", true);
+    const string method = to_lower(cinput->get<string>("title", ""));
+
+    shared_ptr<const Matrix> grad;
+    double energy;
+    tie(grad, energy, refs_[i]) = compute_gradient(method, cinput, current, ref, target_state_);
+    if (mpi__->rank() == 0) {
+      buf[i*unit] = energy;
+      copy_n(grad->data(), 3*natom, buf.data()+i*unit+1);
+    }
+  }
+  mpi__->merge();
+
+  // every process receives the energies and gradients of all of the images
+  mpi__->allreduce(buf.data(), buf.size());
+  for (int i = endpoints ? 0 : 1; i != (endpoints ? nimage_ : nimage_-1); ++i) {
+    energy_[i] = buf[i*unit];
+    auto grad = make_shared<Matrix>(3, natom);
+    copy_n(buf.data()+i*unit+1, 3*natom, grad->data());
+    grad_[i] = grad;
+  }
+}
+
+
+shared_ptr<Matrix> NEB::tangent(const int i) const {
+  auto tp = make_shared<Matrix>(*images_[i+1] - *images_[i]);
+  auto tm = make_shared<Matrix>(*images_[i] - *images_[i-1]);
+  const double ep = energy_[i+1] - energy_[i];
+  const double em = energy_[i] - energy_[i-1];
+
+  shared_ptr<Matrix> out;
+  if (ep > 0.0 && em > 0.0) {
+    out = tp;
+  } else if (ep < 0.0 && em < 0.0) {
+    out = tm;
+  } else {
+    // at extrema the two are mixed so that the tangent changes smoothly
+    const double dmax = max(fabs(ep), fabs(em));
+    const double dmin = min(fabs(ep), fabs(em));
+    if (energy_[i+1] > energy_[i-1])
+      out = make_shared<Matrix>(*tp * dmax + *tm * dmin);
+    else
+      out = make_shared<Matrix>(*tp * dmin + *tm * dmax);
+  }
+  const double norm = out->norm();
+  if (norm < 1.0e-10)
+    throw runtime_error("two neighbouring images coincide in reaction path optimization");
+  out->scale(1.0/norm);
+  return out;
+}
+
+
+void NEB::reparametrize() {
+  vector<double> arc(nimage_, 0.0);
+  for (int i = 1; i != nimage_; ++i)
+    arc[i] = arc[i-1] + (*images_[i] - *images_[i-1]).norm();
+
+  vector<shared_ptr<const Matrix>> out = images_;
+  int j = 0;
+  for (int i = 1; i != nimage_-1; ++i) {
+    const double s = arc.back() * i / (nimage_-1);
+    while (j < nimage_-2 && arc[j+1] < s) ++j;
+    const double t = (s - arc[j]) / max(arc[j+1] - arc[j], 1.0e-10);
+    out[i] = make_shared<const Matrix>(*images_[j] * (1.0-t) + *images_[j+1] * t);
+  }
+  images_ = out;
+}
+
+
+void NEB::compute() {
+  const int natom = geom_->natom();
+
+  cout << endl << "  *** " << (algorithm_ == "neb" ? "Nudged elastic band" : "String method") << " optimization started ***" << endl << endl;
+  cout << "    * " << nimage_ << " images computed on " << ngroup_ << " process group" << (ngroup_ > 1 ? "s" : "") << endl;
+  cout << "    * output of each image is written to neb_image#.log" << endl << endl;
+  cout << "     iter         barrier             max force       time" << endl << endl;
+
+  vector<shared_ptr<Matrix>> velocity(nimage_);
+  for (int i = 1; i != nimage_-1; ++i)
+    velocity[i] = make_shared<Matrix>(3, natom);
+
+  bool climb = false;
+  for (int iter = 0; iter != maxiter_; ++iter) {
+    // the end points are computed only once
+    evaluate(iter == 0);
+
+    const int top = max_element(energy_.begin()+1, energy_.end()-1) - energy_.begin();
+    vector<shared_ptr<Matrix>> force(nimage_);
+    double maxforce = 0.0;
+    for (int i = 1; i != nimage_-1; ++i) {
+      shared_ptr<const Matrix> tau = tangent(i);
+      const double gt = grad_[i]->dot_product(*tau);
+      force[i] = grad_[i]->copy();
+      force[i]->scale(-1.0);
+      if (climb && i == top) {
+        // the climbing image moves uphill along the path
+        force[i]->ax_plus_y(2.0*gt, *tau);
+      } else {
+        force[i]->ax_plus_y(gt, *tau);
+        if (algorithm_ == "neb") {
+          const double dp = (*images_[i+1] - *images_[i]).norm();
+          const double dm = (*images_[i] - *images_[i-1]).norm();
+          force[i]->ax_plus_y(spring_*(dp-dm), *tau);
+        }
+      }
+      maxforce = max(maxforce, max_abs(*force[i]));
+    }
+
+    cout << setw(7) << iter << setw(20) << setprecision(8) << fixed << energy_[top] - energy_[0]
+                            << setw(20) << setprecision(8) << fixed << maxforce
+                            << setw(12) << setprecision(2) << fixed << timer_.tick() << endl;
+
+    if (maxforce < thresh_grad_ && (!climbing_ || climb))
+      break;
+    if (climbing_ && !climb && maxforce < thresh_climbing_) {
+      climb = true;
+      for (int i = 1; i != nimage_-1; ++i)
+        velocity[i]->zero();
+      cout << "    * climbing image (" << top << ") switched on" << endl;
+    }
+
+    // projected velocity Verlet (quick-min) on the whole band
+    double vf = 0.0;
+    double ff = 0.0;
+    for (int i = 1; i != nimage_-1; ++i) {
+      vf += velocity[i]->dot_product(*force[i]);
+      ff += force[i]->dot_product(*force[i]);
+    }
+    for (int i = 1; i != nimage_-1; ++i) {
+      if (vf > 0.0)
+        *velocity[i] = *force[i] * (vf/ff);
+      else
+        velocity[i]->zero();
+      velocity[i]->ax_plus_y(timestep_, *force[i]);
+
+      auto step = make_shared<Matrix>(*velocity[i] * timestep_);
+      const double mstep = max_abs(*step);
+      if (mstep > maxstep_)
+        step->scale(maxstep_/mstep);
+      images_[i] = make_shared<const Matrix>(*images_[i] + *step);
+    }
+    if (algorithm_ == "string")
+      reparametrize();
+  }
+
+  print_path();
+}
+
+
+void NEB::print_path() const {
+  cout << endl << "  === Reaction path ===" << endl << endl;
+  cout << "    image     arc length            energy       relative (kJ/mol)" << endl;
+  double arc = 0.0;
+  for (int i = 0; i != nimage_; ++i) {
+    if (i)
+      arc += (*images_[i] - *images_[i-1]).norm();
+    cout << setw(9) << i << setw(15) << setprecision(6) << fixed << arc
+                         << setw(18) << setprecision(8) << fixed << energy_[i]
+                         << setw(16) << setprecision(4) << fixed << (energy_[i] - energy_[0]) * au2kjmol__ << endl;
+  }
+  cout << endl;
+
+  for (int i = 0; i != nimage_; ++i) {
+    cout << "  * image " << i << endl;
+    auto displ = make_shared<Matrix>(*images_[i] - *geom_->xyz());
+    Geometry(*geom_, displ, make_shared<const PTree>(), /*rotate*/false, /*nodf*/true).print_atoms();
+  }
+}
@@ -0,0 +1,89 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: neb.h
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __SRC_OPT_NEB_H
+#define __SRC_OPT_NEB_H
+
+#include <src/wfn/reference.h>
+#include <src/util/timer.h>
+
+namespace bagel {
+
+/// Reaction path optimization by the nudged elastic band (climbing image) or the string method.
+/** The path is represented by images in Cartesian coordinates; the first and last ones are the reactant
+    (the current geometry) and the product (given in the "product" block) and are kept fixed. In each iteration the
+    processes are split into groups, each of which computes the gradients of a contiguous block of images sequentially,
+    starting from the reference of the same image in the previous iteration or from that of its neighbour.
+    The forces on the band are then assembled on all processes and the images are moved by projected velocity Verlet. */
+class NEB {
+  protected:
+    const std::shared_ptr<const PTree> idata_;
+    std::shared_ptr<const PTree> input_;
+    std::shared_ptr<const Geometry> geom_;
+    std::shared_ptr<const Reference> ref_;
+
+    // "neb" or "string"
+    std::string algorithm_;
+    int nimage_;
+    int ngroup_;
+    int maxiter_;
+    int target_state_;
+    double spring_;
+    double timestep_;
+    double maxstep_;
+    double thresh_grad_;
+    bool climbing_;
+    double thresh_climbing_;
+    bool scratch_;
+
+    Timer timer_;
+
+    // Cartesian coordinates (3 x natom) of the images
+    std::vector<std::shared_ptr<const Matrix>> images_;
+    std::vector<double> energy_;
+    std::vector<std::shared_ptr<const Matrix>> grad_;
+    // references of the images that have been computed by the group this process belongs to
+    std::vector<std::shared_ptr<const Reference>> refs_;
+
+    // computes the energies and gradients of the interior images (and the end points if requested) concurrently over process groups
+    void evaluate(const bool endpoints);
+    // normalized tangent at image i (Henkelman and Jonsson, J. Chem. Phys. 113, 9978 (2000))
+    std::shared_ptr<Matrix> tangent(const int i) const;
+    // redistributes the interior images at equal arc length along the path (string method)
+    void reparametrize();
+
+    void print_path() const;
+
+  public:
+    NEB(std::shared_ptr<const PTree> idata, std::shared_ptr<const Geometry> geom, std::shared_ptr<const Reference> ref);
+
+    void compute();
+
+    const std::vector<double>& energies() const { return energy_; }
+    const std::vector<std::shared_ptr<const Matrix>>& images() const { return images_; }
+};
+
+}
+
+#endif
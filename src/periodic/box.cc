@@ -37,7 +37,6 @@ using namespace bagel;
 using namespace std;
 
 static const double pisq__ = pi__ * pi__;
-const static Legendre plm;
 
 void Box::init() {
 
@@ -224,8 +223,7 @@ void Box::compute_M2M(shared_ptr<const Matrix> density) {
       r12[0] = c->centre(0) - centre_[0];
       r12[1] = c->centre(1) - centre_[1];
       r12[2] = c->centre(2) - centre_[2];
-      vector<complex<double>> smoment = shift_multipoles(c->multipole(), r12);
-      blas::ax_plus_y_n(1.0, smoment.data(), nmult_, multipole_.data());
+      translation_->M2M(r12, c->multipole().data(), multipole_.data());
     }
   }
 }
@@ -239,8 +237,7 @@ void Box::compute_L2L() {
     r12[0] = centre_[0] - parent_->centre(0);
     r12[1] = centre_[1] - parent_->centre(1);
     r12[2] = centre_[2] - parent_->centre(2);
-    vector<complex<double>> slocal = shift_localL(parent_->localJ(), r12);
-    blas::ax_plus_y_n(1.0, slocal.data(), nmult_, localJ_.data());
+    translation_->L2L(r12, parent_->localJ().data(), localJ_.data());
   }
 }
 
@@ -253,8 +250,7 @@ void Box::compute_M2L() {
     r12[0] = centre_[0] - it->centre(0);
     r12[1] = centre_[1] - it->centre(1);
     r12[2] = centre_[2] - it->centre(2);
-    vector<complex<double>> slocal = shift_localM(it->multipole(), r12);
-    blas::ax_plus_y_n(1.0, slocal.data(), nmult_, localJ_.data());
+    translation_->M2L(r12, it->multipole().data(), localJ_.data());
   }
 }
 
@@ -426,123 +422,6 @@ void Box::print_box() const {
 }
 
 
-// M2L: given O(a) and R(a-b) get M(b)
-vector<complex<double>> Box::shift_localM(vector<complex<double>> olm, array<double, 3> r12) const {
-
-  const double r = sqrt(r12[0]*r12[0] + r12[1]*r12[1] + r12[2]*r12[2]);
-  const double ctheta = (r > numerical_zero__) ? r12[2]/r : 0.0;
-  const double phi = atan2(r12[1], r12[0]);
-
-  vector<complex<double>> mb(nmult_, 0);
-
-  for (int l = 0; l <= lmax_; ++l) {
-    for (int m = 0; m <= 2 * l; ++m) {
-
-      for (int j = 0; j <= lmax_; ++j) {
-        for (int k = 0; k <= 2 * j; ++k) {
-
-          const int a = l + j;
-          const int b = m - l + k - j;
-
-          double prefactor = plm.compute(a, abs(b), ctheta) / pow(r, a + 1);
-          double ft = 1.0;
-          for (int i = 1; i <= a - abs(b); ++i) {
-            prefactor *= ft;
-            ++ft;
-          }
-          const double real = (b >= 0) ? (prefactor * cos(abs(b) * phi)) : (pow(-1.0, b) * prefactor * cos(abs(b) * phi));
-          const double imag = (b >= 0) ? (prefactor * sin(abs(b) * phi)) : (pow(-1.0, b+1) * prefactor * sin(abs(b) * phi));
-          const complex<double> Mab(real, imag);
-          mb[l*l+m] += pow(-1.0, l) * Mab * olm[j*j+k];
-        }
-      }
-    }
-  }
-
-  return mb;
-}
-
-
-// M2M: given O(a) and R(b-a) get O(b)
-vector<complex<double>> Box::shift_multipoles(vector<complex<double>> oa, array<double, 3> rab) const {
-
-  const double r = sqrt(rab[0]*rab[0] + rab[1]*rab[1] + rab[2]*rab[2]);
-  const double ctheta = (r > numerical_zero__) ? rab[2]/r : 0.0;
-  const double phi = atan2(rab[1], rab[0]);
-
-  vector<complex<double>> ob(nmult_, 0);
-
-  for (int l = 0; l <= lmax_; ++l) {
-    for (int m = 0; m <= 2 * l; ++m) {
-
-      for (int j = 0; j <= lmax_; ++j) {
-        for (int k = 0; k <= 2 * j; ++k) {
-
-          const int a = l - j;
-          const int b = m - l - k + j;
-          if (abs(b) <= a && a >= 0) {
-            double prefactor = pow(r, a) * plm.compute(a, abs(b), ctheta);
-            double ft = 1.0;
-            for (int i = 1; i <= a + abs(b); ++i) {
-              prefactor /= ft;
-              ++ft;
-            }
-            const double real = (b >= 0) ? (prefactor * cos(abs(b) * phi)) : (pow(-1.0, b) * prefactor * cos(abs(b) * phi));
-            const double imag = (b >= 0) ? (prefactor * sin(abs(b) * phi)) : (pow(-1.0, b+1) * prefactor * sin(abs(b) * phi));
-            const complex<double> Oab(real, -imag);
-
-            ob[l*l+m] += Oab * oa[j*j+k];
-          }
-
-        }
-      }
-    }
-  }
-
-  return ob;
-}
-
-
-// L2L: given M(r) and R(b) get M(r-b)
-vector<complex<double>> Box::shift_localL(vector<complex<double>> mr, array<double, 3> rb) const {
-
-  const double r = sqrt(rb[0]*rb[0] + rb[1]*rb[1] + rb[2]*rb[2]);
-  const double ctheta = (r > numerical_zero__) ? rb[2]/r : 0.0;
-  const double phi = atan2(rb[1], rb[0]);
-
-  vector<complex<double>> mrb(nmult_, 0);
-
-  for (int l = 0; l <= lmax_; ++l) {
-    for (int m = 0; m <= 2 * l; ++m) {
-
-      for (int j = 0; j <= lmax_; ++j) {
-        for (int k = 0; k <= 2 * j; ++k) {
-
-          const int a = j - l;
-          const int b = k - j - m + l;
-          if (abs(b) <= a && a >= 0) {
-            double prefactor = pow(r, a) * plm.compute(a, abs(b), ctheta);
-            double ft = 1.0;
-            for (int i = 1; i <= a + abs(b); ++i) {
-              prefactor /= ft;
-              ++ft;
-            }
-            const double real = (b >= 0) ? (prefactor * cos(abs(b) * phi)) : (pow(-1.0, b) * prefactor * cos(abs(b) * phi));
-            const double imag = (b >= 0) ? (prefactor * sin(abs(b) * phi)) : (pow(-1.0, b+1) * prefactor * sin(abs(b) * phi));
-            const complex<double> Oab(real, -imag);
-
-            mrb[l*l+m] += Oab * mr[j*j+k];
-          }
-
-        }
-      }
-    }
-  }
-
-  return mrb;
-}
-
-
 shared_ptr<const ZMatrix> Box::compute_Fock_ff(shared_ptr<const Matrix> density) const {
 
   assert(nchild() == 0);
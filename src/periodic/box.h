@@ -30,6 +30,7 @@
 #include <src/util/constants.h>
 #include <src/molecule/shellpair.h>
 #include <src/util/parallel/resources.h>
+#include <src/periodic/fmmtranslation.h>
 
 namespace bagel {
 
@@ -61,11 +62,10 @@ class Box {
     std::vector<std::complex<double>> multipole_;
     std::vector<std::complex<double>> localJ_;
     std::vector<int> offset0_, offset1_;
+    // translation operators shared by all of the boxes (set by FMM)
+    std::shared_ptr<const FMMTranslation> translation_;
     void compute_M2M(std::shared_ptr<const Matrix> density);
     void sort_sp();
-    std::vector<std::complex<double>> shift_multipoles(std::vector<std::complex<double>> oa, std::array<double, 3> rab) const;
-    std::vector<std::complex<double>> shift_localL(std::vector<std::complex<double>> mr, std::array<double, 3> rb) const;
-    std::vector<std::complex<double>> shift_localM(std::vector<std::complex<double>> olm, std::array<double, 3> r12) const;
     void compute_M2L();
     void compute_L2L();
     double compute_exact_energy_ff(std::shared_ptr<const Matrix> density) const; //debug
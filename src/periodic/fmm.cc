@@ -211,8 +211,11 @@ void FMM::get_boxes() {
   assert(accumulate(nbranch_.begin(), nbranch_.end(), 0) == nbox);
   nbox_ = nbox;
 
-  for (auto& b : box_)
+  auto translation = make_shared<const FMMTranslation>(lmax_);
+  for (auto& b : box_) {
+    b->translation_ = translation;
     b->init();
+  }
 
   int icnt = 0;
   for (int ir = ns_; ir > -1; --ir) {
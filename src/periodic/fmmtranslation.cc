@@ -0,0 +1,192 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: fmmtranslation.cc
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+
+#include <cmath>
+#include <stdexcept>
+#include <src/util/f77.h>
+#include <src/util/constants.h>
+#include <src/periodic/fmmtranslation.h>
+
+using namespace std;
+using namespace bagel;
+
+FMMTranslation::FMMTranslation(const int lmax) : lmax_(lmax), nmult_((lmax+1)*(lmax+1)) {
+
+  factorial_.resize(2*lmax_+2);
+  factorial_[0] = 1.0;
+  for (int i = 1; i != 2*lmax_+2; ++i)
+    factorial_[i] = factorial_[i-1] * i;
+
+  norm_.resize(nmult_);
+  for (int l = 0; l <= lmax_; ++l)
+    for (int m = -l; m <= l; ++m)
+      norm_[l*l+l+m] = 1.0 / sqrt(factorial_[l+m] * factorial_[l-m]);
+
+  // J_y = (J_+ - J_-)/2i is diagonalized for each l
+  jyvec_.resize(lmax_+1);
+  for (int l = 0; l <= lmax_; ++l) {
+    const int n = 2*l+1;
+    vector<complex<double>> jy(n*n, 0.0);
+    for (int m = -l; m < l; ++m) {
+      // <m+1|J_y|m> = sqrt((l-m)(l+m+1))/2i
+      const double e = 0.5 * sqrt(static_cast<double>((l-m)*(l+m+1)));
+      jy[(m+1+l) + n*(m+l)] = complex<double>(0.0, -e);
+      jy[(m+l) + n*(m+1+l)] = complex<double>(0.0, e);
+    }
+    vector<double> eig(n);
+    const int lwork = max(1, 2*n-1);
+    vector<complex<double>> work(lwork);
+    vector<double> rwork(max(1, 3*n-2));
+    int info;
+    zheev_("V", "U", n, jy.data(), n, eig.data(), work.data(), lwork, rwork.data(), info);
+    if (info)
+      throw runtime_error("zheev failed in FMMTranslation");
+    jyvec_[l] = jy;
+  }
+}
+
+
+array<double,3> FMMTranslation::spherical(const array<double,3>& r) {
+  const double rr = sqrt(r[0]*r[0] + r[1]*r[1] + r[2]*r[2]);
+  const double theta = rr > numerical_zero__ ? atan2(sqrt(r[0]*r[0] + r[1]*r[1]), r[2]) : 0.0;
+  const double phi = atan2(r[1], r[0]);
+  return {{rr, theta, phi}};
+}
+
+
+void FMMTranslation::rotate_z(const double phi, const int sign, complex<double>* v) const {
+  for (int l = 0; l <= lmax_; ++l)
+    for (int m = -l; m <= l; ++m)
+      v[l*l+l+m] *= polar(1.0, -sign*m*phi);
+}
+
+
+void FMMTranslation::rotate_y(const double beta, const bool regular, complex<double>* v) const {
+  vector<complex<double>> work(2*lmax_+1);
+  for (int l = 1; l <= lmax_; ++l) {
+    const int n = 2*l+1;
+    complex<double>* vl = v + l*l;
+    const double* nl = norm_.data() + l*l;
+    const complex<double>* vec = jyvec_[l].data();
+
+    for (int i = 0; i != n; ++i)
+      vl[i] = regular ? vl[i] / nl[i] : vl[i] * nl[i];
+    // V^+ v, multiplied by exp(-i beta k) with k = -l..l, and then back with V
+    for (int k = 0; k != n; ++k) {
+      complex<double> sum = 0.0;
+      for (int i = 0; i != n; ++i)
+        sum += conj(vec[i+n*k]) * vl[i];
+      work[k] = sum * polar(1.0, -beta*(k-l));
+    }
+    for (int i = 0; i != n; ++i) {
+      complex<double> sum = 0.0;
+      for (int k = 0; k != n; ++k)
+        sum += vec[i+n*k] * work[k];
+      vl[i] = regular ? sum * nl[i] : sum / nl[i];
+    }
+  }
+}
+
+
+void FMMTranslation::M2M(const array<double,3>& r, const complex<double>* in, complex<double>* out) const {
+  const array<double,3> p = spherical(r);
+
+  vector<complex<double>> v(in, in+nmult_);
+  rotate_z(p[2], -1, v.data());
+  rotate_y(-p[1], true, v.data());
+
+  // translation along z: O_lm += r^(l-j)/(l-j)! O_jm
+  vector<complex<double>> w(nmult_, 0.0);
+  vector<double> rpow(lmax_+1, 1.0);
+  for (int i = 1; i <= lmax_; ++i)
+    rpow[i] = rpow[i-1] * p[0];
+  for (int l = 0; l <= lmax_; ++l)
+    for (int j = 0; j <= l; ++j) {
+      const double fac = rpow[l-j] / factorial_[l-j];
+      for (int m = -j; m <= j; ++m)
+        w[l*l+l+m] += fac * v[j*j+j+m];
+    }
+
+  rotate_y(p[1], true, w.data());
+  rotate_z(p[2], 1, w.data());
+  for (int i = 0; i != nmult_; ++i)
+    out[i] += w[i];
+}
+
+
+void FMMTranslation::M2L(const array<double,3>& r, const complex<double>* in, complex<double>* out) const {
+  const array<double,3> p = spherical(r);
+  if (p[0] < numerical_zero__)
+    throw logic_error("M2L translation with a vanishing vector");
+
+  vector<complex<double>> v(in, in+nmult_);
+  rotate_z(p[2], -1, v.data());
+  rotate_y(-p[1], true, v.data());
+
+  // translation along z: L_lm += (-1)^l (l+j)!/r^(l+j+1) O_j,-m
+  vector<complex<double>> w(nmult_, 0.0);
+  vector<double> rinv(2*lmax_+2);
+  rinv[0] = 1.0 / p[0];
+  for (int i = 1; i != 2*lmax_+2; ++i)
+    rinv[i] = rinv[i-1] / p[0];
+  for (int l = 0; l <= lmax_; ++l)
+    for (int j = 0; j <= lmax_; ++j) {
+      const double fac = (l % 2 ? -1.0 : 1.0) * factorial_[l+j] * rinv[l+j];
+      const int mm = min(l, j);
+      for (int m = -mm; m <= mm; ++m)
+        w[l*l+l+m] += fac * v[j*j+j-m];
+    }
+
+  rotate_y(p[1], false, w.data());
+  rotate_z(p[2], -1, w.data());
+  for (int i = 0; i != nmult_; ++i)
+    out[i] += w[i];
+}
+
+
+void FMMTranslation::L2L(const array<double,3>& r, const complex<double>* in, complex<double>* out) const {
+  const array<double,3> p = spherical(r);
+
+  vector<complex<double>> v(in, in+nmult_);
+  rotate_z(p[2], 1, v.data());
+  rotate_y(-p[1], false, v.data());
+
+  // translation along z: L_lm += r^(j-l)/(j-l)! L_jm
+  vector<complex<double>> w(nmult_, 0.0);
+  vector<double> rpow(lmax_+1, 1.0);
+  for (int i = 1; i <= lmax_; ++i)
+    rpow[i] = rpow[i-1] * p[0];
+  for (int l = 0; l <= lmax_; ++l)
+    for (int j = l; j <= lmax_; ++j) {
+      const double fac = rpow[j-l] / factorial_[j-l];
+      for (int m = -l; m <= l; ++m)
+        w[l*l+l+m] += fac * v[j*j+j+m];
+    }
+
+  rotate_y(p[1], false, w.data());
+  rotate_z(p[2], -1, w.data());
+  for (int i = 0; i != nmult_; ++i)
+    out[i] += w[i];
+}
@@ -0,0 +1,75 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: fmmtranslation.h
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+
+#ifndef __SRC_PERIODIC_FMMTRANSLATION_H
+#define __SRC_PERIODIC_FMMTRANSLATION_H
+
+#include <array>
+#include <vector>
+#include <complex>
+
+namespace bagel {
+
+/// M2M, M2L and L2L translations of the expansions used in Box by the rotate-translate-rotate scheme.
+/** The expansion is rotated so that the translation vector points along z, translated along z (where only
+    the terms with the same |m| couple), and rotated back, which costs O(lmax^3) instead of O(lmax^4).
+    Rotations about z are diagonal; a rotation about y by beta is d^l(beta) = V exp(-i beta J_z) V^+ with V
+    the eigenvectors of J_y, which are computed once for each l. The conventions are those of the multipoles
+    and local expansions in Box. The output is accumulated. */
+class FMMTranslation {
+  protected:
+    int lmax_;
+    int nmult_;
+
+    // eigenvectors of J_y in the basis |l,m> (m = -l..l) for each l; the eigenvalues are -l..l in this order
+    std::vector<std::vector<std::complex<double>>> jyvec_;
+    // 1/sqrt((l+m)!(l-m)!) which relates the regular solid harmonics used here to the spherical harmonics
+    std::vector<double> norm_;
+    // factorials up to 2*lmax+1
+    std::vector<double> factorial_;
+
+    // v <- N d^l(beta) N^-1 v (regular = true) or N^-1 d^l(beta) N v (regular = false) for all l
+    void rotate_y(const double beta, const bool regular, std::complex<double>* v) const;
+    // v_lm <- exp(-i sign m phi) v_lm
+    void rotate_z(const double phi, const int sign, std::complex<double>* v) const;
+    // (r, theta, phi) of r
+    static std::array<double,3> spherical(const std::array<double,3>& r);
+
+  public:
+    FMMTranslation(const int lmax);
+
+    int lmax() const { return lmax_; }
+
+    // out += O(b) given O(a) and r = a - b
+    void M2M(const std::array<double,3>& r, const std::complex<double>* in, std::complex<double>* out) const;
+    // out += L(b) given O(a) and r = b - a
+    void M2L(const std::array<double,3>& r, const std::complex<double>* in, std::complex<double>* out) const;
+    // out += L(b) given L(a) and r = b - a
+    void L2L(const std::array<double,3>& r, const std::complex<double>* in, std::complex<double>* out) const;
+};
+
+}
+
+#endif
@@ -24,6 +24,8 @@
 //
 
 
+#include <algorithm>
+#include <src/util/f77.h>
 #include <src/periodic/localexpansion.h>
 
 using namespace std;
@@ -41,142 +43,132 @@ LocalExpansion::LocalExpansion(const array<double, 3>& c, const vector<shared_pt
 }
 
 
-vector<shared_ptr<const ZMatrix>> LocalExpansion::compute_local_moments() {
+vector<complex<double>> LocalExpansion::harmonics(const int amax, const bool irregular) const {
 
   const double r = sqrt(centre_[0]*centre_[0] + centre_[1]*centre_[1] + centre_[2]*centre_[2]);
   const double ctheta = (r > numerical_zero__) ? centre_[2]/r : 0.0;
   const double phi = atan2(centre_[1], centre_[0]);
 
+  vector<double> factorial(2*amax+2, 1.0);
+  for (int i = 1; i != 2*amax+2; ++i)
+    factorial[i] = factorial[i-1] * i;
+
+  vector<complex<double>> out((amax+1)*(amax+1));
+  for (int a = 0; a <= amax; ++a) {
+    for (int b = -a; b <= a; ++b) {
+      const double prefactor = irregular ? plm.compute(a, abs(b), ctheta) / pow(r, a + 1) * factorial[a - abs(b)]
+                                         : pow(r, a) * plm.compute(a, abs(b), ctheta) / factorial[a + abs(b)];
+      const double real = (b >= 0) ? (prefactor * cos(abs(b) * phi)) : (-1.0 * prefactor * cos(abs(b) * phi));
+      const double imag = prefactor * sin(abs(b) * phi);
+      out[a*a+a+b] = complex<double>(real, imag);
+    }
+  }
+  return out;
+}
+
+
+vector<shared_ptr<const ZMatrix>> LocalExpansion::apply(const vector<complex<double>>& op) const {
+
+  // all of the moments are translated by one matrix multiplication
+  const int nb = nbasis0_ * nbasis1_;
+  vector<complex<double>> in(nb * num_multipoles_);
+  for (int i = 0; i != num_multipoles_; ++i)
+    copy_n(moments_[i]->data(), nb, in.data() + nb*i);
+  vector<complex<double>> res(nb * num_multipoles_);
+  zgemm3m_("N", "T", nb, num_multipoles_, num_multipoles_, 1.0, in.data(), nb, op.data(), num_multipoles_, 0.0, res.data(), nb);
+
   vector<shared_ptr<const ZMatrix>> out(num_multipoles_);
+  for (int i = 0; i != num_multipoles_; ++i) {
+    auto m = make_shared<ZMatrix>(nbasis1_, nbasis0_);
+    copy_n(res.data() + nb*i, nb, m->data());
+    out[i] = m;
+  }
+  return out;
+}
+
+
+vector<shared_ptr<const ZMatrix>> LocalExpansion::compute_local_moments() {
 
+  const vector<complex<double>> coeff = harmonics(2 * lmax_, /*irregular*/true);
+  vector<bool> nonzero(num_multipoles_);
+  for (int i = 0; i != num_multipoles_; ++i)
+    nonzero[i] = moments_[i]->rms() > 1e-10;
+
+  vector<complex<double>> op(num_multipoles_ * num_multipoles_, 0.0);
   int i1 = 0;
   for (int l = 0; l <= lmax_; ++l) {
     for (int m = 0; m <= 2 * l; ++m, ++i1) {
-
-      ZMatrix local(nbasis1_, nbasis0_);
       int i2 = 0;
       for (int j = 0; j <= lmax_; ++j) {
         for (int k = 0; k <= 2 * j; ++k, ++i2) {
-
           const int a = l + j;
           const int b = m - l + k - j;
-
-          double prefactor = plm.compute(a, abs(b), ctheta) / pow(r, a + 1);
-          double ft = 1.0;
-          for (int i = 1; i <= a - abs(b); ++i) {
-            prefactor *= ft;
-            ++ft;
-          }
-          const double real = (b >= 0) ? (prefactor * cos(abs(b) * phi)) : (-1.0 * prefactor * cos(abs(b) * phi));
-          const double imag = prefactor * sin(abs(b) * phi);
-          const complex<double> coeff(real, imag);
-
-          if (abs(coeff) > numerical_zero__ && moments_[i2]->rms() > 1e-10)
-            zaxpy_(nbasis0_ * nbasis1_, coeff, moments_[i2]->data(), 1, local.data(), 1);
+          const complex<double> c = coeff[a*a+a+b];
+          if (abs(c) > numerical_zero__ && nonzero[i2])
+            op[i1 + num_multipoles_*i2] = c;
         }
       }
       assert(i2 == num_multipoles_);
-//      if (local.rms() > 1e-5) {
-//        cout << "lm = " << l << m-l << endl;
-//        (local.get_real_part())->print("Local");
-//      }
-//      if (moments_[i1]->rms() > 1e-5) {
-//        cout << "lm = " << l << m-l << endl;
-//        (moments_[i1]->get_real_part())->print("MM in local");
-//      }
-      out[i1] = make_shared<const ZMatrix>(local);
     }
   }
 
-  return out;
+  return apply(op);
 }
 
 
 /* given O(a) and centre (b-a) compute O(b) */
 vector<shared_ptr<const ZMatrix>> LocalExpansion::compute_shifted_multipoles() {
 
-  const double r = sqrt(centre_[0]*centre_[0] + centre_[1]*centre_[1] + centre_[2]*centre_[2]);
-  const double ctheta = (r > numerical_zero__) ? centre_[2]/r : 0.0;
-  const double phi = atan2(centre_[1], centre_[0]);
-
-  vector<shared_ptr<const ZMatrix>> out(num_multipoles_);
+  const vector<complex<double>> coeff = harmonics(lmax_, /*irregular*/false);
 
+  vector<complex<double>> op(num_multipoles_ * num_multipoles_, 0.0);
   int i1 = 0;
   for (int l = 0; l <= lmax_; ++l) {
     for (int m = 0; m <= 2 * l; ++m, ++i1) {
-
-      ZMatrix shifted(nbasis1_, nbasis0_);
       int i2 = 0;
       for (int j = 0; j <= lmax_; ++j) {
         for (int k = 0; k <= 2 * j; ++k, ++i2) {
-
           const int a = l - j;
           const int b = m - l - k + j;
           if (abs(b) <= a && a >= 0) {
-            double prefactor = pow(r, a) * plm.compute(a, abs(b), ctheta);
-            double ft = 1.0;
-            for (int i = 1; i <= a + abs(b); ++i) {
-              prefactor /= ft;
-              ++ft;
-            }
-            const double real = (b >= 0) ? (prefactor * cos(abs(b) * phi)) : (-1.0 * prefactor * cos(abs(b) * phi));
-            const double imag = prefactor * sin(abs(b) * phi);
-            const complex<double> coeff(real, imag);
-
-            if (abs(coeff) > numerical_zero__)
-              zaxpy_(nbasis0_ * nbasis1_, coeff, moments_[i2]->data(), 1, shifted.data(), 1);
+            const complex<double> c = coeff[a*a+a+b];
+            if (abs(c) > numerical_zero__)
+              op[i1 + num_multipoles_*i2] = c;
           }
         }
       }
       assert(i2 == num_multipoles_);
-      out[i1] = make_shared<const ZMatrix>(shifted);
     }
   }
 
-  return out;
+  return apply(op);
 }
 
 
 /* given L(a) and centre (a-b) compute L(b) */
 vector<shared_ptr<const ZMatrix>> LocalExpansion::compute_shifted_local_moments() {
 
-  const double r = sqrt(centre_[0]*centre_[0] + centre_[1]*centre_[1] + centre_[2]*centre_[2]);
-  const double ctheta = (r > numerical_zero__) ? centre_[2]/r : 0.0;
-  const double phi = atan2(centre_[1], centre_[0]);
-
-  vector<shared_ptr<const ZMatrix>> out(num_multipoles_);
+  const vector<complex<double>> coeff = harmonics(lmax_, /*irregular*/false);
 
+  vector<complex<double>> op(num_multipoles_ * num_multipoles_, 0.0);
   int i1 = 0;
   for (int l = 0; l <= lmax_; ++l) {
     for (int m = 0; m <= 2 * l; ++m, ++i1) {
-
-      ZMatrix shifted(nbasis1_, nbasis0_);
       int i2 = 0;
       for (int j = 0; j <= lmax_; ++j) {
         for (int k = 0; k <= 2 * j; ++k, ++i2) {
-
           const int a = j - l;
           const int b = k - j - m + l;
           if (abs(b) <= a && a >= 0) {
-            double prefactor = pow(r, a) * plm.compute(a, abs(b), ctheta);
-            double ft = 1.0;
-            for (int i = 1; i <= a + abs(b); ++i) {
-              prefactor /= ft;
-              ++ft;
-            }
-            const double real = (b >= 0) ? (prefactor * cos(abs(b) * phi)) : (-1.0 * prefactor * cos(abs(b) * phi));
-            const double imag = prefactor * sin(abs(b) * phi);
-            const complex<double> coeff(real, imag);
-
-            if (abs(coeff) > numerical_zero__)
-              zaxpy_(nbasis0_ * nbasis1_, coeff, moments_[i2]->data(), 1, shifted.data(), 1);
+            const complex<double> c = coeff[a*a+a+b];
+            if (abs(c) > numerical_zero__)
+              op[i1 + num_multipoles_*i2] = c;
           }
         }
       }
       assert(i2 == num_multipoles_);
-      out[i1] = make_shared<const ZMatrix>(shifted);
     }
   }
 
-  return out;
+  return apply(op);
 }
@@ -43,6 +43,11 @@ class LocalExpansion {
     int nbasis0_, nbasis1_;
     int num_multipoles_;
 
+    // the solid harmonics of centre_ up to a = amax (index a*a+a+b), in which the transcendental functions are evaluated
+    std::vector<std::complex<double>> harmonics(const int amax, const bool irregular) const;
+    // out_i = sum_j op(i, j) moment_j
+    std::vector<std::shared_ptr<const ZMatrix>> apply(const std::vector<std::complex<double>>& op) const;
+
   public:
     LocalExpansion(const std::array<double, 3>& centre, const std::vector<std::shared_ptr<const ZMatrix>>& moments,
                    const int lmax = ANG_HRR_END);
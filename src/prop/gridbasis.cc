@@ -0,0 +1,94 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: gridbasis.cc
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+
+#include <src/prop/gridbasis.h>
+
+using namespace std;
+using namespace bagel;
+
+
+GridBasis::GridBasis(shared_ptr<const Geometry> geom, const double thresh) : geom_(geom) {
+  auto o = geom_->offsets().begin();
+  for (auto a = geom_->atoms().begin(); a != geom_->atoms().end(); ++a, ++o) {
+    auto offset = o->begin();
+    for (auto b = (*a)->shells().begin(); b != (*a)->shells().end(); ++b, ++offset) {
+      // |c| r^l exp(-alpha r^2) < thresh is solved for each primitive by fixed-point iterations.
+      // A factor of 10 is included for the normalization in the Cartesian-to-spherical transformation.
+      const int l = (*b)->angular_number();
+      double extent = 0.0;
+      for (int j = 0; j != (*b)->num_primitive(); ++j) {
+        double cmax = 0.0;
+        for (auto& c : (*b)->contractions())
+          cmax = max(cmax, fabs(c[j]));
+        const double lnc = log(10.0*cmax/thresh);
+        if (lnc <= 0.0) continue;
+        const double alpha = (*b)->exponents(j);
+        double r2 = lnc / alpha;
+        for (int iter = 0; iter != 5; ++iter)
+          r2 = (lnc + 0.5*l*log(max(r2, 1.0))) / alpha;
+        extent = max(extent, std::sqrt(r2));
+      }
+      shells_.push_back(*b);
+      offsets_.push_back(*offset);
+      extents_.push_back(extent);
+    }
+  }
+}
+
+
+pair<vector<int>, shared_ptr<Matrix>> GridBasis::compute(const double* coords, const size_t npts) const {
+  // bounding sphere of the points
+  array<double,3> center{{0.0, 0.0, 0.0}};
+  for (size_t p = 0; p != npts; ++p)
+    for (int i = 0; i != 3; ++i)
+      center[i] += coords[3*p+i] / npts;
+  double radius = 0.0;
+  for (size_t p = 0; p != npts; ++p)
+    radius = max(radius, std::sqrt(pow(coords[3*p]-center[0], 2) + pow(coords[3*p+1]-center[1], 2) + pow(coords[3*p+2]-center[2], 2)));
+
+  // significant shells
+  vector<size_t> shells;
+  vector<int> basis;
+  for (size_t s = 0; s != shells_.size(); ++s) {
+    const array<double,3>& pos = shells_[s]->position();
+    const double dist = std::sqrt(pow(pos[0]-center[0], 2) + pow(pos[1]-center[1], 2) + pow(pos[2]-center[2], 2));
+    if (dist < extents_[s] + radius) {
+      shells.push_back(s);
+      for (int i = 0; i != shells_[s]->nbasis(); ++i)
+        basis.push_back(offsets_[s] + i);
+    }
+  }
+
+  auto out = make_shared<Matrix>(basis.size(), npts, /*localized*/true);
+  for (size_t p = 0; p != npts; ++p) {
+    int pos = 0;
+    for (auto& s : shells) {
+      const array<double,3>& spos = shells_[s]->position();
+      shells_[s]->compute_grid_value(out->element_ptr(pos, p), nullptr, nullptr, nullptr, coords[3*p]-spos[0], coords[3*p+1]-spos[1], coords[3*p+2]-spos[2]);
+      pos += shells_[s]->nbasis();
+    }
+  }
+  return make_pair(basis, out);
+}
@@ -0,0 +1,51 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: gridbasis.h
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+
+#ifndef __SRC_PROP_GRIDBASIS_H
+#define __SRC_PROP_GRIDBASIS_H
+
+#include <src/wfn/geometry.h>
+
+namespace bagel {
+
+// Evaluates the (real) basis functions on a batch of grid points. Only the shells whose extent
+// (the distance beyond which all of their functions are below thresh) reaches the batch are evaluated.
+class GridBasis {
+  protected:
+    std::shared_ptr<const Geometry> geom_;
+    std::vector<std::shared_ptr<const Shell>> shells_;
+    std::vector<int> offsets_;
+    std::vector<double> extents_;
+
+  public:
+    GridBasis(std::shared_ptr<const Geometry> geom, const double thresh = 1.0e-12);
+
+    // coords is a 3 x npts array. Returns the indices of the significant basis functions and their values (nsig x npts)
+    std::pair<std::vector<int>, std::shared_ptr<Matrix>> compute(const double* coords, const size_t npts) const;
+};
+
+}
+
+#endif
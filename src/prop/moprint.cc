@@ -30,6 +30,7 @@
 #include <src/mat1e/overlap.h>
 #include <src/mat1e/giao/zoverlap.h>
 #include <src/prop/overlap_point.h>
+#include <src/prop/gridbasis.h>
 
 using namespace std;
 using namespace bagel;
@@ -177,15 +178,17 @@ namespace bagel {
 void MOPrint::compute() {
 
   assert(density_.size() == orbitals_.size()+1 && density_.size() == norb_+1);
-  // The last Task will compute integrated total charge
-  TaskQueue<MOPrintTask> task(ngrid_);
   points_.resize((ngrid_+1)*(norb_+1), 0.0);
 
-  for (int i = 0; i != ngrid_; ++i)
-    if (i % mpi__->size() == mpi__->rank())
-      task.emplace_back(i, this);
-
-  task.compute();
+  if (!geom_->london()) {
+    computebatch();
+  } else {
+    TaskQueue<MOPrintTask> task(ngrid_);
+    for (int i = 0; i != ngrid_; ++i)
+      if (i % mpi__->size() == mpi__->rank())
+        task.emplace_back(i, this);
+    task.compute();
+  }
   mpi__->allreduce(points_.data(), points_.size());
 
   computefull();
@@ -234,6 +237,70 @@ void MOPrint::computepoint(const size_t pos) {
 }
 
 
+// For real basis functions the grid is divided into tiles of up to tile^3 points. In each tile the significant basis functions
+// are evaluated at once and contracted with all the densities by a single GEMM. Tiles are distributed over processes and threads.
+void MOPrint::computebatch() {
+  const int n = geom_->nbasis();
+  const int ndensity = norb_+1;
+
+  // only the real part of the large-component density contributes when the basis functions are real
+  vector<shared_ptr<const Matrix>> rdensity;
+  for (auto& d : density_) {
+    shared_ptr<Matrix> tmp = d->get_submatrix(0, 0, n, n)->get_real_part();
+    if (relativistic_)
+      *tmp += *d->get_submatrix(n, n, n, n)->get_real_part();
+    rdensity.push_back(tmp);
+  }
+
+  const size_t tile = 6;
+  array<size_t,3> ntile;
+  for (int i = 0; i != 3; ++i)
+    ntile[i] = (ngrid_dim_[i]+tile-1) / tile;
+  const GridBasis gridbasis(geom_);
+
+  TaskQueue<function<void(void)>> tasks(ntile[0]*ntile[1]*ntile[2]);
+  const size_t nproc = mpi__->size();
+  const size_t rank = mpi__->rank();
+  size_t itile = 0;
+  for (size_t ti = 0; ti != ntile[0]; ++ti)
+    for (size_t tj = 0; tj != ntile[1]; ++tj)
+      for (size_t tk = 0; tk != ntile[2]; ++tk) {
+        if (itile++ % nproc != rank) continue;
+        tasks.emplace_back([this, ti, tj, tk, tile, ndensity, &gridbasis, &rdensity] {
+          vector<size_t> pos;
+          for (size_t i = ti*tile; i != min((ti+1)*tile, ngrid_dim_[0]); ++i)
+            for (size_t j = tj*tile; j != min((tj+1)*tile, ngrid_dim_[1]); ++j)
+              for (size_t k = tk*tile; k != min((tk+1)*tile, ngrid_dim_[2]); ++k)
+                pos.push_back(k+ngrid_dim_[2]*(j+ngrid_dim_[1]*i));
+          const int np = pos.size();
+          vector<double> coords(3*np);
+          for (int p = 0; p != np; ++p)
+            copy_n(&coords_[3*pos[p]], 3, &coords[3*p]);
+
+          vector<int> basis;
+          shared_ptr<const Matrix> phi;
+          tie(basis, phi) = gridbasis.compute(coords.data(), np);
+          const int ns = basis.size();
+          if (ns == 0) return;
+
+          // the significant blocks of all the densities, stacked (ndensity*ns, ns)
+          Matrix dens(ndensity*ns, ns, /*localized*/true);
+          for (int id = 0; id != ndensity; ++id)
+            for (int b = 0; b != ns; ++b)
+              for (int a = 0; a != ns; ++a)
+                dens(id*ns+a, b) = rdensity[id]->element(basis[a], basis[b]);
+
+          Matrix dphi(ndensity*ns, np, /*localized*/true);
+          dgemm_("N", "N", ndensity*ns, np, ns, 1.0, dens.data(), ndensity*ns, phi->data(), ns, 0.0, dphi.data(), ndensity*ns);
+          for (int p = 0; p != np; ++p)
+            for (int id = 0; id != ndensity; ++id)
+              points_[ndensity*pos[p]+id] = ddot_(ns, phi->element_ptr(0, p), 1, dphi.element_ptr(id*ns, p), 1);
+        });
+      }
+  tasks.compute();
+}
+
+
 void MOPrint::computefull() {
   shared_ptr<ZMatrix> ao_density;
   shared_ptr<ZMatrix> input_ovlp;
@@ -53,6 +53,7 @@ class MOPrint : public Method {
     std::vector<double> points_;
 
     void computepoint(const size_t pos);
+    void computebatch();
     void computefull();
     void print() const;
 
@@ -53,6 +53,9 @@ MP2::MP2(const shared_ptr<const PTree> input, const shared_ptr<const Geometry> g
   // if three is a aux_basis keyword, we use that basis
   abasis_ = to_lower(idata_->get<string>("aux_basis", ""));
 
+  laplace_ = idata_->get<bool>("laplace", false);
+  laplace_npoint_ = idata_->get<int>("laplace_npoint", 12);
+
 }
 
 
@@ -72,30 +75,29 @@ void MP2::compute() {
   Timer timer;
   // compute transformed integrals
   shared_ptr<DFDistT> fullt;
+  shared_ptr<StaticDist> dist;
   size_t memory_size;
 
   {
-    // first compute half transformed integrals
-    shared_ptr<DFHalfDist> half;
+    // transformed integrals; the half-transformed ones are streamed and not stored
+    shared_ptr<const DFDist> df = geom_->df();
     if (abasis_.empty()) {
-      half = geom_->df()->compute_half_transform(ocoeff);
-      // used later to determine the cache size
-      memory_size = half->block(0)->size() * 2;
+      // used later to determine the cache size (twice the size of the half-transformed integrals)
+      memory_size = df->block(0)->asize() * nocc * df->nbasis0() * 2;
       mpi__->broadcast(&memory_size, 1, 0);
     } else {
       auto info = make_shared<PTree>(); info->put("df_basis", abasis_);
       auto cgeom = make_shared<Geometry>(*geom_, info, false);
-      half = cgeom->df()->compute_half_transform(ocoeff);
+      df = cgeom->df();
       // used later to determine the cache size
-      memory_size = cgeom->df()->block(0)->size();
+      memory_size = df->block(0)->size();
       mpi__->broadcast(&memory_size, 1, 0);
     }
 
-    // second transform for virtual index and rearrange data
     {
       // this is now (naux, nvirt, nocc), distributed by nvirt*nocc. Always naux*nvirt block is localized to one node
-      shared_ptr<DFFullDist> full = half->compute_second_transform(vcoeff)->apply_J()->swap();
-      auto dist = make_shared<StaticDist>(full->nocc1()*full->nocc2(), mpi__->size(), full->nocc1());
+      shared_ptr<DFFullDist> full = df->compute_full_transform(ocoeff, vcoeff, 1)->swap();
+      dist = make_shared<StaticDist>(full->nocc1()*full->nocc2(), mpi__->size(), full->nocc1());
       fullt = make_shared<DFDistT>(full, dist);
     }
 
@@ -106,53 +108,57 @@ void MP2::compute() {
 
   cout << "    * 3-index integral transformation done" << endl;
 
-  // start communication (n fetch behind) - n is determined by memory size
-  MP2Cache cache(naux, nocc, nvirt, fullt);
-
-  const int nloop = cache.nloop();
-  const int ncache = min(memory_size/(nvirt*nvirt), size_t(20));
-  cout << "    * ncache = " << ncache << endl;
-  for (int n = 0; n != min(ncache, nloop); ++n)
-    cache.block(n, -1);
-
   // denominator info
   const vector<double> eig(ref_->eig().begin()+ncore_, ref_->eig().end());
 
-  // loop over tasks
-  energy_ = 0;
-  for (int n = 0; n != nloop; ++n) {
-    // take care of data. The communication should be hidden
-    if (n+ncache < nloop)
-      cache.block(n+ncache, n-1);
-
-    const int i = get<0>(cache.task(n));
-    const int j = get<1>(cache.task(n));
-    if (i < 0 || j < 0) continue;
-    cache.data_wait(n);
-
-    shared_ptr<const Matrix> iblock = cache(i);
-    shared_ptr<const Matrix> jblock = cache(j);
-    const Matrix mat(*iblock % *jblock);
-
-    // should thread
-    double en = 0.0;
-    for (int a = 0; a != nvirt; ++a) {
-      for (int b = a+1; b < nvirt; ++b) {
-        const double ab = mat(a, b);
-        const double ba = mat(b, a);
-        en += 2.0*(ba*ba + ab*ab - ba*ab) / (-eig[a+nocc]+eig[i]-eig[b+nocc]+eig[j]);
+  if (laplace_) {
+    energy_ = laplace_energy(fullt, dist, eig, nocc, nvirt);
+  } else {
+    // start communication (n fetch behind) - n is determined by memory size
+    MP2Cache cache(naux, nocc, nvirt, fullt);
+
+    const int nloop = cache.nloop();
+    const int ncache = min(memory_size/(nvirt*nvirt), size_t(20));
+    cout << "    * ncache = " << ncache << endl;
+    for (int n = 0; n != min(ncache, nloop); ++n)
+      cache.block(n, -1);
+
+    // loop over tasks
+    energy_ = 0;
+    for (int n = 0; n != nloop; ++n) {
+      // take care of data. The communication should be hidden
+      if (n+ncache < nloop)
+        cache.block(n+ncache, n-1);
+
+      const int i = get<0>(cache.task(n));
+      const int j = get<1>(cache.task(n));
+      if (i < 0 || j < 0) continue;
+      cache.data_wait(n);
+
+      shared_ptr<const Matrix> iblock = cache(i);
+      shared_ptr<const Matrix> jblock = cache(j);
+      const Matrix mat(*iblock % *jblock);
+
+      // should thread
+      double en = 0.0;
+      for (int a = 0; a != nvirt; ++a) {
+        for (int b = a+1; b < nvirt; ++b) {
+          const double ab = mat(a, b);
+          const double ba = mat(b, a);
+          en += 2.0*(ba*ba + ab*ab - ba*ab) / (-eig[a+nocc]+eig[i]-eig[b+nocc]+eig[j]);
+        }
+        const double aa = mat(a, a);
+        en += aa*aa / (-eig[a+nocc]+eig[i]-eig[a+nocc]+eig[j]);
       }
-      const double aa = mat(a, a);
-      en += aa*aa / (-eig[a+nocc]+eig[i]-eig[a+nocc]+eig[j]);
+      if (i != j) en *= 2.0;
+      energy_ += en;
     }
-    if (i != j) en *= 2.0;
-    energy_ += en;
-  }
 
-  // just to double check that all the communition is done
-  cache.wait();
-  // allreduce energy contributions
-  mpi__->allreduce(&energy_, 1);
+    // just to double check that all the communition is done
+    cache.wait();
+    // allreduce energy contributions
+    mpi__->allreduce(&energy_, 1);
+  }
 
   cout << "    * assembly done" << endl << endl;
   cout << "      MP2 correlation energy: " << fixed << setw(15) << setprecision(10) << energy_ << setw(10) << setprecision(2) << timer.tick() << endl << endl;
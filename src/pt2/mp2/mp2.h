@@ -27,6 +27,7 @@
 #define __SRC_MP2_MP2_H
 
 #include <src/scf/hf/rhf.h>
+#include <src/df/dfdistt.h>
 #include <src/wfn/method.h>
 
 namespace bagel {
@@ -38,8 +39,15 @@ class MP2 : public Method {
 
     std::string abasis_;
 
+    /// if true, the energy is computed with a Laplace quadrature of the denominator instead of the occupied-pair loop
+    bool laplace_;
+    int laplace_npoint_;
+
     double energy_;
 
+    double laplace_energy(std::shared_ptr<const DFDistT> fullt, std::shared_ptr<const StaticDist> dist, const std::vector<double>& eig,
+                          const size_t nocc, const size_t nvirt) const;
+
   public:
     MP2(const std::shared_ptr<const PTree>, const std::shared_ptr<const Geometry>, const std::shared_ptr<const Reference> = nullptr);
 
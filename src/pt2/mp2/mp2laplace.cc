@@ -0,0 +1,184 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: mp2laplace.cc
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+
+#include <src/pt2/mp2/mp2.h>
+#include <src/pt2/mp2/mp2laplace.h>
+#include <src/util/f77.h>
+#include <src/util/taskqueue.h>
+
+using namespace std;
+using namespace bagel;
+
+LaplaceQuadrature::LaplaceQuadrature(const double xmin, const double xmax, const int npoint) : error_(numeric_limits<double>::max()) {
+  if (npoint < 1 || xmin <= 0.0 || xmax < xmin)
+    throw runtime_error("invalid parameters for the Laplace quadrature");
+
+  // the fit is performed for y = x/xmin in [1, ratio]
+  const double ratio = max(xmax/xmin, 1.0+1.0e-8);
+  const int nsample = max(300, 20*npoint);
+  vector<double> ys(nsample);
+  for (int i = 0; i != nsample; ++i)
+    ys[i] = exp(log(ratio)*i/(nsample-1));
+
+  vector<double> t(npoint);
+  for (int ilo = 0; ilo != 3; ++ilo) {
+    for (int ihi = 0; ihi != 16; ++ihi) {
+      // exponents on a geometric grid from exp(lo)/ratio to exp(hi)
+      const double hi = 0.5 + 0.2*ihi;
+      const double tlo = -1.0 + 0.2*ilo - log(ratio);
+      for (int k = 0; k != npoint; ++k)
+        t[k] = exp(npoint == 1 ? hi : tlo + (hi-tlo)*k/(npoint-1));
+
+      // least-squares fit of y * sum_k w_k exp(-y t_k) = 1 through SVD
+      Matrix a(nsample, npoint);
+      for (int k = 0; k != npoint; ++k)
+        for (int i = 0; i != nsample; ++i)
+          a(i, k) = ys[i] * exp(-ys[i]*t[k]);
+      const Matrix acopy(a);
+      vector<double> sing(npoint);
+      shared_ptr<Matrix> u, vt;
+      tie(u, vt) = a.svd(sing.data());
+
+      vector<double> w(npoint, 0.0);
+      for (int k = 0; k != npoint; ++k) {
+        if (sing[k] < 1.0e-14*sing[0]) continue;
+        const double c = accumulate(u->element_ptr(0, k), u->element_ptr(0, k)+nsample, 0.0) / sing[k];
+        for (int j = 0; j != npoint; ++j)
+          w[j] += c * vt->element(k, j);
+      }
+
+      double err = 0.0;
+      for (int i = 0; i != nsample; ++i) {
+        double f = 0.0;
+        for (int k = 0; k != npoint; ++k)
+          f += acopy(i, k) * w[k];
+        err = max(err, fabs(f - 1.0));
+      }
+      if (err < error_) {
+        error_ = err;
+        exponents_ = t;
+        weights_ = w;
+      }
+    }
+  }
+
+  // back to the original variable
+  for (auto& i : exponents_) i /= xmin;
+  for (auto& i : weights_) i /= xmin;
+}
+
+
+void LaplaceExchangeTask::compute() {
+  const size_t ni = nvirt_*ni_;
+  const size_t nj = nvirt_*nj_;
+  Matrix mat(ni, nj, true);
+  dgemm_("T", "N", ni, nj, naux_, 1.0, xi_, naux_, xj_, naux_, 0.0, mat.data(), ni);
+
+  // sum_ab (ia|jb)(ib|ja) for all pairs in the batch
+  double en = 0.0;
+  for (size_t j = 0; j != nj_; ++j)
+    for (size_t i = 0; i != ni_; ++i)
+      for (size_t b = 0; b != nvirt_; ++b)
+        for (size_t a = 0; a != nvirt_; ++a)
+          en += mat(a+i*nvirt_, b+j*nvirt_) * mat(b+i*nvirt_, a+j*nvirt_);
+  *out_ = en;
+}
+
+
+double MP2::laplace_energy(shared_ptr<const DFDistT> fullt, shared_ptr<const StaticDist> dist, const vector<double>& eig, const size_t nocc, const size_t nvirt) const {
+  Timer timer(1);
+  const size_t naux = fullt->naux();
+  const int myrank = mpi__->rank();
+  const int nproc = mpi__->size();
+
+  // the energy denominators eps_a + eps_b - eps_i - eps_j are in this range
+  LaplaceQuadrature quad(2.0*(eig[nocc]-eig[nocc-1]), 2.0*(eig[nocc+nvirt-1]-eig[0]), laplace_npoint_);
+  cout << "    * Laplace quadrature with " << quad.npoint() << " points (max relative error "
+       << scientific << setprecision(2) << quad.error() << ")" << endl;
+
+  // occupied orbitals held by each process (the distribution is in units of nvirt)
+  vector<size_t> ostart(nproc), osize(nproc);
+  for (int r = 0; r != nproc; ++r) {
+    ostart[r] = get<0>(dist->range(r)) / nvirt;
+    osize[r] = dist->size(r) / nvirt;
+  }
+  assert(ostart[myrank]*nvirt == fullt->bstart() && osize[myrank]*nvirt == fullt->bsize());
+
+  // occupied batches are chosen such that each pair of batches is a reasonably sized GEMM
+  const size_t obatch = max<size_t>(1, 512/nvirt);
+  auto batches = [&obatch](const size_t n) {
+    vector<pair<size_t, size_t>> out;
+    for (size_t i = 0; i < n; i += obatch)
+      out.emplace_back(i, min(obatch, n-i));
+    return out;
+  };
+  const vector<pair<size_t, size_t>> mybatches = batches(osize[myrank]);
+
+  const double* bdata = osize[myrank] ? fullt->data() : nullptr;
+  Matrix x(naux, nvirt*osize[myrank], true);
+  Matrix buf(naux, nvirt**max_element(osize.begin(), osize.end()), true);
+
+  double energy = 0.0;
+  for (int k = 0; k != quad.npoint(); ++k) {
+    // X^P_ia = (P|ia) exp(-t(eps_a - eps_i)/2); the denominator then factorizes into the products of X
+    const double t = quad.exponent(k);
+    for (size_t i = 0; i != osize[myrank]; ++i)
+      for (size_t a = 0; a != nvirt; ++a) {
+        const double fac = exp(-0.5*t*(eig[nocc+a] - eig[ostart[myrank]+i]));
+        transform(bdata+(a+i*nvirt)*naux, bdata+(a+i*nvirt+1)*naux, x.element_ptr(0, a+i*nvirt), [&fac](const double d) { return fac*d; });
+      }
+
+    // sum_{ijab} (ia|jb)^2 = |Z|^2 with Z_PQ = sum_ia X^P_ia X^Q_ia
+    Matrix z(naux, naux, true);
+    if (x.mdim())
+      dgemm_("N", "T", naux, naux, x.mdim(), 1.0, x.data(), naux, x.data(), naux, 0.0, z.data(), naux);
+    z.allreduce();
+    const double coulomb = pow(z.norm(), 2);
+
+    // sum_{ijab} (ia|jb)(ib|ja); the j index runs over the orbitals of each process in turn
+    double exchange = 0.0;
+    for (int s = 0; s != nproc; ++s) {
+      if (osize[s] == 0) continue;
+      if (s == myrank)
+        copy_n(x.data(), x.size(), buf.data());
+      mpi__->broadcast(buf.data(), naux*nvirt*osize[s], s);
+
+      const vector<pair<size_t, size_t>> sbatches = batches(osize[s]);
+      vector<double> partial(mybatches.size()*sbatches.size());
+      TaskQueue<LaplaceExchangeTask> tasks(partial.size());
+      double* out = partial.data();
+      for (auto& i : mybatches)
+        for (auto& j : sbatches)
+          tasks.emplace_back(x.element_ptr(0, i.first*nvirt), buf.element_ptr(0, j.first*nvirt), naux, nvirt, i.second, j.second, out++);
+      tasks.compute();
+      exchange += accumulate(partial.begin(), partial.end(), 0.0);
+    }
+    mpi__->allreduce(&exchange, 1);
+
+    energy -= quad.weight(k) * (2.0*coulomb - exchange);
+    timer.tick_print("Laplace point " + to_string(k));
+  }
+  return energy;
+}
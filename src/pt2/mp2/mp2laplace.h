@@ -0,0 +1,73 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: mp2laplace.h
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+
+#ifndef __SRC_MP2_MP2LAPLACE_H
+#define __SRC_MP2_MP2LAPLACE_H
+
+#include <vector>
+#include <cstddef>
+
+namespace bagel {
+
+/// Quadrature for 1/x = \int_0^\infty exp(-xt) dt, valid for x in [xmin, xmax].
+/** The exponents are placed on a geometric grid whose end points are scanned; for each grid the weights are
+    obtained by a least-squares fit of the relative error on [xmin, xmax]. */
+class LaplaceQuadrature {
+  protected:
+    std::vector<double> exponents_;
+    std::vector<double> weights_;
+    double error_; ///< maximum relative error on [xmin, xmax]
+
+  public:
+    LaplaceQuadrature(const double xmin, const double xmax, const int npoint);
+
+    int npoint() const { return exponents_.size(); }
+    double exponent(const int i) const { return exponents_[i]; }
+    double weight(const int i) const { return weights_[i]; }
+    double error() const { return error_; }
+};
+
+
+/// Exchange contribution of one pair of occupied batches, sum_{ijab} X^P_ia X^P_jb X^Q_ib X^Q_ja
+class LaplaceExchangeTask {
+  protected:
+    const double* xi_; ///< (naux, nvirt, ni)
+    const double* xj_; ///< (naux, nvirt, nj)
+    const size_t naux_;
+    const size_t nvirt_;
+    const size_t ni_;
+    const size_t nj_;
+    double* out_;
+
+  public:
+    LaplaceExchangeTask(const double* xi, const double* xj, const size_t naux, const size_t nvirt, const size_t ni, const size_t nj, double* out)
+      : xi_(xi), xj_(xj), naux_(naux), nvirt_(nvirt), ni_(ni), nj_(nj), out_(out) { }
+
+    void compute();
+};
+
+}
+
+#endif
@@ -188,16 +188,14 @@ tuple<shared_ptr<DFDistT>, shared_ptr<DFDistT>, shared_ptr<DFDistT>, shared_ptr<
   shared_ptr<DFDistT> fullvi, fullax, fullvi2, fullax2;
   if (nclosed_) {
     // this is now (naux, nvirt_, nclosed_), distributed by nvirt_*nclosed_. Always naux*nvirt_ block is localized to one node
-    shared_ptr<const DFHalfDist> half = cgeom->df()->compute_half_transform(ccoeff);
-    shared_ptr<DFFullDist> full = half->compute_second_transform(vcoeff)->apply_J()->swap();
+    shared_ptr<DFFullDist> full = cgeom->df()->compute_full_transform(*ccoeff, *vcoeff, 1)->swap();
     auto dist = make_shared<StaticDist>(full->nocc1()*full->nocc2(), mpi__->size(), full->nocc1());
     fullvi = make_shared<DFDistT>(full, dist);
     fullvi->discard_df();
     assert(fullvi->nblocks() == 1);
   }
   {
-    shared_ptr<const DFHalfDist> halfa = cgeom->df()->compute_half_transform(acoeff);
-    shared_ptr<DFFullDist> full = halfa->compute_second_transform(coeffall)->apply_J();
+    shared_ptr<DFFullDist> full = cgeom->df()->compute_full_transform(*acoeff, *coeffall, 1);
     auto dist = make_shared<StaticDist>(full->nocc1()*full->nocc2(), mpi__->size());
     fullax = make_shared<DFDistT>(full, dist);
     fullax->discard_df();
@@ -44,7 +44,7 @@ AtomicDensities::AtomicDensities(shared_ptr<const Geometry> g) : Matrix(g->nbasi
   shared_ptr<const PTree> bdata = PTree::read_basis(defbasis);
 
   vector<shared_ptr<const Atom>> aux_atoms;
-  if (geom_->auxfile().empty()) {
+  if (geom_->auxfile().empty() || geom_->cholesky()) {
      for (auto& a : geom_->atoms()) {
        auto aux_atom = make_shared<const Atom>(*a, a->spherical(), geom_->basisfile(), make_pair(geom_->basisfile(), bdata), nullptr);
        aux_atoms.push_back(aux_atom);
@@ -23,6 +23,7 @@
 //
 
 #include <src/scf/hf/fock.h>
+#include <src/scf/ks/cosx.h>
 
 using namespace std;
 using namespace bagel;
@@ -233,21 +234,42 @@ void Fock<DF>::fock_two_electron_part(shared_ptr<const Matrix> den_ex) {
 
 
 template<int DF>
-void Fock<DF>::fock_two_electron_part_with_coeff(const MatView ocoeff, const bool rhf, const double scale_exchange, const double scale_coulomb) {
+void Fock<DF>::fock_two_electron_part_with_coeff(const MatView ocoeff, const bool rhf, const double scale_exchange, const double scale_coulomb, const double local_thresh,
+                                                 shared_ptr<const COSX> cosx, const bool single) {
   if (DF == 0) throw logic_error("Fock<DF>::fock_two_electron_part_with_coeff() is only for DF cases");
 
   Timer pdebug(3);
 
   shared_ptr<const DFDist> df = geom_->df();
 
-  if (scale_exchange != 0.0) {
-    shared_ptr<DFHalfDist> halfbj = df->compute_half_transform(ocoeff);
+  // the half-transformed integrals are needed for gradients, in which case the exchange is computed as usual
+  if (scale_exchange != 0.0 && (cosx || local_thresh > 0.0) && !store_half_) {
+    if (cosx) {
+      *this += *cosx->compute_exchange(ocoeff, -scale_exchange);
+      pdebug.tick_print("Seminumerical exchange build");
+    } else {
+      *this += *local_exchange(ocoeff, local_thresh, scale_exchange);
+      pdebug.tick_print("Local exchange build");
+    }
+
+    shared_ptr<Matrix> jop;
+    if (rhf) {
+      Matrix oc(ocoeff);
+      jop = df->compute_Jop(make_shared<const Matrix>((oc ^ oc) * (2.0*scale_coulomb)));
+    } else {
+      jop = df->compute_Jop(density_);
+      if (scale_coulomb != 1.0)
+        jop->scale(scale_coulomb);
+    }
+    *this += *jop;
+  } else if (scale_exchange != 0.0) {
+    shared_ptr<DFHalfDist> halfbj = single ? df->compute_half_transform_single(ocoeff) : df->compute_half_transform(ocoeff);
     pdebug.tick_print("First index transform");
 
     shared_ptr<DFHalfDist> half = halfbj->apply_J();
     pdebug.tick_print("Metric multiply");
 
-    *this += *half->form_2index(half, -1.0*scale_exchange);
+    *this += *(single ? half->form_2index_single(half, -1.0*scale_exchange) : half->form_2index(half, -1.0*scale_exchange));
     pdebug.tick_print("Exchange build");
 
     if (rhf) {
@@ -274,6 +296,88 @@ void Fock<DF>::fock_two_electron_part_with_coeff(const MatView ocoeff, const boo
 }
 
 
+template<int DF>
+shared_ptr<Matrix> Fock<DF>::local_exchange(const MatView ocoeff, const double thresh, const double scale_exchange) const {
+  const int nbasis = ocoeff.extent(0);
+  const int nocc = ocoeff.extent(1);
+
+  // Cholesky orbitals, i.e., pivoted Cholesky decomposition of C C^T, span the same space and are localized
+  const Matrix oc(ocoeff);
+  Matrix lcoeff(nbasis, nocc);
+  int nvec = 0;
+  {
+    vector<double> diag(nbasis, 0.0);
+    for (int j = 0; j != nocc; ++j)
+      for (int i = 0; i != nbasis; ++i)
+        diag[i] += oc(i, j)*oc(i, j);
+    vector<double> row(nocc);
+    for (; nvec != nocc; ++nvec) {
+      const int p = max_element(diag.begin(), diag.end()) - diag.begin();
+      if (diag[p] < 1.0e-12) break;
+      // column p of C C^T minus the contributions of the previous vectors
+      for (int j = 0; j != nocc; ++j)
+        row[j] = oc(p, j);
+      double* col = lcoeff.element_ptr(0, nvec);
+      dgemv_("N", nbasis, nocc, 1.0, oc.data(), nbasis, row.data(), 1, 0.0, col, 1);
+      for (int k = 0; k != nvec; ++k)
+        blas::ax_plus_y_n(-lcoeff(p, k), lcoeff.element_ptr(0, k), nbasis, col);
+      blas::scale_n(1.0/std::sqrt(diag[p]), col, nbasis);
+      for (int i = 0; i != nbasis; ++i)
+        diag[i] -= col[i]*col[i];
+      diag[p] = 0.0;
+    }
+  }
+
+  // shells and the square roots of the Schwarz integrals (rs|rs)
+  const int nshell = lround(std::sqrt(geom_->nshellpair()));
+  vector<int> offset(nshell), size(nshell);
+  for (int i = 0; i != nshell; ++i) {
+    offset[i] = geom_->shellpair(i)->offset(0);
+    size[i] = geom_->shellpair(i)->nbasis0();
+  }
+  vector<double> schwarz(nshell*nshell);
+  vector<double> schwarzmax(nshell, 0.0);
+  for (int i = 0; i != nshell*nshell; ++i) {
+    schwarz[i] = std::sqrt(geom_->shellpair(i)->schwarz());
+    schwarzmax[i/nshell] = max(schwarzmax[i/nshell], schwarz[i]);
+  }
+
+  // shells that are significant for each orbital: s in crange contributes to (P|is) and r in krange is reached from them
+  auto add_range = [&](vector<pair<int,int>>& ranges, const int shell) {
+    if (!ranges.empty() && ranges.back().second == offset[shell])
+      ranges.back().second += size[shell];
+    else
+      ranges.emplace_back(offset[shell], offset[shell]+size[shell]);
+  };
+  vector<vector<pair<int,int>>> crange(nvec), krange(nvec);
+  size_t nsig = 0;
+  for (int i = 0; i != nvec; ++i) {
+    vector<double> cmax(nshell, 0.0);
+    for (int s = 0; s != nshell; ++s) {
+      for (int j = offset[s]; j != offset[s]+size[s]; ++j)
+        cmax[s] = max(cmax[s], fabs(lcoeff(j, i)));
+      if (cmax[s]*schwarzmax[s] > thresh)
+        add_range(crange[i], s);
+      else
+        cmax[s] = 0.0;
+    }
+    for (int r = 0; r != nshell; ++r) {
+      double bound = 0.0;
+      for (int s = 0; s != nshell; ++s)
+        bound += schwarz[r+nshell*s] * cmax[s];
+      if (bound > thresh) {
+        add_range(krange[i], r);
+        nsig += size[r];
+      }
+    }
+  }
+  if (nvec)
+    cout << "    * local exchange: " << setprecision(1) << fixed << 100.0*nsig/(static_cast<double>(nvec)*nbasis) << "% of the AOs are used" << endl;
+
+  return geom_->df()->compute_Kop_local(lcoeff.slice(0, nvec), crange, krange, -scale_exchange);
+}
+
+
 template class bagel::Fock<0>;
 template class bagel::Fock<1>;
 
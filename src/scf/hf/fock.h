@@ -33,11 +33,17 @@
 
 namespace bagel {
 
+class COSX;
+
 template<int DF>
 class Fock : public Fock_base {
   protected:
     void fock_two_electron_part(std::shared_ptr<const Matrix> den = nullptr);
-    void fock_two_electron_part_with_coeff(const MatView coeff, const bool rhf, const double scale_ex, const double scale_coulomb);
+    // when single is true, the DF exchange is computed with single-precision products
+    void fock_two_electron_part_with_coeff(const MatView coeff, const bool rhf, const double scale_ex, const double scale_coulomb, const double local_thresh,
+                                           std::shared_ptr<const COSX> cosx, const bool single);
+    // exchange from Cholesky-localized orbitals using only the AOs that are significant for each orbital
+    std::shared_ptr<Matrix> local_exchange(const MatView coeff, const double thresh, const double scale_ex) const;
 
     // when DF gradients are requested
     bool store_half_;
@@ -56,16 +62,18 @@ class Fock : public Fock_base {
     // Fock operator for DF cases
     template<int DF1 = DF, class = typename std::enable_if<DF1==1>::type>
     Fock(std::shared_ptr<const Geometry> a, std::shared_ptr<const Matrix> prev, std::shared_ptr<const Matrix> den,
-         const MatView ocoeff, const bool store = false, const bool rhf = false, const double scale_ex = 1.0, const double scale_coulomb = 1.0)
+         const MatView ocoeff, const bool store = false, const bool rhf = false, const double scale_ex = 1.0, const double scale_coulomb = 1.0,
+         const double local_thresh = 0.0, std::shared_ptr<const COSX> cosx = nullptr, const bool single = false)
      : Fock_base(a,prev,den), store_half_(store) {
-      fock_two_electron_part_with_coeff(ocoeff, rhf, scale_ex, scale_coulomb);
+      fock_two_electron_part_with_coeff(ocoeff, rhf, scale_ex, scale_coulomb, local_thresh, cosx, single);
       fock_one_electron_part();
     }
     // the same as above.
     template<typename T, class = typename std::enable_if<btas::is_boxtensor<T>::value>::type>
     Fock(std::shared_ptr<const Geometry> a, std::shared_ptr<const Matrix> prev, std::shared_ptr<const Matrix> den,
-         std::shared_ptr<T> ocoeff, const bool store = false, const bool rhf = false, const double scale_ex = 1.0, const double scale_coulomb = 1.0)
-     : Fock(a,prev,den,*ocoeff,store,rhf,scale_ex,scale_coulomb) {
+         std::shared_ptr<T> ocoeff, const bool store = false, const bool rhf = false, const double scale_ex = 1.0, const double scale_coulomb = 1.0,
+         const double local_thresh = 0.0, std::shared_ptr<const COSX> cosx = nullptr, const bool single = false)
+     : Fock(a,prev,den,*ocoeff,store,rhf,scale_ex,scale_coulomb,local_thresh,cosx,single) {
     }
 
     // Fock operator
@@ -25,10 +25,12 @@
 #include <src/scf/atomicdensities.h>
 #include <src/scf/hf/rhf.h>
 #include <src/scf/hf/fock.h>
+#include <src/util/math/aughess.h>
 #include <src/prop/multipole.h>
 #include <src/prop/sphmultipole.h>
 #include <src/scf/dhf/population_analysis.h>
 #include <src/util/muffle.h>
+#include <src/util/io/checkpoint.h>
 
 using namespace bagel;
 using namespace std;
@@ -47,6 +49,11 @@ RHF::RHF(const shared_ptr<const PTree> idata, const shared_ptr<const Geometry> g
     cout << "  level shift : " << setprecision(3) << lshift_ << endl << endl;
     levelshift_ = make_shared<ShiftVirtual<DistMatrix>>(nocc_, lshift_);
   }
+
+  thresh_second_ = idata->get<bool>("second_order", false) ? idata->get<double>("thresh_second_order", 1.0e-3) : 0.0;
+  max_micro_ = idata->get<int>("maxiter_micro", 10);
+  if (thresh_second_ > 0.0 && (!dodf_ || dofmm_))
+    throw runtime_error("second-order SCF is only implemented with density fitting");
 }
 
 
@@ -91,7 +98,7 @@ void RHF::compute() {
           aodensity_ = coeff_->form_density_rhf(nocc_);
           focka = make_shared<const Fock<0>>(geom_, hcore_, aodensity_, schwarz_);
         } else {
-          focka = make_shared<const Fock<1>>(geom_, hcore_, nullptr, coeff_->slice(0, nocc_), do_grad_, true/*rhf*/);
+          focka = make_shared<const Fock<1>>(geom_, hcore_, nullptr, coeff_->slice(0, nocc_), do_grad_, true/*rhf*/, 1.0, 1.0, thresh_local_exchange_, cosx());
         }
       } else {
         aodensity_ = coeff_->form_density_rhf(nocc_);
@@ -122,11 +129,35 @@ void RHF::compute() {
   // starting SCF iteration
   shared_ptr<const Matrix> densitychange = aodensity_;
 
+#ifndef DISABLE_SERIALIZATION
+  // distributed matrices are gathered when serialized, which all the processes have to take part in
+#ifdef HAVE_SCALAPACK
+  const bool background = false;
+#else
+  const bool background = true;
+#endif
+  // with restart_keep, archives are written in the background and only the last ones are kept
+  const int restart_keep = idata_->get<int>("restart_keep", 0);
+  shared_ptr<Checkpoint> checkpoint = restart_ && restart_keep > 0 ? make_shared<Checkpoint>("scf", restart_keep, background) : nullptr;
+#endif
+
+  bool single = dodf_ && !dofmm_ && thresh_single_ > 0.0;
+  // half-transformed integrals are kept for the Hessian once second-order steps are taken
+  bool second = false;
+  if (single)
+    cout << indent << "    * Single precision is used for the exchange until the error is below " << scientific << setprecision(1) << thresh_single_ << endl << endl;
+
   for (int iter = 0; iter != max_iter_; ++iter) {
     Timer pdebug(1);
 
 #ifndef DISABLE_SERIALIZATION
-    if (restart_) {
+    if (checkpoint) {
+      // the DIIS history is copied as it is updated in place
+      auto snapshot = make_shared<RHF>(*this);
+      if (diis_)
+        snapshot->diis_ = diis_->copy();
+      checkpoint->save<Method>(iter, snapshot);
+    } else if (restart_) {
       stringstream ss; ss << "scf_" << iter;
       OArchive archive(ss.str());
       archive << static_cast<Method*>(this);
@@ -138,7 +169,7 @@ void RHF::compute() {
         previous_fock = make_shared<Fock<0>>(geom_, previous_fock, densitychange, schwarz_);
         mpi__->broadcast(const_pointer_cast<Matrix>(previous_fock)->data(), previous_fock->size(), 0);
       } else {
-        previous_fock = make_shared<Fock<1>>(geom_, hcore_, nullptr, coeff_->slice(0, nocc_), do_grad_, true/*rhf*/);
+        previous_fock = make_shared<Fock<1>>(geom_, hcore_, nullptr, coeff_->slice(0, nocc_), do_grad_ || second, true/*rhf*/, 1.0, 1.0, thresh_local_exchange_, cosx(), single);
       }
     } else {
       shared_ptr<const Matrix> tmp = fmm_->compute_Fock_FMM(densitychange)->get_real_part();
@@ -150,7 +181,19 @@ void RHF::compute() {
     pdebug.tick_print("Fock build");
 
     auto error_vector = make_shared<const DistMatrix>(*fock**aodensity**overlap - *overlap**aodensity**fock);
-    const double error = error_vector->rms();
+    double error = error_vector->rms();
+
+    // the Fock matrix is rebuilt in double precision from the same orbitals; the energy difference estimates the error of single precision
+    if (single && error < thresh_single_) {
+      single = false;
+      const double esingle = energy_;
+      previous_fock = make_shared<Fock<1>>(geom_, hcore_, nullptr, coeff_->slice(0, nocc_), do_grad_ || second, true/*rhf*/, 1.0, 1.0, thresh_local_exchange_, cosx());
+      fock = previous_fock->distmatrix();
+      energy_  = 0.5*aodensity->dot_product(*hcore+*fock) + geom_->nuclear_repulsion();
+      error_vector = make_shared<const DistMatrix>(*fock**aodensity**overlap - *overlap**aodensity**fock);
+      error = error_vector->rms();
+      cout << indent << "    * Switched to double precision (energy change: " << scientific << setprecision(2) << energy_-esingle << ")" << endl;
+    }
 
     cout << indent << setw(5) << iter << setw(20) << fixed << setprecision(8) << energy_ << "   "
                                       << setw(17) << error << setw(15) << setprecision(2) << scftime.tick() << endl;
@@ -158,27 +201,58 @@ void RHF::compute() {
     if (error < thresh_scf_) {
       cout << indent << endl << indent << "  * SCF iteration converged." << endl << endl;
       if (do_grad_) half_ = dynamic_pointer_cast<const Fock<1>>(previous_fock)->half();
+      // second-order steps do not keep the orbitals canonical. The occupied and virtual blocks are diagonalized separately,
+      // so that the half-transformed integrals (built from the old occupied orbitals) can be rotated accordingly.
+      if (second) {
+        const int nmo = coeff_->mdim();
+        const Matrix fmo(*coeff_ % *previous_fock * *coeff_);
+        shared_ptr<Matrix> occ = fmo.get_submatrix(0, 0, nocc_, nocc_);
+        shared_ptr<Matrix> virt = fmo.get_submatrix(nocc_, nocc_, nmo-nocc_, nmo-nocc_);
+        occ->diagonalize(eig().slice(0, nocc_));
+        virt->diagonalize(eig().slice(nocc_, nmo));
+        Matrix rot(nmo, nmo);
+        rot.copy_block(0, 0, nocc_, nocc_, occ);
+        rot.copy_block(nocc_, nocc_, nmo-nocc_, nmo-nocc_, virt);
+        coeff_ = make_shared<const Coeff>(*coeff_ * rot);
+        coeff = coeff_->distmatrix();
+        if (half_) {
+          half_ = half_->copy();
+          half_->rotate_occ(occ);
+        }
+      }
       break;
     } else if (iter == max_iter_-1) {
       cout << indent << endl << indent << "  * Max iteration reached in SCF." << endl << endl;
       break;
     }
 
-    if (diis_ || iter >= diis_start_) {
-      fock = diis_->extrapolate({fock, error_vector});
-      pdebug.tick_print("DIIS");
-    }
+    if (second) {
+      coeff_ = second_order_step(previous_fock, dynamic_pointer_cast<const Fock<1>>(previous_fock)->half());
+      coeff = coeff_->distmatrix();
+      pdebug.tick_print("Second-order step");
+    } else {
+      if (diis_ || iter >= diis_start_) {
+        fock = diis_->extrapolate({fock, error_vector});
+        pdebug.tick_print("DIIS");
+      }
 
-    DistMatrix intermediate(*coeff % *fock * *coeff);
+      DistMatrix intermediate(*coeff % *fock * *coeff);
 
-    if (levelshift_)
-      levelshift_->shift(intermediate);
+      if (levelshift_)
+        levelshift_->shift(intermediate);
 
-    intermediate.diagonalize(eig());
-    pdebug.tick_print("Diag");
+      intermediate.diagonalize(eig());
+      pdebug.tick_print("Diag");
 
-    coeff = make_shared<const DistMatrix>(*coeff * intermediate);
-    coeff_ = make_shared<const Coeff>(*coeff->matrix());
+      coeff = make_shared<const DistMatrix>(*coeff * intermediate);
+      coeff_ = make_shared<const Coeff>(*coeff->matrix());
+
+      // the next Fock build keeps the half-transformed integrals for the Hessian
+      if (thresh_second_ > 0.0 && error < thresh_second_) {
+        second = true;
+        cout << indent << "    * Switching to second-order steps" << endl;
+      }
+    }
 
 
     if (!dodf_) {
@@ -211,6 +285,94 @@ void RHF::compute() {
 }
 
 
+shared_ptr<const Coeff> RHF::second_order_step(shared_ptr<const Matrix> fockao, shared_ptr<const DFHalfDist> half) const {
+  const int nmo = coeff_->mdim();
+  const int nvirt = nmo - nocc_;
+  const MatView ocoeff = coeff_->slice(0, nocc_);
+  const MatView vcoeff = coeff_->slice(nocc_, nmo);
+  shared_ptr<const DFDist> df = geom_->df();
+
+  const Matrix fock(*coeff_ % *fockao * *coeff_);
+  const Matrix foo = *fock.get_submatrix(0, 0, nocc_, nocc_);
+  const Matrix fvv = *fock.get_submatrix(nocc_, nocc_, nvirt, nvirt);
+
+  // gradient and diagonal Hessian with respect to the rotation C_i -> C_i + sum_a x_ai C_a
+  auto grad = make_shared<Matrix>(nvirt, nocc_);
+  auto denom = make_shared<Matrix>(nvirt, nocc_);
+  for (int i = 0; i != nocc_; ++i)
+    for (int a = 0; a != nvirt; ++a) {
+      (*grad)(a, i) = 4.0 * fock(a+nocc_, i);
+      (*denom)(a, i) = 4.0 * (fock(a+nocc_, a+nocc_) - fock(i, i));
+    }
+
+  // sigma_ai = 4 (F_ab x_bi - x_aj F_ji) + 4 [4(ai|bj) - (ab|ij) - (aj|bi)] x_bj
+  auto hessian_trial = [&](const Matrix& trot) {
+    auto sigma = make_shared<Matrix>((fvv * trot - trot * foo) * 4.0);
+    // X = C_v x C_o^T: the integrals are 2J(X+X^T) - K(X) - K(X)^T in the AO basis
+    const Matrix ct(vcoeff * trot);
+    shared_ptr<const Matrix> kx = df->compute_half_transform(ct)->apply_J()->form_2index(half, 1.0);
+    auto xs = make_shared<const Matrix>((ct ^ ocoeff) + (ocoeff ^ ct));
+    Matrix aomat(*df->compute_Jop(xs) * 2.0 - *kx - *kx->transpose());
+    *sigma += (vcoeff % aomat * ocoeff) * 4.0;
+    return sigma;
+  };
+
+  auto apply_denom = [&denom](const Matrix& r, const double shift, const double scale) {
+    auto out = make_shared<Matrix>(r);
+    for (int i = 0; i != out->size(); ++i)
+      if (fabs(denom->data()[i]*scale+shift) > 1.0e-12)
+        out->data()[i] /= denom->data()[i]*scale+shift;
+    return out;
+  };
+
+  // the first trial vector is normalized here; close to convergence its norm is below the threshold in AugHess::orthog
+  shared_ptr<Matrix> guess = apply_denom(*grad, 0.001, 1.0);
+  const double gnorm = guess->norm();
+  if (gnorm == 0.0)
+    return coeff_;
+  guess->scale(1.0/gnorm);
+
+  AugHess<Matrix> solver(max_micro_+1, grad);
+  vector<shared_ptr<Matrix>> trot{guess};
+  solver.orthog(trot);
+  for (int miter = 0; miter != max_micro_ && !trot.empty(); ++miter) {
+    shared_ptr<const Matrix> sigma = hessian_trial(*trot.front());
+    shared_ptr<const Matrix> residual;
+    double lambda, epsilon, stepsize;
+    tie(residual, lambda, epsilon, stepsize) = solver.compute_residual(trot.front(), sigma);
+    const double err = residual->norm() / lambda;
+    cout << indent << "         res : " << setw(8) << setprecision(2) << scientific << err
+                   <<       "   lamb: " << setw(8) << setprecision(2) << scientific << lambda
+                   <<       "   step: " << setw(8) << setprecision(2) << scientific << stepsize << endl;
+    if (err < max(0.1*thresh_scf_, 1.0e-2*grad->norm()))
+      break;
+    trot = {apply_denom(*residual, -epsilon, 1.0/lambda)};
+    solver.orthog(trot);
+  }
+
+  // rotation exp(A) with A_ai = x_ai and A_ia = -x_ai
+  shared_ptr<const Matrix> sol = solver.civec();
+  Matrix a(nmo, nmo);
+  for (int i = 0; i != nocc_; ++i)
+    for (int v = 0; v != nvirt; ++v) {
+      a(v+nocc_, i) = (*sol)(v, i);
+      a(i, v+nocc_) = -(*sol)(v, i);
+    }
+  Matrix w(a * a);
+  VectorB eig(nmo);
+  w.diagonalize(eig);
+  Matrix wc(w);
+  Matrix ws(w);
+  for (int i = 0; i != nmo; ++i) {
+    const double tau = sqrt(fabs(eig(i)));
+    blas::scale_n(cos(tau), wc.element_ptr(0,i), wc.ndim());
+    blas::scale_n(tau > 1.0e-15 ? sin(tau)/tau : 1.0, ws.element_ptr(0,i), ws.ndim());
+  }
+  const Matrix rot = (wc ^ w) + (ws ^ w) * a;
+  return make_shared<const Coeff>(*coeff_ * rot);
+}
+
+
 shared_ptr<const Reference> RHF::conv_to_ref() const {
   auto out = make_shared<Reference>(geom_, coeff(), nocc(), 0, coeff_->mdim()-nocc(), vector<double>{energy_});
   out->set_eig(eig_);
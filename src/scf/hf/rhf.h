@@ -42,6 +42,13 @@ class RHF : public SCF_base {
 
     std::shared_ptr<DIIS<DistMatrix>> diis_;
 
+    // second-order (augmented Hessian) steps are taken once the error is below this threshold (0.0 when not used)
+    double thresh_second_;
+    int max_micro_;
+
+    // returns the orbitals after one augmented-Hessian step using the exact Hessian; half is (P|ir) with J^-1/2 applied
+    std::shared_ptr<const Coeff> second_order_step(std::shared_ptr<const Matrix> fockao, std::shared_ptr<const DFHalfDist> half) const;
+
   private:
     // serialization
     friend class boost::serialization::access;
@@ -49,13 +56,13 @@ class RHF : public SCF_base {
     template<class Archive>
     void save(Archive& ar, const unsigned int) const {
       ar << boost::serialization::base_object<SCF_base>(*this);
-      ar << lshift_ << dodf_ << diis_;
+      ar << lshift_ << dodf_ << diis_ << thresh_second_ << max_micro_;
     }
 
     template<class Archive>
     void load(Archive& ar, const unsigned int) {
       ar >> boost::serialization::base_object<SCF_base>(*this);
-      ar >> lshift_ >> dodf_ >> diis_;
+      ar >> lshift_ >> dodf_ >> diis_ >> thresh_second_ >> max_micro_;
       if (lshift_ != 0.0)
         levelshift_ = std::make_shared<ShiftVirtual<DistMatrix>>(nocc_, lshift_);
       restarted_ = true;
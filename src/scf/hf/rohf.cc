@@ -50,8 +50,8 @@ void ROHF::compute() {
   Timer scftime;
   for (int iter = 0; iter != max_iter_; ++iter) {
 
-    shared_ptr<const Matrix> fockA = make_shared<const Fock<1>>(geom_, hcore_, aodensity_, coeff_->slice(0,nocc_));
-    shared_ptr<const Matrix> fockB = noccB_ ? make_shared<const Fock<1>>(geom_, hcore_, aodensity_, coeffB_->slice(0, noccB_))
+    shared_ptr<const Matrix> fockA = make_shared<const Fock<1>>(geom_, hcore_, aodensity_, coeff_->slice(0,nocc_), false, false, 1.0, 1.0, thresh_local_exchange_, cosx());
+    shared_ptr<const Matrix> fockB = noccB_ ? make_shared<const Fock<1>>(geom_, hcore_, aodensity_, coeffB_->slice(0, noccB_), false, false, 1.0, 1.0, thresh_local_exchange_, cosx())
                                             : make_shared<const Matrix>(geom_->nbasis(), geom_->nbasis());
 
     shared_ptr<const Coeff> natorb = get<0>(natural_orbitals());
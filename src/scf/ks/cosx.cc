@@ -0,0 +1,126 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: cosx.cc
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+
+#include <src/scf/ks/cosx.h>
+#include <src/integral/rys/naibatch.h>
+#include <src/util/taskqueue.h>
+#include <src/util/parallel/mpi_interface.h>
+
+using namespace std;
+using namespace bagel;
+
+constexpr int COSX::batchsize_;
+
+
+COSX::COSX(shared_ptr<const Geometry> geom, const int nrad, const int nang, const double thresh) : geom_(geom), thresh_(thresh) {
+  Timer time;
+  cout << "    * Seminumerical exchange with " << nrad << " radial and " << nang << " angular points" << endl;
+  grid_ = make_shared<TALGrid>(nrad, nang, geom);
+  time.tick_print("COSX grid generation");
+
+  for (int n = 0; n != geom_->natom(); ++n) {
+    const vector<shared_ptr<const Shell>>& sh = geom_->atoms(n)->shells();
+    shells_.insert(shells_.end(), sh.begin(), sh.end());
+    offset_.insert(offset_.end(), geom_->offset(n).begin(), geom_->offset(n).end());
+  }
+  const int nshell = shells_.size();
+  schwarz_.resize(nshell*nshell);
+  for (int i = 0; i != nshell*nshell; ++i)
+    schwarz_[i] = sqrt(geom_->shellpair(i)->schwarz());
+}
+
+
+shared_ptr<Matrix> COSX::compute_exchange(const MatView ocoeff, const double fac) const {
+  shared_ptr<const Grid> grid = grid_->grid();
+  const int nbasis = geom_->nbasis();
+  const int nshell = shells_.size();
+
+  // grid points are distributed over processes
+  StaticDist pdist(grid->size(), mpi__->size());
+  const size_t gstart = pdist.start(mpi__->rank());
+  const size_t gsize = pdist.size(mpi__->rank());
+
+  auto out = make_shared<Matrix>(nbasis, nbasis);
+  if (gsize) {
+    const Matrix oc(ocoeff);
+    shared_ptr<const Matrix> basis = grid->basis()->slice_copy(gstart, gstart+gsize);
+    // density-weighted basis functions F_s(g) = sum_ri C_si C_ri X_r(g)
+    const Matrix f = oc * (oc % *basis);
+    // G_t(g) = sum_s A_ts(g) F_s(g)
+    Matrix g(nbasis, gsize);
+
+    StaticDist bdist(gsize, (gsize-1)/batchsize_+1);
+    vector<pair<size_t, size_t>> table = bdist.atable();
+    TaskQueue<function<void(void)>> tasks(table.size());
+    for (auto& b : table)
+      tasks.emplace_back([&, b]() {
+        vector<double> fmax(nshell, 0.0);
+        for (int s = 0; s != nshell; ++s)
+          for (size_t p = b.first; p != b.first+b.second; ++p)
+            for (int j = offset_[s]; j != offset_[s]+shells_[s]->nbasis(); ++j)
+              fmax[s] = max(fmax[s], fabs(f(j, p)));
+
+        // A_ts = A_st, so that each pair is computed once
+        vector<pair<int,int>> pairs;
+        for (int t = 0; t != nshell; ++t)
+          for (int s = 0; s <= t; ++s)
+            if (schwarz_[t+nshell*s]*max(fmax[s], fmax[t]) > thresh_)
+              pairs.emplace_back(t, s);
+
+        for (size_t p = b.first; p != b.first+b.second; ++p) {
+          const array<double,3> position{{grid->data()->element(0, gstart+p), grid->data()->element(1, gstart+p), grid->data()->element(2, gstart+p)}};
+          // a unit negative charge so that NAIBatch returns the potential integrals with the positive sign
+          auto point = make_shared<const Molecule>(vector<shared_ptr<const Atom>>{make_shared<const Atom>(geom_->spherical(), "q", position, -1.0)},
+                                                   vector<shared_ptr<const Atom>>());
+          for (auto& ts : pairs) {
+            const int t = ts.first;
+            const int s = ts.second;
+            NAIBatch nai({{shells_[t], shells_[s]}}, point);
+            nai.compute();
+            const double* data = nai.data();
+            const int nt = shells_[t]->nbasis();
+            const int ns = shells_[s]->nbasis();
+            for (int j = 0; j != ns; ++j)
+              for (int i = 0; i != nt; ++i) {
+                g(offset_[t]+i, p) += data[i+nt*j] * f(offset_[s]+j, p);
+                if (s != t)
+                  g(offset_[s]+j, p) += data[i+nt*j] * f(offset_[t]+i, p);
+              }
+          }
+        }
+      });
+    tasks.compute();
+
+    // K_rt = sum_g w_g X_r(g) G_t(g)
+    for (size_t p = 0; p != gsize; ++p)
+      blas::scale_n(grid->weight(gstart+p), g.element_ptr(0, p), nbasis);
+    *out = *basis ^ g;
+  }
+  out->allreduce();
+  // the quadrature breaks the symmetry of the exchange matrix
+  out->symmetrize();
+  out->scale(fac);
+  return out;
+}
@@ -0,0 +1,62 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: cosx.h
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+
+#ifndef __SRC_KS_COSX_H
+#define __SRC_KS_COSX_H
+
+#include <src/scf/ks/dftgrid.h>
+
+namespace bagel {
+
+/// Seminumerical (chain-of-spheres) exchange.
+/** The exchange integrals are approximated as (rs|tu) = sum_g w_g X_r(g) X_s(g) A_tu(g), where X are the basis functions on the grid
+    and A_tu(g) are the potential integrals of the pair tu at the grid point g, computed analytically with NAIBatch.
+    Grid points are distributed over processes and processed in batches by threads; in each batch, shell pairs are
+    screened by the products of the Schwarz integrals and the largest density-weighted basis function. */
+class COSX {
+  protected:
+    const std::shared_ptr<const Geometry> geom_;
+    std::shared_ptr<const DFTGrid_base> grid_;
+    const double thresh_;
+
+    std::vector<std::shared_ptr<const Shell>> shells_;
+    std::vector<int> offset_;
+    // square roots of (rs|rs) for each pair of shells
+    std::vector<double> schwarz_;
+
+    static constexpr int batchsize_ = 128;
+
+  public:
+    COSX(std::shared_ptr<const Geometry> geom, const int nrad, const int nang, const double thresh);
+
+    // returns fac * sum_i (rs|tu) C_si C_ui for the given orbitals
+    std::shared_ptr<Matrix> compute_exchange(const MatView ocoeff, const double fac) const;
+
+    std::shared_ptr<const DFTGrid_base> grid() const { return grid_; }
+};
+
+}
+
+#endif
@@ -51,6 +51,8 @@ class DFTGrid_base {
     std::tuple<std::shared_ptr<const Matrix>,double> compute_xc(std::shared_ptr<const XCFunc> func, std::shared_ptr<const Matrix> mat) const;
     std::shared_ptr<const GradFile> compute_xcgrad(std::shared_ptr<const XCFunc> func, std::shared_ptr<const Matrix> mat) const;
     double fuzzy_cell(std::shared_ptr<const Atom> a, std::array<double,3>&& x) const;
+
+    std::shared_ptr<const Grid> grid() const { return grid_; }
 };
 
 
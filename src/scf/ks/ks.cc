@@ -47,11 +47,15 @@ void KS::compute() {
 
   shared_ptr<Matrix> fock;
 
+  bool single = thresh_single_ > 0.0 && func_->scale_ex() != 0.0;
+  if (single)
+    cout << indent << "     - Single precision is used for the exchange until the error is below " << scientific << setprecision(1) << thresh_single_ << endl << endl;
+
   Timer scftime;
   for (int iter = 0; iter != max_iter_; ++iter) {
 
     // fock operator without DFT xc
-    fock = make_shared<Fock<1>>(geom_, hcore_, aodensity_, coeff_->slice(0, nocc_), false /*store*/, true /*rhf*/, func_->scale_ex());
+    fock = make_shared<Fock<1>>(geom_, hcore_, aodensity_, coeff_->slice(0, nocc_), false /*store*/, true /*rhf*/, func_->scale_ex(), 1.0, thresh_local_exchange_, cosx(), single);
 
     // add xc
     shared_ptr<const Matrix> xc;
@@ -64,7 +68,19 @@ void KS::compute() {
 
     auto error_vector = make_shared<const Matrix>(*fock**aodensity_**overlap_ - *overlap_**aodensity_**fock);
 
-    const double error = error_vector->rms();
+    double error = error_vector->rms();
+
+    // the Fock matrix is rebuilt in double precision from the same orbitals; the energy difference estimates the error of single precision
+    if (single && error < thresh_single_) {
+      single = false;
+      const double esingle = energy_;
+      fock = make_shared<Fock<1>>(geom_, hcore_, aodensity_, coeff_->slice(0, nocc_), false /*store*/, true /*rhf*/, func_->scale_ex(), 1.0, thresh_local_exchange_, cosx());
+      energy_ = 0.5*((*hcore_+ *fock) * *aodensity_).trace() + exc + geom_->nuclear_repulsion();
+      *fock += *xc;
+      error_vector = make_shared<const Matrix>(*fock**aodensity_**overlap_ - *overlap_**aodensity_**fock);
+      error = error_vector->rms();
+      cout << indent << "     - Switched to double precision (energy change: " << scientific << setprecision(2) << energy_-esingle << ")" << endl;
+    }
 
     cout << indent << setw(5) << iter << setw(20) << fixed << setprecision(8) << energy_ << "   "
                                       << setw(17) << error << setw(15) << setprecision(2) << scftime.tick() << endl;
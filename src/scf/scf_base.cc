@@ -24,6 +24,7 @@
 
 
 #include <src/scf/scf_base.h>
+#include <src/scf/ks/cosx.h>
 #include <src/wfn/zreference.h>
 #include <src/util/timer.h>
 #include <src/util/math/diis.h>
@@ -60,6 +61,8 @@ SCF_base_<MatType, OvlType, HcType, Enable>::SCF_base_(shared_ptr<const PTree> i
   thresh_overlap_ = idata_->get<double>("thresh_overlap", 1.0e-8);
   thresh_scf_ = idata_->get<double>("thresh", 1.0e-8);
   thresh_scf_ = idata_->get<double>("thresh_scf", thresh_scf_);
+  thresh_local_exchange_ = idata_->get<bool>("local_exchange", false) ? idata_->get<double>("thresh_local_exchange", 1.0e-8) : 0.0;
+  thresh_single_ = idata_->get<bool>("single_precision", false) ? max(idata_->get<double>("thresh_single", 1.0e-4), thresh_scf_) : 0.0;
 
   if (dofmm_) {
     const bool dodf = idata_->get<bool>("df", true);
@@ -100,6 +103,14 @@ void SCF_base_<MatType, OvlType, HcType, Enable>::init_schwarz() {
 }
 
 
+template <typename MatType, typename OvlType, typename HcType, class Enable>
+shared_ptr<const COSX> SCF_base_<MatType, OvlType, HcType, Enable>::cosx() {
+  if (!cosx_ && idata_->get<string>("exchange", "df") == "cosx")
+    cosx_ = make_shared<const COSX>(geom_, idata_->get<int>("cosx_nrad", 50), idata_->get<int>("cosx_nang", 110), idata_->get<double>("thresh_cosx", 1.0e-10));
+  return cosx_;
+}
+
+
 // Specialized for GIAO
 template <>
 void SCF_base_<ZMatrix, ZOverlap, ZHcore, enable_if<true>::type>::get_coeff(const shared_ptr<const Reference> ref) {
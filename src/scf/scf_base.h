@@ -36,6 +36,8 @@
 
 namespace bagel {
 
+class COSX;
+
 template <typename MatType = Matrix, typename OvlType = Overlap, typename HcType = Hcore,
           class Enable = typename std::enable_if<((std::is_same<MatType, Matrix>::value && std::is_same<OvlType, Overlap>::value && std::is_same<HcType, Hcore>::value)
                       || (std::is_same<MatType, ZMatrix>::value && std::is_same<OvlType, ZOverlap>::value && std::is_same<HcType, ZHcore>::value))>::type>
@@ -54,6 +56,13 @@ class SCF_base_ : public Method {
 
     double thresh_overlap_;
     double thresh_scf_;
+    // screening threshold for the exchange from localized orbitals (0.0 when not used)
+    double thresh_local_exchange_;
+    // seminumerical exchange; built from the input on the first call to cosx() and not serialized
+    std::shared_ptr<const COSX> cosx_;
+    std::shared_ptr<const COSX> cosx();
+    // the DF exchange is computed in single precision until the error is below this threshold (0.0 when not used)
+    double thresh_single_;
     int multipole_print_;
     int dma_print_;
 
@@ -87,12 +96,13 @@ class SCF_base_ : public Method {
     void serialize(Archive& ar, const unsigned int) {
       ar & boost::serialization::base_object<Method>(*this);
       ar & tildex_ & overlap_ & hcore_ & coeff_ & max_iter_ & diis_start_ & diis_size_
-         & thresh_overlap_ & thresh_scf_ & multipole_print_ & schwarz_ & eig_ & energy_
-         & nocc_ & noccB_ & do_grad_ & restart_;
+         & thresh_overlap_ & thresh_scf_ & multipole_print_ & dma_print_ & schwarz_ & eig_ & energy_
+         & nocc_ & noccB_ & do_grad_ & restart_ & thresh_local_exchange_ & thresh_single_;
     }
 
   public:
-    SCF_base_() { }
+    // FMM is not restored from archives (fmm_ is not serialized)
+    SCF_base_() : dofmm_(false) { }
     SCF_base_(std::shared_ptr<const PTree> idata_, std::shared_ptr<const Geometry>, std::shared_ptr<const Reference>, const bool need_schwarz = false);
     virtual ~SCF_base_() { }
 
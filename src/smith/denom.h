@@ -83,12 +83,9 @@ class Denom {
   public:
     Denom(std::shared_ptr<const MatType> fock, const int nstates, const double thresh_overlap);
 
-    // add RDMs (using fock-multiplied 4RDM)
+    // add RDMs (using fock-multiplied 4RDM, see FCI::rdm34f)
     void append(const int jst, const int ist, std::shared_ptr<const RDM<1,DataType>>, std::shared_ptr<const RDM<2,DataType>>,
                                               std::shared_ptr<const RDM<3,DataType>>, std::shared_ptr<const RDM<3,DataType>>);
-    // add RDMs (using original 4RDM)
-    void append(const int jst, const int ist, std::shared_ptr<const RDM<1,DataType>>, std::shared_ptr<const RDM<2,DataType>>,
-                                              std::shared_ptr<const RDM<3,DataType>>, std::shared_ptr<const RDM<4,DataType>>);
     // add RDMs (using Kramers-reduced 4RDM)
     void append(const int jst, const int ist, std::shared_ptr<const RDM<1,DataType>>, std::shared_ptr<const RDM<2,DataType>>,
                                               std::shared_ptr<const RDM<3,DataType>>, std::shared_ptr<const Kramers<8,RDM<4,DataType>>>);
@@ -196,15 +196,24 @@ void K2ext<double>::init() {
   Tensor_<double> ext(vector<IndexRange>{aux, blocks_[0], blocks_[1]});
   ext.allocate();
 
+  // orbitals spanned by the virtual blocks
+  size_t vstart = blocks_[1].front().offset();
+  size_t vfence = vstart;
+  for (auto& i1 : blocks_[1]) {
+    vstart = min(vstart, i1.offset());
+    vfence = max(vfence, i1.offset()+i1.size());
+  }
+
   // occ loop
   for (auto& i0 : blocks_[0]) {
-    shared_ptr<DFHalfDist> df_half = df->compute_half_transform(coeff_->slice(i0.offset(), i0.offset()+i0.size()))->apply_J();
+    // transformed for all the virtual blocks at once
+    shared_ptr<DFFullDist> df_full = df->compute_full_transform(coeff_->slice(i0.offset(), i0.offset()+i0.size()), coeff_->slice(vstart, vfence), 1);
+    const size_t asize = df_full->block(0)->asize();
     // virtual loop
     for (auto& i1 : blocks_[1]) {
-      shared_ptr<DFFullDist> df_full = df_half->compute_second_transform(coeff_->slice(i1.offset(), i1.offset()+i1.size()));
-      const size_t bufsize = df_full->block(0)->size();
+      const size_t bufsize = asize*i0.size()*i1.size();
       unique_ptr<double[]> buf(new double[bufsize]);
-      copy_n(df_full->block(0)->data(), bufsize, buf.get());
+      copy_n(df_full->block(0)->data()+asize*i0.size()*(i1.offset()-vstart), bufsize, buf.get());
 
       for (auto& a : aux)
         if (a.offset() == df->block(0)->astart())
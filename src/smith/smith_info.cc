@@ -95,8 +95,14 @@ tuple<shared_ptr<const RDM<1>>, shared_ptr<const RDM<2>>> SMITH_Info<double>::rd
 
 
 template<>
-tuple<shared_ptr<const RDM<3>>, shared_ptr<const RDM<4>>> SMITH_Info<double>::rdm34(const int ist, const int jst) const {
-  return ref_->rdm34(ist, jst);
+tuple<shared_ptr<const PackedRDM<3>>, shared_ptr<const PackedRDM<4>>> SMITH_Info<double>::rdm34(const int ist, const int jst) const {
+  return ref_->rdm34_packed(ist, jst);
+}
+
+
+template<>
+tuple<shared_ptr<const RDM<3>>, shared_ptr<const RDM<3>>> SMITH_Info<double>::rdm34f(const int ist, const int jst, shared_ptr<const Matrix> fock) const {
+  return ref_->rdm34f(ist, jst, fock);
 }
 
 
@@ -122,6 +128,13 @@ tuple<shared_ptr<const Kramers<6,ZRDM<3>>>, shared_ptr<const Kramers<8,ZRDM<4>>>
 }
 
 
+template<>
+tuple<shared_ptr<const ZRDM<3>>, shared_ptr<const ZRDM<3>>>
+  SMITH_Info<complex<double>>::rdm34f(const int ist, const int jst, shared_ptr<const ZMatrix> fock) const {
+  throw logic_error("SMITH_Info<complex<double>>::rdm34f is not implemented; use the Kramers-reduced 4RDM");
+}
+
+
 template<>
 shared_ptr<const RDM<1>> SMITH_Info<double>::rdm1_av() const {
   return ref_->rdm1_av();
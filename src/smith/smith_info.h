@@ -35,6 +35,8 @@ class SMITH_Info {
     using MatType = typename std::conditional<std::is_same<DataType,double>::value,Matrix,ZMatrix>::type;
     template<int N>
     using RDMType = typename std::conditional<std::is_same<DataType,double>::value,RDM<N>,Kramers<N*2,ZRDM<N>>>::type;
+    template<int N>
+    using PackedRDMType = typename std::conditional<std::is_same<DataType,double>::value,PackedRDM<N>,Kramers<N*2,ZRDM<N>>>::type;
     using CIWfnT  = typename std::conditional<std::is_same<DataType,double>::value,CIWfn,RelCIWfn>::type;
 
     std::shared_ptr<const Reference> ref_;
@@ -79,7 +81,10 @@ class SMITH_Info {
     std::shared_ptr<const RDM<1,DataType>> rdm1_av() const;
 
     std::tuple<std::shared_ptr<const RDMType<1>>, std::shared_ptr<const RDMType<2>>> rdm12(const int ist, const int jst, const bool recompute = false) const;
-    std::tuple<std::shared_ptr<const RDMType<3>>, std::shared_ptr<const RDMType<4>>> rdm34(const int ist, const int jst) const;
+    // the non-relativistic 3 and 4RDMs are returned in the packed format
+    std::tuple<std::shared_ptr<const PackedRDMType<3>>, std::shared_ptr<const PackedRDMType<4>>> rdm34(const int ist, const int jst) const;
+    // 3RDM and the 4RDM contracted with a Fock matrix over its last index pair
+    std::tuple<std::shared_ptr<const RDM<3,DataType>>, std::shared_ptr<const RDM<3,DataType>>> rdm34f(const int ist, const int jst, std::shared_ptr<const MatType> fock) const;
 
     double thresh() const { return thresh_; }
     double shift() const {return shift_; }
@@ -123,11 +128,15 @@ class SMITH_Info {
 };
 
 template<> std::tuple<std::shared_ptr<const RDM<1>>, std::shared_ptr<const RDM<2>>> SMITH_Info<double>::rdm12(const int ist, const int jst, const bool recompute) const;
-template<> std::tuple<std::shared_ptr<const RDM<3>>, std::shared_ptr<const RDM<4>>> SMITH_Info<double>::rdm34(const int ist, const int jst) const;
+template<> std::tuple<std::shared_ptr<const PackedRDM<3>>, std::shared_ptr<const PackedRDM<4>>> SMITH_Info<double>::rdm34(const int ist, const int jst) const;
+template<> std::tuple<std::shared_ptr<const RDM<3>>, std::shared_ptr<const RDM<3>>>
+           SMITH_Info<double>::rdm34f(const int ist, const int jst, std::shared_ptr<const Matrix> fock) const;
 template<> std::tuple<std::shared_ptr<const Kramers<2,ZRDM<1>>>, std::shared_ptr<const Kramers<4,ZRDM<2>>>>
            SMITH_Info<std::complex<double>>::rdm12(const int ist, const int jst, const bool recompute) const;
 template<> std::tuple<std::shared_ptr<const Kramers<6,ZRDM<3>>>, std::shared_ptr<const Kramers<8,ZRDM<4>>>>
            SMITH_Info<std::complex<double>>::rdm34(const int ist, const int jst) const;
+template<> std::tuple<std::shared_ptr<const ZRDM<3>>, std::shared_ptr<const ZRDM<3>>>
+           SMITH_Info<std::complex<double>>::rdm34f(const int ist, const int jst, std::shared_ptr<const ZMatrix> fock) const;
 
 template<> std::shared_ptr<const CIWfn>   SMITH_Info<double>::ciwfn() const;
 template<> std::shared_ptr<const Matrix>  SMITH_Info<double>::coeff() const;
@@ -27,6 +27,7 @@
 
 #include <src/smith/tensor.h>
 #include <src/util/kramers.h>
+#include <src/wfn/packedrdm.h>
 
 namespace bagel {
 namespace SMITH {
@@ -88,6 +89,35 @@ static std::shared_ptr<Tensor_<DataType>>
 }
 
 
+template<int N, typename DataType>
+static std::shared_ptr<Tensor_<DataType>>
+  fill_block(std::shared_ptr<const PackedRDM<N/2,DataType>> input, const std::vector<int>& inpoffsets_rev, const std::vector<IndexRange>& ranges_rev) {
+  static_assert(N % 2 == 0, "PackedRDM has an even number of indices");
+
+  auto target = std::make_shared<Tensor_<DataType>>(ranges_rev);
+  target->allocate();
+
+  // the blocks are unpacked one by one, so that the full RDM is never formed
+  std::vector<std::vector<Index>> loop = LoopGenerator::gen(std::vector<IndexRange>(ranges_rev.rbegin(), ranges_rev.rend()));
+  for (auto& indices_rev : loop) {
+    const std::vector<Index> indices(indices_rev.rbegin(), indices_rev.rend());
+    if (!target->is_local(indices)) continue;
+
+    std::array<int,N> offset, size;
+    for (int i = 0; i != N; ++i) {
+      offset[i] = indices[i].offset() - inpoffsets_rev[i];
+      size[i] = indices[i].size();
+    }
+    const size_t buffersize = std::accumulate(size.begin(), size.end(), 1ul, std::multiplies<size_t>());
+    std::unique_ptr<DataType[]> buffer(new DataType[buffersize]);
+    input->unpack_block(offset, size, buffer.get());
+    target->put_block(buffer, indices);
+  }
+  mpi__->barrier();
+  return target;
+}
+
+
 template<int N, typename DataType, class T> // T is supposed to be derived from btas::Tensor
 static std::shared_ptr<Tensor_<DataType>>
   fill_block(std::shared_ptr<const Kramers<N,T>> input, const std::vector<int>& inpoffsets_rev, const std::vector<IndexRange>& ranges_rev) {
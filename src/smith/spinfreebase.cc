@@ -283,13 +283,14 @@ void SpinFreeMethod<double>::feed_rdm_denom() {
       shared_ptr<const RDM<1>> rdm1;
       shared_ptr<const RDM<2>> rdm2;
       shared_ptr<const RDM<3>> rdm3;
-      shared_ptr<const RDM<4>> rdm4; // TODO to be removed
+      shared_ptr<const RDM<3>> frdm4;
+      shared_ptr<const PackedRDM<3>> prdm3;
+      shared_ptr<const PackedRDM<4>> prdm4;
       tie(rdm1, rdm2) = info_->rdm12(jst, ist, (nstates > 1 && info_->do_xms()));
-      tie(rdm3, rdm4) = info_->rdm34(jst, ist);
-      shared_ptr<RDM<3>> frdm4 = rdm3->clone();
-      auto rdm4v = group(group(*rdm4, 6,8), 0,6);
-      auto frdm4v = group(*frdm4, 0, 6);
-      contract(1.0, rdm4v, {0,1}, group(*fockact_,0,2), {1}, 0.0, frdm4v, {0});
+      // 3RDM and Fock-weighted 4RDM for the denominators, computed without the 4RDM
+      tie(rdm3, frdm4) = info_->rdm34f(jst, ist, fockact_);
+      // the 3 and 4RDMs for the Gamma tensors are kept packed and unpacked block by block
+      tie(prdm3, prdm4) = info_->rdm34(jst, ist);
 
       unique_ptr<double[]> data0(new double[1]);
       data0[0] = jst == ist ? 1.0 : 0.0;
@@ -299,8 +300,8 @@ void SpinFreeMethod<double>::feed_rdm_denom() {
         rdm0t->put_block(data0);
       auto rdm1t = fill_block<2,double>(rdm1, vector<int>(2,nclo), vector<IndexRange>(2,active_));
       auto rdm2t = fill_block<4,double>(rdm2, vector<int>(4,nclo), vector<IndexRange>(4,active_));
-      auto rdm3t = fill_block<6,double>(rdm3, vector<int>(6,nclo), vector<IndexRange>(6,active_));
-      auto rdm4t = fill_block<8,double>(rdm4, vector<int>(8,nclo), vector<IndexRange>(8,active_));
+      auto rdm3t = fill_block<6,double>(prdm3, vector<int>(6,nclo), vector<IndexRange>(6,active_));
+      auto rdm4t = fill_block<8,double>(prdm4, vector<int>(8,nclo), vector<IndexRange>(8,active_));
 
       rdm0all_->emplace(jst, ist, rdm0t);
       rdm1all_->emplace(jst, ist, rdm1t);
@@ -170,6 +170,10 @@ class StorageIncore : public RMAWindow<DataType> {
     // for Kramers storage
     virtual void set_perm(const std::map<std::vector<int>, std::pair<double,bool>>& p) { }
     virtual void set_stored_sectors(const std::list<std::vector<bool>>& p) { }
+    // false if the block is obtained from another one by time-reversal or permutation symmetry
+    virtual bool is_unique(const std::vector<Index>& indices) const { return true; }
+    template<typename ...args>
+    bool is_unique(const Index& i, args&& ...p) const { return is_unique(arg_convert(i, p...)); }
 };
 
 extern template class StorageIncore<double>;
@@ -39,37 +39,66 @@ class StorageKramers : public StorageIncore<DataType> {
     std::list<std::vector<bool>> stored_sectors_;
     std::map<std::vector<int>, std::pair<double,bool>> perm_;
 
-    template<int N>
-    std::pair<std::vector<int>, std::pair<double,bool>> find_permutation(const KTag<N>& tag) const {
-      auto trans = std::make_pair(std::vector<int>{0}, std::make_pair(0.0,false));
-      for (auto& i : perm_)
+    // Lookup tables indexed by the Kramers bits of a block (bit i is set if the i-th index is a Kramers-barred one).
+    // For the sectors that are not stored, perm_lookup_ holds the permutation, factor and conjugation that map a stored sector
+    // onto them (the factor is zero if there is none). They are updated whenever perm_ or stored_sectors_ is set.
+    std::vector<bool> stored_lookup_;
+    std::vector<std::pair<std::vector<int>, std::pair<double,bool>>> perm_lookup_;
+
+    static size_t kramers_key(const std::vector<Index>& indices) {
+      size_t out = 0;
+      for (int i = 0; i != indices.size(); ++i)
+        if (indices[i].kramers())
+          out |= (1ul << i);
+      return out;
+    }
+
+    void update_lookup() {
+      stored_lookup_.clear();
+      perm_lookup_.clear();
+      if (stored_sectors_.empty())
+        return;
+      const int n = stored_sectors_.front().size();
+      stored_lookup_.resize(1ul << n, false);
+      perm_lookup_.resize(1ul << n, std::make_pair(std::vector<int>{0}, std::make_pair(0.0,false)));
+
+      std::vector<bool> found(1ul << n, false);
+      for (auto& j : stored_sectors_) {
+        assert(j.size() == n);
+        size_t key = 0;
+        for (int k = 0; k != n; ++k)
+          if (j[k]) key |= (1ul << k);
+        stored_lookup_[key] = true;
+      }
+      // the first match in the order of perm_ and stored_sectors_ is used
+      for (auto& i : perm_) {
+        assert(i.first.size() == n);
         for (auto& j : stored_sectors_) {
-          const KTag<N> ctag(j);
-          if (tag == ctag.perm(i.first)) {
-            trans = i;
-            goto end;
+          size_t key = 0;
+          for (int k = 0; k != n; ++k)
+            if (j[i.first[k]]) key |= (1ul << k);
+          if (!found[key]) {
+            found[key] = true;
+            perm_lookup_[key] = i;
           }
         }
-      end:
-      return trans;
+      }
     }
 
     template<typename... args>
     std::unique_ptr<DataType[]> get_block_(args&& ...key) const {
       constexpr const size_t N = sizeof...(key);
       std::vector<Index> indices = arg_convert(key...);
-      std::vector<bool> kramers(N);
-      for (int i = 0; i != N; ++i)
-        kramers[i] = indices[i].kramers();
+      assert(stored_lookup_.empty() || stored_lookup_.size() == (1ul << N));
+      const size_t kkey = kramers_key(indices);
 
       // if this block is stored return immediately
-      auto iter = std::find(stored_sectors_.begin(), stored_sectors_.end(), kramers);
-      if (iter != stored_sectors_.end())
+      if (is_unique(indices))
         return RMAWindow<DataType>::rma_get(generate_hash_key(key...));
 
-      // if not, first find the right permutation
-      const KTag<N> tag(kramers);
-      std::pair<std::vector<int>, std::pair<double,bool>> trans = find_permutation(tag);
+      // if not, use the permutation that maps a stored sector onto this block
+      const std::pair<std::vector<int>, std::pair<double,bool>> trans = perm_lookup_.empty() ? std::make_pair(std::vector<int>{0}, std::make_pair(0.0,false))
+                                                                                             : perm_lookup_[kkey];
       // allocate output area
       size_t buffersize = 1ull;
       for (auto& i : indices)
@@ -109,10 +138,7 @@ class StorageKramers : public StorageIncore<DataType> {
 
     void put_block_(const std::unique_ptr<DataType[]>& dat, std::vector<Index> indices) {
 #ifndef NDEBUG
-      std::vector<bool> kramers(indices.size());
-      for (int i = 0; i != indices.size(); ++i)
-        kramers[i] = indices[i].kramers();
-      if (std::find(stored_sectors_.begin(), stored_sectors_.end(), kramers) == stored_sectors_.end())
+      if (!is_unique(indices))
         throw std::logic_error("Kramers::put_block should only be called for existing blocks");
 #endif
       RMAWindow<DataType>::rma_put(dat, generate_hash_key(indices));
@@ -125,10 +151,7 @@ class StorageKramers : public StorageIncore<DataType> {
 
     void add_block_(const std::unique_ptr<DataType[]>& dat, std::vector<Index> indices) {
 #ifndef NDEBUG
-      std::vector<bool> kramers(indices.size());
-      for (int i = 0; i != indices.size(); ++i)
-        kramers[i] = indices[i].kramers();
-      if (std::find(stored_sectors_.begin(), stored_sectors_.end(), kramers) == stored_sectors_.end())
+      if (!is_unique(indices))
         throw std::logic_error("Kramers::add_block should only be called for existing blocks");
 #endif
       RMAWindow<DataType>::rma_add(dat, generate_hash_key(indices));
@@ -186,8 +209,14 @@ class StorageKramers : public StorageIncore<DataType> {
     void add_block(const std::unique_ptr<DataType[]>& dat, const Index& i0, const Index& i1, const Index& i2, const Index& i3,
                                                            const Index& i4, const Index& i5, const Index& i6, const Index& i7) override;
 
-    void set_perm(const std::map<std::vector<int>, std::pair<double,bool>>& p) override { perm_ = p; }
-    void set_stored_sectors(const std::list<std::vector<bool>>& s) override { stored_sectors_ = s; }
+    void set_perm(const std::map<std::vector<int>, std::pair<double,bool>>& p) override { perm_ = p; update_lookup(); }
+    void set_stored_sectors(const std::list<std::vector<bool>>& s) override { stored_sectors_ = s; update_lookup(); }
+
+    // returns true if the block belongs to a stored sector
+    bool is_unique(const std::vector<Index>& indices) const override {
+      assert(stored_lookup_.empty() || stored_lookup_.size() == (1ul << indices.size()));
+      return !stored_lookup_.empty() && stored_lookup_[kramers_key(indices)];
+    }
 
 };
 
@@ -77,6 +77,9 @@ class Tensor_ {
 
     template<typename ...args>
     bool is_local(args&& ...p) const { return data_->is_local(std::forward<args>(p)...); }
+    // false for the blocks of Kramers tensors that are not stored (always true for standard tensors)
+    template<typename ...args>
+    bool is_unique(args&& ...p) const { return data_->is_unique(std::forward<args>(p)...); }
     template<typename ...args>
     bool exists(args&& ...p) const { return sparse_.empty() || sparse_.count(generate_hash_key(std::forward<args>(p)...)); }
 
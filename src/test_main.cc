@@ -58,6 +58,7 @@ bool compare(const T a, const T b, const double thr = THRESH) {
  return out;
 }
 
+#include <src/testimpl/test_matrix.cc>
 #include <src/testimpl/test_scf.cc>
 #include <src/testimpl/test_molden.cc>
 #include <src/testimpl/test_prop.cc>
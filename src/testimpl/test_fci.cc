@@ -86,6 +86,124 @@ std::vector<double> fci_energy(std::string inp) {
   return result;
 }
 
+// runs the Knowles-Handy FCI in the input and returns it with the (transition) 1- and 2RDMs of the first two states
+std::shared_ptr<FCI> fci_wavefunction(std::string inp) {
+
+  auto ofs = std::make_shared<std::ofstream>(inp + ".testout", std::ios::trunc);
+  std::streambuf* backup_stream = std::cout.rdbuf(ofs->rdbuf());
+
+  std::string filename = location__ + inp + ".json";
+  auto idata = std::make_shared<const PTree>(filename);
+  auto keys = idata->get_child("bagel");
+  std::shared_ptr<Geometry> geom;
+  std::shared_ptr<const Reference> ref;
+  std::shared_ptr<FCI> fci;
+
+  for (auto& itree : *keys) {
+    const std::string method = to_lower(itree->get<std::string>("title", ""));
+    if (method == "molecule") {
+      geom = std::make_shared<Geometry>(itree);
+    } else if (method == "hf") {
+      auto scf = std::make_shared<RHF>(itree, geom);
+      scf->compute();
+      ref = scf->conv_to_ref();
+    } else if (method == "fci") {
+      fci = std::make_shared<KnowlesHandy>(itree, geom, ref);
+      fci->compute();
+    }
+  }
+  fci->compute_rdm12();
+  fci->compute_rdm12(0, 1);
+  fci->compute_rdm12(1, 0);
+
+  std::cout.rdbuf(backup_stream);
+  return fci;
+}
+
+// largest deviation of FCI::rdm34f from FCI::rdm34 contracted with a (model) Fock matrix
+double fci_rdm34f_error(std::string inp) {
+  std::shared_ptr<FCI> fci = fci_wavefunction(inp);
+  const int norb = fci->norb();
+  auto fock = std::make_shared<Matrix>(norb, norb);
+  for (int i = 0; i != norb; ++i)
+    for (int j = 0; j != norb; ++j)
+      fock->element(j, i) = 1.0 / (1.0 + i + j) + (i == j ? 0.1 * i : 0.0);
+
+  double error = 0.0;
+  for (auto& st : std::vector<std::pair<int,int>>{{0,0}, {0,1}, {1,0}}) {
+    std::shared_ptr<RDM<3>> rdm3, rdm3f, frdm4;
+    std::shared_ptr<RDM<4>> rdm4;
+    std::tie(rdm3, rdm4) = fci->rdm34(st.first, st.second);
+    std::tie(rdm3f, frdm4) = fci->rdm34f(st.first, st.second, fock);
+
+    auto ref = rdm3->clone();
+    auto rdm4v = btas::group(btas::group(*rdm4, 6,8), 0,6);
+    auto refv = btas::group(*ref, 0,6);
+    btas::contract(1.0, rdm4v, {0,1}, btas::group(*fock,0,2), {1}, 0.0, refv, {0});
+
+    for (size_t i = 0; i != ref->size(); ++i) {
+      error = std::max(error, std::fabs(ref->data()[i] - frdm4->data()[i]));
+      error = std::max(error, std::fabs(rdm3->data()[i] - rdm3f->data()[i]));
+    }
+  }
+  return error;
+}
+
+// largest deviation after packing the FCI 3 and 4RDMs and unpacking them in full, by element, and by block
+double fci_packed_rdm_error(std::string inp) {
+  std::shared_ptr<FCI> fci = fci_wavefunction(inp);
+  const int norb = fci->norb();
+
+  double error = 0.0;
+  for (auto& st : std::vector<std::pair<int,int>>{{0,0}, {0,1}}) {
+    std::shared_ptr<RDM<3>> rdm3;
+    std::shared_ptr<RDM<4>> rdm4;
+    std::tie(rdm3, rdm4) = fci->rdm34(st.first, st.second);
+
+    const PackedRDM<3> packed3(*rdm3);
+    const PackedRDM<4> packed4(*rdm4);
+    std::shared_ptr<RDM<3>> unpacked3 = packed3.unpack();
+    std::shared_ptr<RDM<4>> unpacked4 = packed4.unpack();
+    for (size_t i = 0; i != rdm3->size(); ++i)
+      error = std::max(error, std::fabs(unpacked3->data()[i] - rdm3->data()[i]));
+    for (size_t i = 0; i != rdm4->size(); ++i)
+      error = std::max(error, std::fabs(unpacked4->data()[i] - rdm4->data()[i]));
+
+    for (int i = 0; i != norb; ++i)
+      for (int j = 0; j != norb; ++j)
+        error = std::max(error, std::fabs(packed4.element(i,j,j,i,0,norb-1,i,i) - rdm4->element(i,j,j,i,0,norb-1,i,i)));
+
+    // a block with a different offset and size for every index
+    std::array<int,8> offset, size;
+    for (int k = 0; k != 8; ++k) {
+      offset[k] = k % norb;
+      size[k] = std::min(norb - offset[k], 1 + (k+1) % 3);
+    }
+    std::vector<double> block(std::accumulate(size.begin(), size.end(), 1ul, std::multiplies<size_t>()));
+    packed4.unpack_block(offset, size, block.data());
+    size_t n = 0;
+    for (int i7 = offset[7]; i7 != offset[7]+size[7]; ++i7)
+     for (int i6 = offset[6]; i6 != offset[6]+size[6]; ++i6)
+      for (int i5 = offset[5]; i5 != offset[5]+size[5]; ++i5)
+       for (int i4 = offset[4]; i4 != offset[4]+size[4]; ++i4)
+        for (int i3 = offset[3]; i3 != offset[3]+size[3]; ++i3)
+         for (int i2 = offset[2]; i2 != offset[2]+size[2]; ++i2)
+          for (int i1 = offset[1]; i1 != offset[1]+size[1]; ++i1)
+           for (int i0 = offset[0]; i0 != offset[0]+size[0]; ++i0)
+             error = std::max(error, std::fabs(block[n++] - rdm4->element(i0,i1,i2,i3,i4,i5,i6,i7)));
+
+    // the packed storage returned by FCI directly
+    std::shared_ptr<PackedRDM<3>> fci3;
+    std::shared_ptr<PackedRDM<4>> fci4;
+    std::tie(fci3, fci4) = fci->rdm34_packed(st.first, st.second);
+    if (fci3->size() != packed3.size() || fci4->size() != packed4.size())
+      return 1.0;
+    for (size_t i = 0; i != fci4->size(); ++i)
+      error = std::max(error, std::fabs(fci4->data()[i] - packed4.data()[i]));
+  }
+  return error;
+}
+
 std::vector<double> reference_fci_energy() {
   std::vector<double> out(2);
   out[0] = -98.56280393;
@@ -115,6 +233,14 @@ BOOST_AUTO_TEST_CASE(HARRISON_ZARRABIAN) {
     BOOST_CHECK(compare(fci_energy("hhe_svp_fci_hz_trip"), reference_fci_energy2()));
 }
 
+BOOST_AUTO_TEST_CASE(RDM34F) {
+    BOOST_CHECK(fci_rdm34f_error("hf_sto3g_fci_kh") < 1.0e-10);
+}
+
+BOOST_AUTO_TEST_CASE(PACKED_RDM) {
+    BOOST_CHECK(fci_packed_rdm_error("hf_sto3g_fci_kh") < 1.0e-12);
+}
+
 #ifdef HAVE_MPI_H
 BOOST_AUTO_TEST_CASE(DIST_FCI) {
     BOOST_CHECK(compare(fci_energy("hf_sto3g_fci_dist"), reference_fci_energy()));
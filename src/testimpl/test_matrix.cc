@@ -0,0 +1,101 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: test_matrix.cc
+// Copyright (C) 2012 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <src/util/math/matop.h>
+
+using namespace bagel;
+
+// Hermitian test matrix with a well separated spectrum (its real part is used for Matrix)
+std::shared_ptr<ZMatrix> model_matrix(const int n) {
+  auto out = std::make_shared<ZMatrix>(n, n);
+  for (int i = 0; i != n; ++i)
+    for (int j = 0; j <= i; ++j) {
+      out->element(i, j) = i == j ? std::complex<double>(i) : std::complex<double>(0.1 / (1.0 + i - j), 0.05 / (1.0 + i + j));
+      out->element(j, i) = std::conj(out->element(i, j));
+    }
+  return out;
+}
+
+// largest deviation of the eigenpairs (eig[0, mdim), coeff) from those of the full diagonalization (eig[first, first+mdim))
+template<class MatType>
+double eigenpair_error(const MatType& mat, const VectorB& eig, const MatType& coeff, const VectorB& ref, const int first) {
+  double error = 0.0;
+  const MatType proj(coeff % mat * coeff);
+  const MatType ovlp(coeff % coeff);
+  for (int i = 0; i != coeff.mdim(); ++i) {
+    error = std::max(error, std::fabs(eig(i) - ref(first+i)));
+    for (int j = 0; j != coeff.mdim(); ++j) {
+      error = std::max(error, std::abs(proj.element(j, i) - (i == j ? eig(i) : 0.0)));
+      error = std::max(error, std::abs(ovlp.element(j, i) - (i == j ? 1.0 : 0.0)));
+    }
+  }
+  return error;
+}
+
+double matrix_range_error() {
+  const int n = 60;
+  std::shared_ptr<const Matrix> mat = model_matrix(n)->get_real_part();
+  VectorB ref(n);
+  Matrix(*mat).diagonalize(ref);
+
+  VectorB eig(n);
+  std::shared_ptr<const Matrix> coeff = mat->diagonalize_range(eig, 5, 17);
+  if (coeff->mdim() != 12) return 1.0;
+  return eigenpair_error(*mat, eig, *coeff, ref, 5);
+}
+
+double matrix_window_error() {
+  const int n = 60;
+  std::shared_ptr<const Matrix> mat = model_matrix(n)->get_real_part();
+  VectorB ref(n);
+  Matrix(*mat).diagonalize(ref);
+
+  // bounds halfway between the neighbouring eigenvalues, so that exactly 10 roots are inside
+  VectorB eig(n);
+  std::shared_ptr<const Matrix> coeff = mat->diagonalize_window(eig, 0.5*(ref(19)+ref(20)), 0.5*(ref(29)+ref(30)));
+  if (coeff->mdim() != 10) return 1.0;
+  return eigenpair_error(*mat, eig, *coeff, ref, 20);
+}
+
+double zmatrix_range_error() {
+  const int n = 60;
+  std::shared_ptr<const ZMatrix> mat = model_matrix(n);
+  VectorB ref(n);
+  ZMatrix(*mat).diagonalize(ref);
+
+  VectorB eig(n);
+  std::shared_ptr<const ZMatrix> coeff = mat->diagonalize_range(eig, 0, 8);
+  if (coeff->mdim() != 8) return 1.0;
+  return eigenpair_error(*mat, eig, *coeff, ref, 0);
+}
+
+BOOST_AUTO_TEST_SUITE(TEST_MATRIX)
+
+BOOST_AUTO_TEST_CASE(DIAGONALIZE_RANGE) {
+    BOOST_CHECK(matrix_range_error() < 1.0e-10);
+    BOOST_CHECK(matrix_window_error() < 1.0e-10);
+    BOOST_CHECK(zmatrix_range_error() < 1.0e-10);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -23,6 +23,7 @@
 //
 
 #include <src/opt/optimize.h>
+#include <src/opt/neb.h>
 #include <src/wfn/reference.h>
 
 std::vector<double> run_opt(std::string filename) {
@@ -56,6 +57,37 @@ std::vector<double> run_opt(std::string filename) {
   std::cout.rdbuf(backup_stream);
   return out;
 }
+// returns the energies of the images along the path
+std::vector<double> run_neb(std::string filename) {
+
+  std::string outputname = filename + ".testout";
+  std::string inputname = location__ + filename + ".json";
+  auto ofs = std::make_shared<std::ofstream>(outputname, std::ios::trunc);
+  std::streambuf* backup_stream = std::cout.rdbuf(ofs->rdbuf());
+
+  auto idata = std::make_shared<const PTree>(inputname);
+  auto keys = idata->get_child("bagel");
+  std::shared_ptr<const Geometry> geom;
+  std::shared_ptr<const Reference> ref;
+
+  std::vector<double> out;
+
+  for (auto& itree : *keys) {
+    const std::string method = to_lower(itree->get<std::string>("title", ""));
+
+    if (method == "molecule") {
+      geom = std::make_shared<const Geometry>(itree);
+    } else if (method == "neb") {
+      auto neb = std::make_shared<NEB>(itree, geom, ref);
+      neb->compute();
+      out = neb->energies();
+    }
+  }
+  assert(!out.empty());
+  std::cout.rdbuf(backup_stream);
+  return out;
+}
+
 std::vector<double> reference_scf_opt() {
   std::vector<double> out(6);
   out[2] = 1.749334;
@@ -133,6 +165,7 @@ BOOST_AUTO_TEST_SUITE(TEST_OPT)
 
 BOOST_AUTO_TEST_CASE(DF_HF_Opt) {
     BOOST_CHECK(compare(run_opt("hf_svp_dfhf_opt"),       reference_scf_opt(),      1.0e-4));
+    BOOST_CHECK(compare(run_opt("hf_svp_dfhf_second_opt"), reference_scf_opt(),    1.0e-4));
     BOOST_CHECK(compare(run_opt("hf_svp_dfhf_opt_cart"),  reference_scf_opt_cart(), 1.0e-4));
     BOOST_CHECK(compare(run_opt("hf_mix_dfhf_opt"),       reference_scf_opt_mix(),  1.0e-4));
     BOOST_CHECK(compare(run_opt("oh_svp_uhf_opt"),        reference_uhf_opt(),      1.0e-4));
@@ -154,4 +187,12 @@ BOOST_AUTO_TEST_CASE(CASSCF_Opt) {
     BOOST_CHECK(compare<std::vector<double>>(run_opt("hf_svp_sacas_act_opt"),  reference_sacas_act_opt(),    1.0e-4));
 }
 
+// the inversion of ammonia is symmetric about the planar structure, which should be the highest image
+BOOST_AUTO_TEST_CASE(DF_HF_NEB) {
+    std::vector<double> energies = run_neb("nh3_svp_dfhf_neb");
+    std::vector<double> reversed(energies.rbegin(), energies.rend());
+    BOOST_CHECK(compare(energies, reversed, 1.0e-6));
+    BOOST_CHECK(std::max_element(energies.begin(), energies.end()) - energies.begin() == static_cast<long>(energies.size()/2));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -23,6 +23,7 @@
 //
 
 #include <sstream>
+#include <cstdio>
 #include <src/scf/hf/rhf.h>
 #include <src/scf/hf/rohf.h>
 #include <src/scf/hf/uhf.h>
@@ -81,13 +82,50 @@ double scf_energy(std::string filename, std::string extension = ".json") {
   return ref->energy(0);
 }
 
+#ifndef DISABLE_SERIALIZATION
+// runs an SCF with background checkpoints (restart_keep = 2) and continues from the last archive that is kept
+double scf_checkpoint_energy(std::string filename) {
+  const int maxiter = 200;
+  for (int iter = 0; iter != maxiter; ++iter)
+    std::remove(("scf_" + std::to_string(iter) + ".checkpoint").c_str());
+
+  const double energy = scf_energy(filename);
+
+  std::vector<int> kept;
+  for (int iter = 0; iter != maxiter; ++iter)
+    if (std::ifstream("scf_" + std::to_string(iter) + ".checkpoint").is_open())
+      kept.push_back(iter);
+  BOOST_CHECK(kept.size() == 2 && kept[1] == kept[0]+1);
+  if (kept.empty())
+    return 0.0;
+
+  auto ofs = std::make_shared<std::ofstream>(filename + "_continue.testout", std::ios::trunc);
+  std::streambuf* backup_stream = std::cout.rdbuf(ofs->rdbuf());
+  IArchive archive("scf_" + std::to_string(kept.back()));
+  Method* ptr;
+  archive >> ptr;
+  auto scf = std::shared_ptr<Method>(ptr);
+  scf->compute();
+  std::cout.rdbuf(backup_stream);
+
+  BOOST_CHECK(compare(scf->conv_to_ref()->energy(0), energy));
+  return energy;
+}
+#endif
+
 BOOST_AUTO_TEST_SUITE(TEST_SCF)
 
 BOOST_AUTO_TEST_CASE(DF_HF) {
     BOOST_CHECK(compare(scf_energy("hf_svp_hf"),          -99.84779026));
     BOOST_CHECK(compare(scf_energy("hf_svp_dfhf"),        -99.84772354));
+    BOOST_CHECK(compare(scf_energy("hf_svp_cholesky"),    -99.84779026, 1.0e-6));
+    BOOST_CHECK(compare(scf_energy("hf_svp_dfhf_local"),  -99.84772354, 1.0e-6));
+    BOOST_CHECK(compare(scf_energy("hf_svp_dfhf_cosx"),   -99.84783553, 1.0e-6));
+    BOOST_CHECK(compare(scf_energy("hf_svp_dfhf_single"), -99.84772354));
+    BOOST_CHECK(compare(scf_energy("hf_svp_dfhf_second"), -99.84772354));
 #ifndef DISABLE_SERIALIZATION
 //  BOOST_CHECK(compare(scf_energy("hf_svp_dfhf_restart"),-99.84772354));
+    BOOST_CHECK(compare(scf_checkpoint_energy("hf_svp_dfhf_checkpoint"), -99.84772354));
 #endif
     BOOST_CHECK(compare(scf_energy("hf_svp_dfhf",".bgl"), -99.84772354));
     BOOST_CHECK(compare(scf_energy("hf_svp_dfhf_ext"),    -99.83765614));
@@ -24,6 +24,7 @@
 
 
 #include <src/ci/zfci/zharrison.h>
+#include <src/ci/zfci/distzharrison.h>
 
 std::vector<double> relfci_energy(std::string inp) {
 
@@ -48,7 +49,13 @@ std::vector<double> relfci_energy(std::string inp) {
       scf->compute();
       ref = scf->conv_to_ref();
     } else if (method == "zfci") {
-      auto fci = std::make_shared<ZHarrison>(itree, geom, ref);
+      std::shared_ptr<ZHarrison> fci;
+#ifdef HAVE_MPI_H
+      if (itree->get<std::string>("algorithm", "") == "dist")
+        fci = std::make_shared<DistZHarrison>(itree, geom, ref);
+      else
+#endif
+        fci = std::make_shared<ZHarrison>(itree, geom, ref);
       fci->compute();
       std::cout.rdbuf(backup_stream);
       return fci->energy();
@@ -113,4 +120,10 @@ BOOST_AUTO_TEST_CASE(ZHARRISON) {
   BOOST_CHECK(compare(relfci_energy("ca_london_relfci_coulomb"), reference_relfci_energy6()));
 }
 
+#ifdef HAVE_MPI_H
+BOOST_AUTO_TEST_CASE(DIST_ZHARRISON) {
+  BOOST_CHECK(compare(relfci_energy("hf_sto3g_relfci_dist"), reference_relfci_energy()));
+}
+#endif
+
 BOOST_AUTO_TEST_SUITE_END()
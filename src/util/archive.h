@@ -28,12 +28,40 @@
 
 #include <string>
 #include <fstream>
+#include <memory>
+#include <functional>
 #include <boost/archive/binary_oarchive.hpp>
 #include <boost/archive/binary_iarchive.hpp>
 #include <boost/serialization/export.hpp>
 
 namespace bagel {
 
+/// Keeps objects that are shared by consecutive archives so that each of them is written only once (see Checkpoint).
+class ArchiveStore {
+  public:
+    virtual ~ArchiveStore() { }
+
+    /// Returns the name of the archive that holds the object. write is called when the object has not been stored yet.
+    virtual std::string put(std::shared_ptr<const void> key, std::function<void(boost::archive::binary_oarchive&)> write) = 0;
+
+    /// The store used by the archives that are written in this thread (nullptr if none)
+    static ArchiveStore*& current() {
+      static thread_local ArchiveStore* store = nullptr;
+      return store;
+    }
+
+    /// True while an archive written through a store (*.checkpoint) is read in this thread
+    static bool& reading() {
+      static thread_local bool out = false;
+      return out;
+    }
+
+    /// True if the objects serialized through serialize_stored are kept in archives of their own
+    template<class Archive>
+    static bool active() { return Archive::is_saving::value ? current() != nullptr : reading(); }
+};
+
+
 class OArchive {
   protected:
     std::string filename_;
@@ -65,15 +93,23 @@ class IArchive {
     using Istream = boost::archive::binary_iarchive;
     Istream archive_;
 
+    // archives written by Checkpoint have the extension .checkpoint
+    static std::string find(const std::string& name) {
+      return (std::ifstream(name+".archive").is_open() || !std::ifstream(name+".checkpoint").is_open()) ? name+".archive" : name+".checkpoint";
+    }
+
   public:
-    IArchive(std::string name) : filename_(name+".archive"), is_(filename_), archive_(is_) {
+    IArchive(std::string name) : filename_(find(name)), is_(filename_), archive_(is_) {
       if (!is_.is_open())
         throw std::runtime_error(name+".archive not found");
     }
 
     template<typename T>
     IArchive& operator>>(T& val) {
+      const bool reading = ArchiveStore::reading();
+      ArchiveStore::reading() = filename_.substr(filename_.rfind('.')) == ".checkpoint";
       archive_ >> val;
+      ArchiveStore::reading() = reading;
       return *this;
     }
 
@@ -81,6 +117,27 @@ class IArchive {
     IArchive& operator<<(T& val) = delete;
 };
 
+
+/// Serializes a shared pointer to an immutable object. When an ArchiveStore is active, only the name of the archive
+/// that holds the object is recorded, and the object is written by the store if it is new. Otherwise this is the same as ar & ptr.
+template<class Archive, class T>
+void serialize_stored(Archive& ar, std::shared_ptr<const T>& ptr) {
+  if (!ArchiveStore::active<Archive>()) {
+    ar & ptr;
+    return;
+  }
+  std::string name;
+  if (Archive::is_saving::value && ptr)
+    name = ArchiveStore::current()->put(ptr, [&ptr](boost::archive::binary_oarchive& out) { out << ptr; });
+  ar & name;
+  if (name.empty()) {
+    ar & ptr;
+  } else if (Archive::is_loading::value) {
+    IArchive in(name);
+    in >> ptr;
+  }
+}
+
 }
 
 #endif
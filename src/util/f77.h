@@ -43,6 +43,9 @@ extern "C" {
  void dgemm_(const char* transa, const char* transb, const int* m, const int* n, const int* k,
              const double* alpha, const double* a, const int* lda, const double* b, const int* ldb,
              const double* beta, double* c, const int* ldc);
+ void sgemm_(const char* transa, const char* transb, const int* m, const int* n, const int* k,
+             const float* alpha, const float* a, const int* lda, const float* b, const int* ldb,
+             const float* beta, float* c, const int* ldc);
  void dsysv_(const char* uplo, const int* n, const int* nrhs, double* a, const int* lda, int* ipiv,
              double* b, const int* ldb, double* work, const int* lwork, int* info);
  void drot_(const int*, const double*, const int*, const double*, const int*, const double*, const double*);
@@ -78,6 +81,11 @@ extern "C" {
  void zgeev_(const char*, const char*, const int*, std::complex<double>*, const int*, std::complex<double>*,
              std::complex<double>*, const int*, std::complex<double>*, const int*, std::complex<double>*, const int*, double*, int*);
  void zheev_(const char*, const char*, const int*, std::complex<double>*, const int*, double*, std::complex<double>*, const int*, double*, int*);
+ void zheevr_(const char*, const char*, const char*, const int*, std::complex<double>*, const int*, const double*, const double*, const int*, const int*,
+              const double*, int*, double*, std::complex<double>*, const int*, int*, std::complex<double>*, const int*, double*, const int*, int*, const int*, int*);
+ void dsyevd_(const char*, const char*, const int*, double*, const int*, double*, double*, const int*, int*, const int*, int*);
+ void dsyevr_(const char*, const char*, const char*, const int*, double*, const int*, const double*, const double*, const int*, const int*,
+              const double*, int*, double*, double*, const int*, int*, double*, const int*, int*, const int*, int*);
  void zhesv_(const char* uplo, const int* n, const int* nrhs, std::complex<double>* a, const int* lda, int* ipiv,
              std::complex<double>* b, const int* ldb, std::complex<double>* work, const int* lwork, int* info);
  void zgesv_(const int* n, const int* nrhs, std::complex<double>* a, const int* lda, int* ipiv,
@@ -93,6 +101,10 @@ extern "C" {
 // BAGEL's interface
 namespace {
 
+ void sgemm_(const char* transa, const char* transb, const int m, const int n, const int k,
+             const float alpha, const float* a, const int lda, const float* b, const int ldb,
+             const float beta, float* c, const int ldc) { ::sgemm_(transa,transb,&m,&n,&k,&alpha,a,&lda,b,&ldb,&beta,c,&ldc); }
+
  void dgemm_(const char* transa, const char* transb, const int m, const int n, const int k,
              const double alpha, const double* a, const int lda, const double* b, const int ldb,
              const double beta, double* c, const int ldc) { ::dgemm_(transa,transb,&m,&n,&k,&alpha,a,&lda,b,&ldb,&beta,c,&ldc); }
@@ -118,6 +130,11 @@ namespace {
  void dsyev_(const char* a, const char* b, const int c, std::unique_ptr<double []>& d, const int e,
              std::unique_ptr<double []>& f, std::unique_ptr<double []>& g, const int h, int& i)
              { ::dsyev_(a,b,&c,d.get(),&e,f.get(),g.get(),&h,&i);}
+ void dsyevd_(const char* a, const char* b, const int c, double* d, const int e, double* f, double* g, const int h, int* i, const int j, int& k)
+             { ::dsyevd_(a,b,&c,d,&e,f,g,&h,i,&j,&k); }
+ void dsyevr_(const char* a, const char* b, const char* c, const int d, double* e, const int f, const double g, const double h, const int i, const int j,
+              const double k, int& l, double* m, double* n, const int o, int* p, double* q, const int r, int* s, const int t, int& u)
+             { ::dsyevr_(a,b,c,&d,e,&f,&g,&h,&i,&j,&k,&l,m,n,&o,p,q,&r,s,&t,&u); }
  void dsysv_(const char* uplo, const int n, const int nrhs, double* a, const int lda, int* ipiv,
              double* b, const int ldb, double* work, const int lwork, int& info)
              { ::dsysv_(uplo, &n, &nrhs, a, &lda, ipiv, b, &ldb, work, &lwork, &info);}
@@ -196,6 +213,10 @@ namespace {
  void zheev_(const char* a, const char* b, const int c, std::unique_ptr<std::complex<double> []>& d, const int e,
              std::unique_ptr<double []>& f, std::unique_ptr<std::complex<double> []>& g, const int h, std::unique_ptr<double[]>& i, int& j)
              { ::zheev_(a,b,&c,d.get(),&e,f.get(),g.get(),&h,i.get(),&j); }
+ void zheevr_(const char* a, const char* b, const char* c, const int d, std::complex<double>* e, const int f, const double g, const double h, const int i,
+              const int j, const double k, int& l, double* m, std::complex<double>* n, const int o, int* p, std::complex<double>* q, const int r,
+              double* s, const int t, int* u, const int v, int& w)
+             { ::zheevr_(a,b,c,&d,e,&f,&g,&h,&i,&j,&k,&l,m,n,&o,p,q,&r,s,&t,u,&v,&w); }
  void zgeev_(const char* a, const char* b, const int c, std::complex<double>* d, const int e, std::complex<double>* f,
              std::complex<double>* g, const int h, std::complex<double>* i, const int j, std::complex<double>* k, const int l, double* m, int& n)
              { ::zgeev_(a,b,&c,d,&e,f,g,&h,i,&j,k,&l,m,&n); }
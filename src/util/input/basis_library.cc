@@ -0,0 +1,202 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: basis_library.cc
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <cstring>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <boost/property_tree/json_parser.hpp>
+#include <src/util/input/basis_library.h>
+
+using namespace std;
+using namespace bagel;
+using boost::property_tree::ptree;
+
+constexpr const char* BasisLibrary::magic_;
+constexpr size_t BasisLibrary::namelen_;
+
+namespace {
+
+void write_uint(string& out, const uint64_t i) {
+  out.append(reinterpret_cast<const char*>(&i), sizeof(uint64_t));
+}
+
+void write_string(string& out, const string& s) {
+  write_uint(out, s.size());
+  out.append(s);
+}
+
+void encode(string& out, const ptree& tree) {
+  write_string(out, tree.data());
+  write_uint(out, tree.size());
+  for (auto& i : tree) {
+    write_string(out, i.first);
+    encode(out, i.second);
+  }
+}
+
+uint64_t read_uint(const char*& ptr, const char* end) {
+  if (ptr + sizeof(uint64_t) > end)
+    throw runtime_error("corrupted basis library");
+  uint64_t out;
+  memcpy(&out, ptr, sizeof(uint64_t));
+  ptr += sizeof(uint64_t);
+  return out;
+}
+
+string read_string(const char*& ptr, const char* end) {
+  const uint64_t n = read_uint(ptr, end);
+  if (ptr + n > end)
+    throw runtime_error("corrupted basis library");
+  string out(ptr, n);
+  ptr += n;
+  return out;
+}
+
+void decode(const char*& ptr, const char* end, ptree& tree) {
+  tree.data() = read_string(ptr, end);
+  const uint64_t n = read_uint(ptr, end);
+  for (uint64_t i = 0; i != n; ++i) {
+    const string key = read_string(ptr, end);
+    auto iter = tree.push_back({key, ptree()});
+    decode(ptr, end, iter->second);
+  }
+}
+
+}
+
+
+BasisLibrary::BasisLibrary(const string& filename) : filename_(filename), data_(nullptr), size_(0) {
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw runtime_error(filename + " cannot be opened");
+  struct stat st;
+  if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < namelen_ + sizeof(uint64_t)) {
+    close(fd);
+    throw runtime_error(filename + " is not a basis library");
+  }
+  size_ = st.st_size;
+  void* map = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+    throw runtime_error(filename + " cannot be mapped");
+  data_ = static_cast<const char*>(map);
+
+  try {
+    if (strncmp(data_, magic_, namelen_) != 0)
+      throw runtime_error(filename + " is not a basis library");
+    const char* ptr = data_ + namelen_;
+    const char* end = data_ + size_;
+    const uint64_t n = read_uint(ptr, end);
+    for (uint64_t i = 0; i != n; ++i) {
+      if (ptr + namelen_ > end)
+        throw runtime_error("corrupted basis library");
+      const string name(ptr, strnlen(ptr, namelen_));
+      ptr += namelen_;
+      const uint64_t offset = read_uint(ptr, end);
+      const uint64_t size = read_uint(ptr, end);
+      if (offset + size > size_)
+        throw runtime_error("corrupted basis library");
+      index_.emplace(name, make_pair(offset, size));
+    }
+  } catch (...) {
+    munmap(const_cast<char*>(data_), size_);
+    throw;
+  }
+}
+
+
+BasisLibrary::~BasisLibrary() {
+  munmap(const_cast<char*>(data_), size_);
+}
+
+
+shared_ptr<const ptree> BasisLibrary::element(const string& name) {
+  auto iter = decoded_.find(name);
+  if (iter != decoded_.end())
+    return iter->second;
+
+  const pair<size_t, size_t>& loc = index_.at(name);
+  const char* ptr = data_ + loc.first;
+  auto out = make_shared<ptree>();
+  decode(ptr, ptr + loc.second, *out);
+  decoded_.emplace(name, out);
+  return out;
+}
+
+
+shared_ptr<const PTree> BasisLibrary::get(const set<string>& elements) {
+  lock_guard<mutex> lock(mutex_);
+  ptree out;
+  if (elements.empty()) {
+    for (auto& i : index_)
+      out.push_back({i.first, *element(i.first)});
+  } else {
+    for (auto& i : elements)
+      if (contains(i))
+        out.push_back({i, *element(i)});
+  }
+  return make_shared<const PTree>(out, "");
+}
+
+
+void BasisLibrary::compile(const string& json, const string& filename) {
+  ptree tree;
+  boost::property_tree::json_parser::read_json(json, tree);
+
+  // encode all of the elements first so that the offsets are known
+  vector<pair<string, string>> encoded;
+  for (auto& i : tree) {
+    if (i.first.empty() || i.first.size() > namelen_)
+      throw runtime_error("unexpected element name \"" + i.first + "\" in " + json);
+    string buf;
+    encode(buf, i.second);
+    encoded.emplace_back(i.first, move(buf));
+  }
+
+  string header(magic_, namelen_);
+  write_uint(header, encoded.size());
+  uint64_t offset = header.size() + encoded.size() * (namelen_ + 2*sizeof(uint64_t));
+  for (auto& i : encoded) {
+    string name = i.first;
+    name.resize(namelen_, '\0');
+    header.append(name);
+    write_uint(header, offset);
+    write_uint(header, i.second.size());
+    offset += i.second.size();
+  }
+
+  ofstream ofs(filename, ios::binary | ios::trunc);
+  if (!ofs.is_open())
+    throw runtime_error(filename + " cannot be written");
+  ofs.write(header.data(), header.size());
+  for (auto& i : encoded)
+    ofs.write(i.second.data(), i.second.size());
+  if (!ofs.good())
+    throw runtime_error("failed to write " + filename);
+}
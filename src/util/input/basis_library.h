@@ -0,0 +1,76 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: basis_library.h
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+
+#ifndef __SRC_INPUT_BASIS_LIBRARY_H
+#define __SRC_INPUT_BASIS_LIBRARY_H
+
+#include <set>
+#include <map>
+#include <mutex>
+#include <src/util/input/input.h>
+
+namespace bagel {
+
+/// Precompiled basis set file (.bbas) that is memory-mapped and decoded one element at a time.
+/** The file consists of a header ("BGLBAS01" and the number of elements), an index of (element, offset, size) records,
+    and for each element a binary encoding of its property tree (key, data, and children, recursively) in host byte order.
+    The files are generated from the JSON basis sets at install time (see compile_basis.cc). */
+class BasisLibrary {
+  protected:
+    std::string filename_;
+    const char* data_;
+    size_t size_;
+
+    /// element -> (offset, size) in the file
+    std::map<std::string, std::pair<size_t, size_t>> index_;
+    /// elements that have been decoded so far
+    std::map<std::string, std::shared_ptr<const boost::property_tree::ptree>> decoded_;
+    std::mutex mutex_;
+
+    static constexpr const char* magic_ = "BGLBAS01";
+    static constexpr size_t namelen_ = 8;
+
+    std::shared_ptr<const boost::property_tree::ptree> element(const std::string& name);
+
+  public:
+    BasisLibrary(const std::string& filename);
+    ~BasisLibrary();
+
+    BasisLibrary(const BasisLibrary&) = delete;
+    BasisLibrary& operator=(const BasisLibrary&) = delete;
+
+    const std::string& filename() const { return filename_; }
+    bool contains(const std::string& name) const { return index_.find(name) != index_.end(); }
+
+    /// Returns a tree with the requested elements (all of them if the set is empty). Elements that are not in the library are skipped.
+    std::shared_ptr<const PTree> get(const std::set<std::string>& elements);
+
+    /// Converts a JSON basis file to the binary format
+    static void compile(const std::string& json, const std::string& out);
+};
+
+}
+
+#endif
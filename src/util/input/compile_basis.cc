@@ -0,0 +1,45 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: compile_basis.cc
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+// Converts a JSON basis file into the precompiled format read by BasisLibrary.
+// usage: compile_basis input.json output.bbas
+
+#include <iostream>
+#include <src/util/input/basis_library.h>
+
+using namespace std;
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    cerr << "usage: " << argv[0] << " input.json output.bbas" << endl;
+    return 1;
+  }
+  try {
+    bagel::BasisLibrary::compile(argv[1], argv[2]);
+  } catch (const exception& e) {
+    cerr << argv[1] << ": " << e.what() << endl;
+    return 1;
+  }
+  return 0;
+}
@@ -24,8 +24,11 @@
 
 #include <fstream>
 #include <string>
+#include <mutex>
+#include <sys/stat.h>
 #include <src/util/input/input.h>
 #include <src/util/input/parse.h>
+#include <src/util/input/basis_library.h>
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/xml_parser.hpp>
 
@@ -96,31 +99,51 @@ void PTree::print() const {
 }
 
 
-shared_ptr<const PTree> PTree::read_basis(string name) {
+shared_ptr<const PTree> PTree::read_basis(string name, const set<string>& elements) {
   // convert name to lowercase so things like cc-pVDZ are read
   const int split = name.find_last_of("/");
   name = name.substr(0, split+1) + to_lower(name.substr(split+1));
 
-  shared_ptr<const PTree> out;
-  // first try the absolute path (or current directory)
-  try {
-    out = make_shared<const PTree>(name);
-  } catch (...) {
-    // next, the standard install location
-    try {
-      const string prefix(BASIS_DIR);
-      const string filename = prefix + "/" + name + ".json";
-      out = make_shared<const PTree>(filename);
-    } catch (...) {
-      // last, the debug location
-      const string filename = "../../src/basis/" + name + ".json";
-      try {
-        out = make_shared<const PTree>(filename);
-      } catch (...) {
-        throw runtime_error(name + " cannot be opened. Please see if the file is in " + string(BASIS_DIR) + ".\n "
-                                 + " You can also specify the full path to the basis file.");
-      }
+  // basis sets are read once per process, since geometries are constructed many times in some jobs
+  static mutex cache_mutex;
+  static map<string, shared_ptr<const PTree>> json_cache;
+  static map<string, shared_ptr<BasisLibrary>> library_cache;
+  lock_guard<mutex> lock(cache_mutex);
+
+  auto modified = [](const string& filename, time_t& time) {
+    struct stat st;
+    const bool exists = stat(filename.c_str(), &st) == 0 && S_ISREG(st.st_mode);
+    if (exists) time = st.st_mtime;
+    return exists;
+  };
+
+  // returns nullptr if neither the file nor its precompiled version exists
+  auto read = [&](const string& filename) -> shared_ptr<const PTree> {
+    auto ends_with = [&filename](const string& ext) { return filename.size() > ext.size() && filename.compare(filename.size()-ext.size(), ext.size(), ext) == 0; };
+    const string binary = ends_with(".bbas") ? filename : (ends_with(".json") ? filename.substr(0, filename.size()-5) : filename) + ".bbas";
+    time_t jtime = 0, btime = 0;
+    const bool json = binary != filename && modified(filename, jtime);
+    // the precompiled file is not used if it is older than the JSON file
+    if (modified(binary, btime) && (!json || btime >= jtime)) {
+      auto iter = library_cache.find(binary);
+      if (iter == library_cache.end())
+        iter = library_cache.emplace(binary, make_shared<BasisLibrary>(binary)).first;
+      return iter->second->get(elements);
     }
-  }
+    if (!json)
+      return nullptr;
+    auto iter = json_cache.find(filename);
+    if (iter == json_cache.end())
+      iter = json_cache.emplace(filename, make_shared<const PTree>(filename)).first;
+    return iter->second;
+  };
+
+  // first try the absolute path (or current directory), next the standard install location, and last the debug location
+  shared_ptr<const PTree> out = read(name);
+  if (!out) out = read(string(BASIS_DIR) + "/" + name + ".json");
+  if (!out) out = read("../../src/basis/" + name + ".json");
+  if (!out)
+    throw runtime_error(name + " cannot be opened. Please see if the file is in " + string(BASIS_DIR) + ".\n "
+                             + " You can also specify the full path to the basis file.");
   return out;
 }
@@ -25,6 +25,7 @@
 #ifndef __SRC_INPUT_INPUT_H
 #define __SRC_INPUT_INPUT_H
 
+#include <set>
 #include <vector>
 #include <src/util/string.h>
 #include <src/util/serialization.h>
@@ -140,8 +141,9 @@ class PTree {
 
     void print() const;
 
-    // static function to read basis files
-    static std::shared_ptr<const PTree> read_basis(std::string name);
+    // static function to read basis files. Only the listed elements are guaranteed to be in the output (all when empty).
+    // Precompiled .bbas files are used when available; the result is cached for the lifetime of the process
+    static std::shared_ptr<const PTree> read_basis(std::string name, const std::set<std::string>& elements = std::set<std::string>());
 };
 
 template <> void PTree::push_back<std::shared_ptr<PTree>>(const std::shared_ptr<PTree>& pt);
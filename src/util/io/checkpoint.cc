@@ -0,0 +1,138 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: checkpoint.cc
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <cstdio>
+#include <iostream>
+#include <src/util/io/checkpoint.h>
+#include <src/util/parallel/mpi_interface.h>
+
+using namespace std;
+using namespace bagel;
+
+namespace {
+// the processes other than the master serialize into this when they have to take part in serialization
+class NullBuffer : public streambuf {
+  protected:
+    int overflow(int c) override { return c; }
+    streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+}
+
+
+Checkpoint::Checkpoint(const string& prefix, const int nkeep, const bool background)
+  : prefix_(prefix), nkeep_(max(nkeep, 1)), background_(background), nstored_(0) {
+}
+
+
+Checkpoint::~Checkpoint() {
+  try {
+    wait();
+  } catch (const exception& e) {
+    cerr << "  * checkpoint could not be written: " << e.what() << endl;
+  }
+}
+
+
+void Checkpoint::wait() {
+  if (writer_.joinable())
+    writer_.join();
+  if (error_) {
+    exception_ptr e = error_;
+    error_ = nullptr;
+    rethrow_exception(e);
+  }
+}
+
+
+void Checkpoint::write(const string& name, function<void(boost::archive::binary_oarchive&)> func) const {
+  if (mpi__->rank() == 0) {
+    ofstream os(name + ".checkpoint", ios::binary | ios::trunc);
+    if (!os.is_open())
+      throw runtime_error(name + ".checkpoint cannot be written");
+    boost::archive::binary_oarchive ar(os);
+    func(ar);
+  } else {
+    NullBuffer buf;
+    ostream os(&buf);
+    boost::archive::binary_oarchive ar(os);
+    func(ar);
+  }
+}
+
+
+void Checkpoint::save_impl(const string& name, function<void(boost::archive::binary_oarchive&)> func) {
+  wait();
+  // nothing to be done by the other processes when the serialization is local
+  if (background_ && mpi__->rank() != 0)
+    return;
+
+  auto job = [this, name, func]() {
+    ArchiveStore::current() = this;
+    used_.clear();
+    try {
+      write(name, func);
+    } catch (...) {
+      error_ = current_exception();
+    }
+    ArchiveStore::current() = nullptr;
+    if (error_) return;
+
+    saved_.emplace_back(name, used_);
+    while (static_cast<int>(saved_.size()) > nkeep_) {
+      const pair<string, set<string>> old = saved_.front();
+      saved_.pop_front();
+      set<string> alive;
+      for (auto& i : saved_)
+        alive.insert(i.second.begin(), i.second.end());
+
+      vector<string> files{old.first};
+      for (auto& i : old.second)
+        if (!alive.count(i)) files.push_back(i);
+      for (auto i = stored_.begin(); i != stored_.end(); )
+        i = (old.second.count(i->second.second) && !alive.count(i->second.second)) ? stored_.erase(i) : next(i);
+      if (mpi__->rank() == 0)
+        for (auto& i : files)
+          remove((i + ".checkpoint").c_str());
+    }
+  };
+
+  if (background_)
+    writer_ = thread(job);
+  else
+    job();
+}
+
+
+string Checkpoint::put(shared_ptr<const void> key, function<void(boost::archive::binary_oarchive&)> func) {
+  auto iter = stored_.find(key.get());
+  if (iter != stored_.end() && !iter->second.first.expired()) {
+    used_.insert(iter->second.second);
+    return iter->second.second;
+  }
+  const string name = prefix_ + "_data" + to_string(nstored_++);
+  write(name, func);
+  stored_[key.get()] = make_pair(weak_ptr<const void>(key), name);
+  used_.insert(name);
+  return name;
+}
@@ -0,0 +1,85 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: checkpoint.h
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+
+#ifndef __SRC_UTIL_IO_CHECKPOINT_H
+#define __SRC_UTIL_IO_CHECKPOINT_H
+
+#include <set>
+#include <map>
+#include <deque>
+#include <thread>
+#include <exception>
+#include <src/util/archive.h>
+
+namespace bagel {
+
+/// Writes restart archives (prefix_iter.checkpoint) of an iterative method.
+/** Archives are serialized from a snapshot in a background thread while the next iteration runs, and only the last nkeep of them are kept.
+    Immutable objects that are serialized through serialize_stored (DIIS and Davidson histories) are written to
+    archives of their own (prefix_data#.checkpoint) once, and are removed when none of the kept archives refers to them.
+    The data are replicated and written by the master process. When serialization involves communication (distributed matrices),
+    background must be false so that all the processes take part in it. */
+class Checkpoint : public ArchiveStore {
+  protected:
+    const std::string prefix_;
+    const int nkeep_;
+    const bool background_;
+    int nstored_;
+
+    std::thread writer_;
+    std::exception_ptr error_;
+
+    // archives that are kept and the stored objects they refer to
+    std::deque<std::pair<std::string, std::set<std::string>>> saved_;
+    // objects that have been stored
+    std::map<const void*, std::pair<std::weak_ptr<const void>, std::string>> stored_;
+    // stored objects referred to by the archive being written
+    std::set<std::string> used_;
+
+    void write(const std::string& name, std::function<void(boost::archive::binary_oarchive&)> func) const;
+    void save_impl(const std::string& name, std::function<void(boost::archive::binary_oarchive&)> func);
+
+  public:
+    Checkpoint(const std::string& prefix, const int nkeep = 2, const bool background = true);
+    ~Checkpoint();
+
+    Checkpoint(const Checkpoint&) = delete;
+    Checkpoint& operator=(const Checkpoint&) = delete;
+
+    /// snapshot must not be modified after this call
+    template<class T>
+    void save(const int iter, std::shared_ptr<T> snapshot) {
+      save_impl(prefix_ + "_" + std::to_string(iter), [snapshot](boost::archive::binary_oarchive& ar) { T* ptr = snapshot.get(); ar << ptr; });
+    }
+
+    /// waits for the archive being written
+    void wait();
+
+    std::string put(std::shared_ptr<const void> key, std::function<void(boost::archive::binary_oarchive&)> write) override;
+};
+
+}
+
+#endif
@@ -28,6 +28,7 @@
 
 #include <memory>
 #include <list>
+#include <vector>
 #include <stdexcept>
 #include <src/util/f77.h>
 #include <src/util/math/matrix.h>
@@ -149,7 +150,15 @@ class AugHess {
 
     std::tuple<std::shared_ptr<T>,double,double,double> compute_residual(std::shared_ptr<const T> c, std::shared_ptr<const T> s,
                                                                          std::tuple<double,double> lam = std::make_tuple(0.0, 0.0)) {
-      update(c, s);
+      return compute_residual(std::vector<std::shared_ptr<const T>>{c}, std::vector<std::shared_ptr<const T>>{s}, lam);
+    }
+
+    // block version: several trial vectors (orthonormal to each other) are added at once
+    std::tuple<std::shared_ptr<T>,double,double,double> compute_residual(const std::vector<std::shared_ptr<const T>>& c, const std::vector<std::shared_ptr<const T>>& s,
+                                                                         std::tuple<double,double> lam = std::make_tuple(0.0, 0.0)) {
+      assert(c.size() == s.size() && !c.empty());
+      for (int i = 0; i != c.size(); ++i)
+        update(c[i], s[i]);
       double lambda = std::get<0>(lam);
       double stepsize = std::get<1>(lam);
       if (lambda == 0.0)
@@ -203,6 +212,24 @@ class AugHess {
     // make cc orthogonal to cc_ vectors
     double orthog(std::shared_ptr<T>& cc) { return cc->orthog(c_); }
 
+    // make a set of vectors orthonormal to c_ and to each other. Vectors that are linearly dependent are removed
+    void orthog(std::vector<std::shared_ptr<T>>& cc, const double thresh = 1.0e-8) {
+      std::list<std::shared_ptr<const T>> basis = c_;
+      std::vector<std::shared_ptr<T>> out;
+      for (auto& i : cc) {
+        const double norm = i->norm();
+        if (norm < thresh) continue;
+        i->scale(1.0/norm);
+        double residual = i->orthog(basis);
+        if (residual < thresh) continue;
+        for (int iter = 0; iter != 10 && residual <= 0.25; ++iter)
+          residual = i->orthog(basis);
+        basis.push_back(i);
+        out.push_back(i);
+      }
+      cc = out;
+    }
+
 };
 
 }
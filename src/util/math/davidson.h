@@ -50,7 +50,11 @@ class DavidsonDiag_ {
         // serialization
         friend class boost::serialization::access;
         template<class Archive>
-        void serialize(Archive& ar, const unsigned int) { ar & cc & sigma; }
+        void serialize(Archive& ar, const unsigned int) {
+          // trial vectors are not modified once they are added; checkpoints write each of them only once
+          serialize_stored(ar, cc);
+          serialize_stored(ar, sigma);
+        }
     };
 
     int nstate_;
@@ -135,9 +139,9 @@ class DavidsonDiag_ {
         throw std::runtime_error("Too much linear dependency in guess vectors provided to DavidsonDiag; cannot obtain the requested number of states.");
 
       // diagonalize matrix to get
-      eig_ = std::make_shared<MatType>(*ovlp_scr % *mat_ * *ovlp_scr);
-      eig_->diagonalize(vec_);
-      eig_ = std::make_shared<MatType>(*ovlp_scr * eig_->slice(0,nstate_));
+      // only the lowest nstate_ roots are needed
+      const MatType subspace(*ovlp_scr % *mat_ * *ovlp_scr);
+      eig_ = std::make_shared<MatType>(*ovlp_scr * *subspace.diagonalize_range(vec_, 0, nstate_));
       eig_->synchronize();
 
       // first basis vector is always the current best guess
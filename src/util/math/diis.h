@@ -54,13 +54,33 @@ class DIIS {
     friend class boost::serialization::access;
     template<class Archive>
     void serialize(Archive& ar, const unsigned int) {
-      ar & ndiis_ & data_ & matrix_ & coeff_;
+      if (!ArchiveStore::active<Archive>()) {
+        ar & ndiis_ & data_ & matrix_ & coeff_;
+        return;
+      }
+      ar & ndiis_ & matrix_ & coeff_;
+      // the history is not modified once it is added; checkpoints write each entry only once
+      size_t n = data_.size();
+      ar & n;
+      data_.resize(n);
+      for (auto& i : data_) {
+        serialize_stored(ar, i.first);
+        serialize_stored(ar, i.second);
+      }
     }
 
   public:
     DIIS() { }
     DIIS(const int ndiis) : ndiis_(ndiis), matrix_(std::make_shared<Mat>(ndiis+1, ndiis+1, true)), coeff_(std::make_shared<Mat>(ndiis+1, 1)) { }
 
+    // the history is shared with the copy; the matrices that are updated in place are not
+    std::shared_ptr<DIIS<T, Mat>> copy() const {
+      auto out = std::make_shared<DIIS<T, Mat>>(*this);
+      out->matrix_ = std::make_shared<Mat>(*matrix_);
+      out->coeff_ = std::make_shared<Mat>(*coeff_);
+      return out;
+    }
+
     std::shared_ptr<T> extrapolate(const std::pair<std::shared_ptr<const T>, std::shared_ptr<const T>> input) {
       std::shared_ptr<const T> v = input.first;
       std::shared_ptr<const T> e = input.second;
@@ -99,45 +99,42 @@ void JacobiPM::subsweep(vector<pair<int,int>>& pairlist) {
   StaticDist dist(npairs, mpi__->size());
   size_t pstart, pend;
   tie(pstart, pend) = dist.range(mpi__->rank());
-  const size_t psize = pend - pstart;
 
-  auto right = make_shared<Matrix>(nbasis_, 2*psize, true);
-  for (size_t ip = 0; ip < psize; ++ip) {
-    copy_n(SQ_->element_ptr(0, pairlist[ip + pstart].first), nbasis_, right->element_ptr(0, 2*ip));
-    copy_n(SQ_->element_ptr(0, pairlist[ip + pstart].second), nbasis_, right->element_ptr(0, 2*ip+1));
-  }
-
-  shared_ptr<Matrix> left = ( lowdin_ ? right : make_shared<Matrix>(nbasis_, 2*psize, true) );
-  if (!lowdin_) {
-    for (size_t ip = 0; ip < psize; ++ip) {
-      copy_n(Q_->element_ptr(0, pairlist[ip + pstart].first), nbasis_, left->element_ptr(0, 2*ip));
-      copy_n(Q_->element_ptr(0, pairlist[ip + pstart].second), nbasis_, left->element_ptr(0, 2*ip+1));
-    }
-  }
-
-  Matrix P_A(2*psize, 2*psize, true);
+  // The atomic blocks of an orbital are contiguous in the columns of Q_ and SQ_, so they are used in place.
+  const Matrix& left = lowdin_ ? *SQ_ : *Q_;
+  const Matrix& right = *SQ_;
 
   vector<double> AA(npairs, 0.0);
   vector<double> BB(npairs, 0.0);
 
-  for (auto& ibounds : atom_bounds_) {
-    const int natombasis = ibounds.second - ibounds.first;
-    const int boundstart = ibounds.first;
-
-    for (int ip = 0; ip < psize; ++ip) {
-      dgemm_("T", "N", 2, 2, natombasis, 1.0, left->element_ptr(boundstart, 2*ip), left->ndim(),
-          right->element_ptr(boundstart, 2*ip), right->ndim(), 0.0, P_A.element_ptr(2*ip,2*ip), P_A.ndim());
-
-      const int kk = 2*ip;
-      const int ll = 2*ip+1;
-
-      const double Qkl_A = 0.5 * (P_A(kk,ll) + P_A(ll,kk));
-      const double Qkminusl_A = P_A(kk,kk) - P_A(ll,ll);
-
-      AA[ip + pstart] += Qkl_A*Qkl_A - 0.25*Qkminusl_A*Qkminusl_A;
-      BB[ip + pstart] += Qkl_A*Qkminusl_A;
-    }
+  // The pairs in a subsweep do not share orbitals, so they are processed by threads independently
+  TaskQueue<function<void(void)>> tq(pend - pstart);
+  for (size_t ip = pstart; ip != pend; ++ip) {
+    tq.emplace_back([this, ip, &pairlist, &left, &right, &AA, &BB] {
+      const int kk = pairlist[ip].first;
+      const int ll = pairlist[ip].second;
+      double Akl = 0.0;
+      double Bkl = 0.0;
+      for (auto& ibounds : atom_bounds_) {
+        const int natombasis = ibounds.second - ibounds.first;
+        const int boundstart = ibounds.first;
+
+        const double* kleft = left.element_ptr(boundstart, kk);
+        const double* lleft = left.element_ptr(boundstart, ll);
+        const double* kright = right.element_ptr(boundstart, kk);
+        const double* lright = right.element_ptr(boundstart, ll);
+
+        const double Qkl_A = 0.5 * (ddot_(natombasis, kleft, 1, lright, 1) + ddot_(natombasis, lleft, 1, kright, 1));
+        const double Qkminusl_A = ddot_(natombasis, kleft, 1, kright, 1) - ddot_(natombasis, lleft, 1, lright, 1);
+
+        Akl += Qkl_A*Qkl_A - 0.25*Qkminusl_A*Qkminusl_A;
+        Bkl += Qkl_A*Qkminusl_A;
+      }
+      AA[ip] = Akl;
+      BB[ip] = Bkl;
+    });
   }
+  tq.compute();
 
   mpi__->allreduce(AA.data(), AA.size());
   mpi__->allreduce(BB.data(), BB.size());
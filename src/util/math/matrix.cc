@@ -98,6 +98,11 @@ Matrix& Matrix::operator/=(const Matrix& o) {
 
 
 void Matrix::diagonalize(VecView eig) {
+  diagonalize(eig, Eigensolver::QR);
+}
+
+
+void Matrix::diagonalize(VecView eig, const Eigensolver solver) {
   assert(ndim() == mdim());
   assert(eig.size() >= ndim());
   const int n = ndim();
@@ -108,8 +113,21 @@ void Matrix::diagonalize(VecView eig) {
 #ifdef HAVE_SCALAPACK
   if (localized_ || n <= blocksize__) {
 #endif
-    unique_ptr<double[]> work(new double[n*6]);
-    dsyev_("V", "L", n, data(), n, eig.data(), work.get(), n*6, info);
+    if (solver == Eigensolver::QR) {
+      unique_ptr<double[]> work(new double[n*6]);
+      dsyev_("V", "L", n, data(), n, eig.data(), work.get(), n*6, info);
+    } else if (solver == Eigensolver::DivideConquer) {
+      double wsize;
+      int liwork;
+      dsyevd_("V", "L", n, data(), n, eig.data(), &wsize, -1, &liwork, -1, info);
+      const int lwork = round(wsize);
+      unique_ptr<double[]> work(new double[lwork]);
+      unique_ptr<int[]> iwork(new int[liwork]);
+      dsyevd_("V", "L", n, data(), n, eig.data(), work.get(), lwork, iwork.get(), liwork, info);
+    } else {
+      *this = *diagonalize_range(eig, 0, n);
+      info = 0;
+    }
     mpi__->broadcast(data(), n*n, 0);
     mpi__->broadcast(eig.data(), n, 0);
 #ifdef HAVE_SCALAPACK
@@ -138,6 +156,55 @@ void Matrix::diagonalize(VecView eig) {
 }
 
 
+namespace {
+// wrapper of dsyevr; range is either "I" (first and last are 1-based indices) or "V" (eigenvalues in (lower, upper]).
+// Returns the eigenvectors; the eigenvalues are stored in eig
+shared_ptr<Matrix> syevr(const Matrix& mat, VecView eig, const char* range, const double lower, const double upper, const int first, const int last) {
+  assert(mat.ndim() == mat.mdim());
+  assert(eig.size() >= mat.ndim());
+  const int n = mat.ndim();
+  Matrix a(mat);
+  auto out = make_shared<Matrix>(n, *range == 'I' ? last-first+1 : n, mat.localized());
+  unique_ptr<int[]> isuppz(new int[2*max(n,1)]);
+  int nfound = 0;
+  int info;
+
+  double wsize;
+  int liwork;
+  dsyevr_("V", range, "L", n, a.data(), n, lower, upper, first, last, 0.0, nfound, eig.data(), out->data(), n, isuppz.get(), &wsize, -1, &liwork, -1, info);
+  const int lwork = round(wsize);
+  unique_ptr<double[]> work(new double[lwork]);
+  unique_ptr<int[]> iwork(new int[liwork]);
+  dsyevr_("V", range, "L", n, a.data(), n, lower, upper, first, last, 0.0, nfound, eig.data(), out->data(), n, isuppz.get(), work.get(), lwork, iwork.get(), liwork, info);
+  if (info) throw runtime_error("dsyevr failed in Matrix");
+
+  // the result on the root process is used to avoid inconsistency among processes
+  size_t m = nfound;
+  mpi__->broadcast(&m, 1, 0);
+  mpi__->broadcast(eig.data(), m, 0);
+  mpi__->broadcast(out->data(), n*m, 0);
+  return static_cast<int>(m) == out->mdim() ? out : out->slice_copy(0, m);
+}
+}
+
+
+shared_ptr<Matrix> Matrix::diagonalize_range(VecView eig, const int first, const int last) const {
+  assert(0 <= first && first <= last && last <= ndim());
+  if (first == last)
+    return make_shared<Matrix>(ndim(), 0, localized_);
+  shared_ptr<Matrix> out = syevr(*this, eig, "I", 0.0, 0.0, first+1, last);
+  if (out->mdim() != last-first)
+    throw runtime_error("dsyevr returned fewer eigenpairs than requested in Matrix::diagonalize_range");
+  return out;
+}
+
+
+shared_ptr<Matrix> Matrix::diagonalize_window(VecView eig, const double lower, const double upper) const {
+  assert(lower < upper);
+  return syevr(*this, eig, "V", lower, upper, 0, 0);
+}
+
+
 tuple<shared_ptr<Matrix>, shared_ptr<Matrix>> Matrix::svd(double* sing) {
   auto U = make_shared<Matrix>(ndim(), ndim());
   auto V = make_shared<Matrix>(mdim(), mdim());
@@ -70,8 +70,13 @@ class Matrix : public Matrix_base<double>, public std::enable_shared_from_this<M
     MatView slice(const int mstart, const int mend);
     const MatView slice(const int mstart, const int mend) const;
 
-    // diagonalize this matrix (overwritten by a coefficient matrix)
+    // diagonalize this matrix (overwritten by a coefficient matrix); dsyev unless another solver is requested
     void diagonalize(VecView vec) override;
+    void diagonalize(VecView vec, const Eigensolver solver);
+    // eigenpairs [first, last) in ascending order (throws if fewer are found), or those with eigenvalues in (lower, upper].
+    // Returns the eigenvectors
+    std::shared_ptr<Matrix> diagonalize_range(VecView vec, const int first, const int last) const;
+    std::shared_ptr<Matrix> diagonalize_window(VecView vec, const double lower, const double upper) const;
     std::shared_ptr<Matrix> diagonalize_blocks(VectorB& eig, std::vector<int> blocks) { return diagonalize_blocks_impl<Matrix>(eig, blocks); }
     std::tuple<std::shared_ptr<Matrix>, std::shared_ptr<Matrix>> svd(double* sing = nullptr);
     // compute S^-1. Assumes positive definite matrix
@@ -41,6 +41,10 @@
 
 namespace bagel {
 
+// LAPACK drivers for symmetric (Hermitian) eigenproblems: QR iteration (xSYEV), divide and conquer (xSYEVD),
+// and multiple relatively robust representations (xSYEVR), the last of which can compute a subset of the spectrum.
+enum class Eigensolver { QR, DivideConquer, MRRR };
+
 template<typename DataType>
 class Matrix_base : public btas::Tensor2<DataType> {
   public:
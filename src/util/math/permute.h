@@ -0,0 +1,184 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: permute.h
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+
+#ifndef __SRC_UTIL_MATH_PERMUTE_H
+#define __SRC_UTIL_MATH_PERMUTE_H
+
+#include <stddef.h>
+#include <array>
+#include <list>
+#include <thread>
+#include <algorithm>
+#include <src/util/parallel/resources.h>
+
+namespace bagel {
+
+/// Cache-blocked permutation of dense tensors, used by sort_indices.
+/** The conventions are those of sort_indices: dim holds the extents of the input (fastest first), and the n-th index
+    of the output is the perm[n]-th index of the input. When accumulate is true, out = afac*out + fac*in; otherwise out = fac*in.
+    The plane spanned by the fastest input and output indices is traversed in tiles of 32x32 that are transposed in
+    4x4 blocks held in registers. Large tensors are distributed over threads unless called from a threaded region. */
+template<bool accumulate, int... perm>
+class TensorPermutation {
+  protected:
+    static constexpr int N = sizeof...(perm);
+    static constexpr int tile_ = 32;
+    static constexpr int block_ = 4;
+    static constexpr size_t thread_threshold_ = 1lu << 20;
+
+    template<class T>
+    static void update(T& out, const T& in, const T& afac, const T& fac) {
+      if (accumulate)
+        out = afac*out + fac*in;
+      else
+        out = fac*in;
+    }
+
+    // out(y, x) <- in(x, y) for a block_ x block_ block
+    template<class T>
+    static void kernel(const T* in, T* out, const size_t ldi, const size_t ldo, const T& afac, const T& fac) {
+      T buf[block_][block_];
+      for (int y = 0; y != block_; ++y)
+        for (int x = 0; x != block_; ++x)
+          buf[x][y] = in[x+ldi*y];
+      for (int x = 0; x != block_; ++x)
+        for (int y = 0; y != block_; ++y)
+          update(out[y+ldo*x], buf[x][y], afac, fac);
+    }
+
+    // transposes one nx x ny plane (ny <= tile_)
+    template<class T>
+    static void plane(const T* in, T* out, const int nx, const int ny, const size_t ldi, const size_t ldo, const T& afac, const T& fac) {
+      for (int x0 = 0; x0 < nx; x0 += tile_) {
+        const int x1 = std::min(nx, x0+tile_);
+        int y = 0;
+        for (; y+block_ <= ny; y += block_) {
+          int x = x0;
+          for (; x+block_ <= x1; x += block_)
+            kernel(in+x+ldi*y, out+y+ldo*x, ldi, ldo, afac, fac);
+          for (; x < x1; ++x)
+            for (int yy = y; yy != y+block_; ++yy)
+              update(out[yy+ldo*x], in[x+ldi*yy], afac, fac);
+        }
+        for (; y < ny; ++y)
+          for (int x = x0; x < x1; ++x)
+            update(out[y+ldo*x], in[x+ldi*y], afac, fac);
+      }
+    }
+
+  public:
+    template<class T>
+    static void apply(const T* in, T* out, const std::array<int,N>& dim, const T afac, const T fac) {
+      const std::array<int,N> p{{perm...}};
+
+      std::array<size_t,N> istride, ostride;
+      size_t size = 1;
+      for (int n = 0; n != N; ++n) {
+        istride[n] = size;
+        size *= dim[n];
+      }
+      if (size == 0) return;
+      size_t stride = 1;
+      for (int n = 0; n != N; ++n) {
+        ostride[p[n]] = stride;
+        stride *= dim[p[n]];
+      }
+
+      // x is the fastest input index and y the fastest output index. When they coincide, rows are copied as they are.
+      const int y = p[0];
+      const int nx = dim[0];
+      const int ny = y == 0 ? 1 : dim[y];
+      const int nytile = (ny-1)/tile_+1;
+
+      std::array<int,N> rest;
+      int nrest = 0;
+      size_t nouter = 1;
+      for (int n = 1; n != N; ++n)
+        if (n != y) {
+          rest[nrest++] = n;
+          nouter *= dim[n];
+        }
+
+      // a unit of work is one tile of the plane (or one row) for a given set of the other indices
+      auto work = [&](const size_t start, const size_t fence) {
+        std::array<int,N> idx;
+        size_t ioff = 0, ooff = 0;
+        size_t outer = start / nytile;
+        int ytile = start % nytile;
+        for (int r = 0; r != nrest; ++r) {
+          idx[r] = outer % dim[rest[r]];
+          outer /= dim[rest[r]];
+          ioff += idx[r] * istride[rest[r]];
+          ooff += idx[r] * ostride[rest[r]];
+        }
+        for (size_t u = start; u != fence; ++u) {
+          if (y == 0) {
+            for (int x = 0; x != nx; ++x)
+              update(out[ooff+x], in[ioff+x], afac, fac);
+          } else {
+            const int y0 = ytile*tile_;
+            plane(in+ioff+istride[y]*y0, out+ooff+y0, nx, std::min(tile_, ny-y0), istride[y], ostride[0], afac, fac);
+          }
+          if (++ytile == nytile) {
+            ytile = 0;
+            for (int r = 0; r != nrest; ++r) {
+              const int e = rest[r];
+              ioff += istride[e];
+              ooff += ostride[e];
+              if (++idx[r] < dim[e]) break;
+              ioff -= idx[r] * istride[e];
+              ooff -= idx[r] * ostride[e];
+              idx[r] = 0;
+            }
+          }
+        }
+      };
+
+      const size_t nunit = nouter * nytile;
+      const size_t nthreads = (size < thread_threshold_ || resources__->in_parallel()) ? 1lu : std::min(resources__->max_num_threads(), nunit);
+      if (nthreads <= 1) {
+        work(0, nunit);
+      } else {
+        resources__->begin_parallel();
+        std::list<std::thread> threads;
+        for (size_t i = 1; i != nthreads; ++i)
+          threads.emplace_back(work, nunit*i/nthreads, nunit*(i+1)/nthreads);
+        work(0, nunit/nthreads);
+        for (auto& i : threads)
+          i.join();
+        resources__->end_parallel();
+      }
+    }
+};
+
+// definitions of the static members (they are odr-used, e.g., by std::min)
+template<bool accumulate, int... perm> constexpr int TensorPermutation<accumulate, perm...>::N;
+template<bool accumulate, int... perm> constexpr int TensorPermutation<accumulate, perm...>::tile_;
+template<bool accumulate, int... perm> constexpr int TensorPermutation<accumulate, perm...>::block_;
+template<bool accumulate, int... perm> constexpr size_t TensorPermutation<accumulate, perm...>::thread_threshold_;
+
+}
+
+#endif
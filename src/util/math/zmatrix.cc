@@ -149,6 +149,40 @@ void ZMatrix::diagonalize(VecView eig) {
 }
 
 
+shared_ptr<ZMatrix> ZMatrix::diagonalize_range(VecView eig, const int first, const int last) const {
+  if (ndim() != mdim()) throw logic_error("illegal call of ZMatrix::diagonalize_range");
+  assert(eig.size() >= ndim());
+  assert(0 <= first && first <= last && last <= ndim());
+  const int n = ndim();
+  auto out = make_shared<ZMatrix>(n, last-first, localized_);
+  if (first == last)
+    return out;
+
+  ZMatrix a(*this);
+  unique_ptr<int[]> isuppz(new int[2*n]);
+  int nfound = 0;
+  int info;
+
+  complex<double> wsize;
+  double rsize;
+  int liwork;
+  zheevr_("V", "I", "L", n, a.data(), n, 0.0, 0.0, first+1, last, 0.0, nfound, eig.data(), out->data(), n, isuppz.get(),
+          &wsize, -1, &rsize, -1, &liwork, -1, info);
+  const int lwork = round(wsize.real());
+  const int lrwork = round(rsize);
+  unique_ptr<complex<double>[]> work(new complex<double>[lwork]);
+  unique_ptr<double[]> rwork(new double[lrwork]);
+  unique_ptr<int[]> iwork(new int[liwork]);
+  zheevr_("V", "I", "L", n, a.data(), n, 0.0, 0.0, first+1, last, 0.0, nfound, eig.data(), out->data(), n, isuppz.get(),
+          work.get(), lwork, rwork.get(), lrwork, iwork.get(), liwork, info);
+  if (info || nfound != last-first) throw runtime_error("zheevr failed in ZMatrix");
+
+  mpi__->broadcast(eig.data(), nfound, 0);
+  mpi__->broadcast(out->data(), out->size(), 0);
+  return out;
+}
+
+
 tuple<shared_ptr<ZMatrix>, shared_ptr<ZMatrix>> ZMatrix::svd(double* sing) {
   auto U = make_shared<ZMatrix>(ndim(), ndim());
   auto V = make_shared<ZMatrix>(mdim(), mdim());
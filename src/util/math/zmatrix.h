@@ -71,6 +71,8 @@ class ZMatrix : public Matrix_base<std::complex<double>>, public std::enable_sha
 
     // diagonalize this matrix (overwritten by a coefficient matrix)
     virtual void diagonalize(VecView vec);
+    // eigenpairs [first, last) in ascending order (throws if fewer are found). Returns the eigenvectors
+    std::shared_ptr<ZMatrix> diagonalize_range(VecView vec, const int first, const int last) const;
 
     std::shared_ptr<ZMatrix> diagonalize_blocks(VectorB& eig, std::vector<int> blocks) { return diagonalize_blocks_impl<ZMatrix>(eig, blocks); }
 
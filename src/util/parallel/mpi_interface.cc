@@ -37,7 +37,7 @@ using namespace std;
 using namespace bagel;
 
 MPI_Interface::MPI_Interface()
- : cnt_(0), nprow_(0), npcol_(0), context_(0), myprow_(0), mypcol_(0), mpimutex_() {
+ : ngroup_(1), group_(0), cnt_(0), nprow_(0), npcol_(0), context_(0), myprow_(0), mypcol_(0), mpimutex_() {
 
 #ifdef HAVE_MPI_H
   int provided;
@@ -45,8 +45,9 @@ MPI_Interface::MPI_Interface()
   if (provided != MPI_THREAD_MULTIPLE)
     throw runtime_error("MPI_THREAD_MULTIPLE not provided");
 
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank_);
-  MPI_Comm_size(MPI_COMM_WORLD, &size_);
+  mpi_comm_ = MPI_COMM_WORLD;
+  MPI_Comm_rank(mpi_comm_, &rank_);
+  MPI_Comm_size(mpi_comm_, &size_);
 #ifdef HAVE_SCALAPACK
   tie(nprow_, npcol_) = numgrid(size());
   if (rank() == 0)
@@ -86,10 +87,14 @@ MPI_Interface::MPI_Interface()
   rank_ = 0;
   size_ = 1;
 #endif
+  world_rank_ = rank_;
+  world_size_ = size_;
 }
 
 
 MPI_Interface::~MPI_Interface() {
+  if (is_split())
+    merge();
 #ifdef HAVE_MPI_H
 #ifndef HAVE_SCALAPACK
   MPI_Finalize();
@@ -101,9 +106,57 @@ MPI_Interface::~MPI_Interface() {
 }
 
 
-void MPI_Interface::barrier() const {
+void MPI_Interface::split(const int n) {
+  if (is_split())
+    throw logic_error("MPI_Interface::split called while the processes are already split");
+  if (n < 1 || n > world_size_)
+    throw runtime_error("the number of process groups should be between 1 and the number of processes");
+  if (n == 1)
+    return;
 #ifdef HAVE_MPI_H
   MPI_Barrier(MPI_COMM_WORLD);
+  ngroup_ = n;
+  group_ = static_cast<long>(world_rank_) * n / world_size_;
+  MPI_Comm_split(MPI_COMM_WORLD, group_, world_rank_, &mpi_comm_);
+  MPI_Comm_rank(mpi_comm_, &rank_);
+  MPI_Comm_size(mpi_comm_, &size_);
+#ifdef HAVE_SCALAPACK
+  world_grid_ = {{nprow_, npcol_, context_, myprow_, mypcol_}};
+  tie(nprow_, npcol_) = numgrid(size_);
+  context_ = Csys2blacs_handle(mpi_comm_);
+  Cblacs_gridinit(&context_, "R", nprow_, npcol_);
+  blacs_gridinfo_(context_, nprow_, npcol_, myprow_, mypcol_);
+#endif
+#endif
+}
+
+
+void MPI_Interface::merge() {
+  if (!is_split())
+    return;
+#ifdef HAVE_MPI_H
+  MPI_Barrier(MPI_COMM_WORLD);
+#ifdef HAVE_SCALAPACK
+  blacs_gridexit_(context_);
+  nprow_   = world_grid_[0];
+  npcol_   = world_grid_[1];
+  context_ = world_grid_[2];
+  myprow_  = world_grid_[3];
+  mypcol_  = world_grid_[4];
+#endif
+  MPI_Comm_free(&mpi_comm_);
+  mpi_comm_ = MPI_COMM_WORLD;
+  rank_ = world_rank_;
+  size_ = world_size_;
+#endif
+  ngroup_ = 1;
+  group_ = 0;
+}
+
+
+void MPI_Interface::barrier() const {
+#ifdef HAVE_MPI_H
+  MPI_Barrier(mpi_comm_);
 #endif
 }
 
@@ -113,7 +166,7 @@ void MPI_Interface::allreduce(double* a, const size_t size) const {
   assert(size != 0);
   const int nbatch = (size-1)/bsize  + 1;
   for (int i = 0; i != nbatch; ++i)
-    MPI_Allreduce(MPI_IN_PLACE, static_cast<void*>(a+i*bsize), (i+1 == nbatch ? size-i*bsize : bsize), MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, static_cast<void*>(a+i*bsize), (i+1 == nbatch ? size-i*bsize : bsize), MPI_DOUBLE, MPI_SUM, mpi_comm_);
 #endif
 }
 
@@ -123,7 +176,7 @@ void MPI_Interface::allreduce(int* a, const size_t size) const {
   assert(size != 0);
   const int nbatch = (size-1)/bsize  + 1;
   for (int i = 0; i != nbatch; ++i)
-    MPI_Allreduce(MPI_IN_PLACE, static_cast<void*>(a+i*bsize), (i+1 == nbatch ? size-i*bsize : bsize), MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, static_cast<void*>(a+i*bsize), (i+1 == nbatch ? size-i*bsize : bsize), MPI_INT, MPI_SUM, mpi_comm_);
 #endif
 }
 
@@ -133,7 +186,7 @@ void MPI_Interface::allreduce(complex<double>* a, const size_t size) const {
   assert(size != 0);
   const int nbatch = (size-1)/bsize  + 1;
   for (int i = 0; i != nbatch; ++i)
-    MPI_Allreduce(MPI_IN_PLACE, static_cast<void*>(a+i*bsize), (i+1 == nbatch ? size-i*bsize : bsize), MPI_CXX_DOUBLE_COMPLEX, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, static_cast<void*>(a+i*bsize), (i+1 == nbatch ? size-i*bsize : bsize), MPI_CXX_DOUBLE_COMPLEX, MPI_SUM, mpi_comm_);
 #endif
 }
 
@@ -144,7 +197,7 @@ void MPI_Interface::broadcast(size_t* a, const size_t size, const int root) cons
   assert(size != 0);
   const int nbatch = (size-1)/bsize  + 1;
   for (int i = 0; i != nbatch; ++i)
-    MPI_Bcast(static_cast<void*>(a+i*bsize), (i+1 == nbatch ? size-i*bsize : bsize), MPI_UNSIGNED_LONG_LONG, root, MPI_COMM_WORLD);
+    MPI_Bcast(static_cast<void*>(a+i*bsize), (i+1 == nbatch ? size-i*bsize : bsize), MPI_UNSIGNED_LONG_LONG, root, mpi_comm_);
 #endif
 }
 
@@ -154,7 +207,7 @@ void MPI_Interface::broadcast(double* a, const size_t size, const int root) cons
   assert(size != 0);
   const int nbatch = (size-1)/bsize  + 1;
   for (int i = 0; i != nbatch; ++i)
-    MPI_Bcast(static_cast<void*>(a+i*bsize), (i+1 == nbatch ? size-i*bsize : bsize), MPI_DOUBLE, root, MPI_COMM_WORLD);
+    MPI_Bcast(static_cast<void*>(a+i*bsize), (i+1 == nbatch ? size-i*bsize : bsize), MPI_DOUBLE, root, mpi_comm_);
 #endif
 }
 
@@ -164,7 +217,7 @@ void MPI_Interface::broadcast(complex<double>* a, const size_t size, const int r
   assert(size != 0);
   const int nbatch = (size-1)/bsize  + 1;
   for (int i = 0; i != nbatch; ++i)
-    MPI_Bcast(static_cast<void*>(a+i*bsize), (i+1 == nbatch ? size-i*bsize : bsize), MPI_CXX_DOUBLE_COMPLEX, root, MPI_COMM_WORLD);
+    MPI_Bcast(static_cast<void*>(a+i*bsize), (i+1 == nbatch ? size-i*bsize : bsize), MPI_CXX_DOUBLE_COMPLEX, root, mpi_comm_);
 #endif
 }
 
@@ -172,7 +225,7 @@ void MPI_Interface::broadcast(complex<double>* a, const size_t size, const int r
 void MPI_Interface::allgather(const double* send, const size_t ssize, double* rec, const size_t rsize) const {
 #ifdef HAVE_MPI_H
   // I hate const_cast. Blame the MPI C binding
-  MPI_Allgather(const_cast<void*>(static_cast<const void*>(send)), ssize, MPI_DOUBLE, static_cast<void*>(rec), rsize, MPI_DOUBLE, MPI_COMM_WORLD);
+  MPI_Allgather(const_cast<void*>(static_cast<const void*>(send)), ssize, MPI_DOUBLE, static_cast<void*>(rec), rsize, MPI_DOUBLE, mpi_comm_);
 #else
   assert(ssize == rsize);
   copy_n(send, ssize, rec);
@@ -183,7 +236,7 @@ void MPI_Interface::allgather(const double* send, const size_t ssize, double* re
 void MPI_Interface::allgather(const complex<double>* send, const size_t ssize, complex<double>* rec, const size_t rsize) const {
 #ifdef HAVE_MPI_H
   // I hate const_cast. Blame the MPI C binding
-  MPI_Allgather(const_cast<void*>(static_cast<const void*>(send)), ssize, MPI_CXX_DOUBLE_COMPLEX, static_cast<void*>(rec), rsize, MPI_CXX_DOUBLE_COMPLEX, MPI_COMM_WORLD);
+  MPI_Allgather(const_cast<void*>(static_cast<const void*>(send)), ssize, MPI_CXX_DOUBLE_COMPLEX, static_cast<void*>(rec), rsize, MPI_CXX_DOUBLE_COMPLEX, mpi_comm_);
 #else
   assert(ssize == rsize);
   copy_n(send, ssize, rec);
@@ -195,7 +248,7 @@ void MPI_Interface::allgather(const size_t* send, const size_t ssize, size_t* re
 #ifdef HAVE_MPI_H
   static_assert(sizeof(size_t) == sizeof(unsigned long long), "size_t is assumed to be the same size as unsigned long long");
   // I hate const_cast. Blame the MPI C binding
-  MPI_Allgather(const_cast<void*>(static_cast<const void*>(send)), ssize, MPI_UNSIGNED_LONG_LONG, static_cast<void*>(rec), rsize, MPI_UNSIGNED_LONG_LONG, MPI_COMM_WORLD);
+  MPI_Allgather(const_cast<void*>(static_cast<const void*>(send)), ssize, MPI_UNSIGNED_LONG_LONG, static_cast<void*>(rec), rsize, MPI_UNSIGNED_LONG_LONG, mpi_comm_);
 #else
   assert(ssize == rsize);
   copy_n(send, ssize, rec);
@@ -206,7 +259,7 @@ void MPI_Interface::allgather(const size_t* send, const size_t ssize, size_t* re
 void MPI_Interface::allgather(const int* send, const size_t ssize, int* rec, const size_t rsize) const {
 #ifdef HAVE_MPI_H
   // I hate const_cast. Blame the MPI C binding
-  MPI_Allgather(const_cast<void*>(static_cast<const void*>(send)), ssize, MPI_INT, static_cast<void*>(rec), rsize, MPI_INT, MPI_COMM_WORLD);
+  MPI_Allgather(const_cast<void*>(static_cast<const void*>(send)), ssize, MPI_INT, static_cast<void*>(rec), rsize, MPI_INT, mpi_comm_);
 #else
   assert(ssize == rsize);
   copy_n(send, ssize, rec);
@@ -222,7 +275,7 @@ int MPI_Interface::request_send(const double* sbuf, const size_t size, const int
   for (int i = 0; i != nbatch; ++i) {
     MPI_Request c;
     // I hate const_cast. Blame the MPI C binding
-    MPI_Isend(const_cast<double*>(sbuf+i*bsize), (i+1 == nbatch ? size-i*bsize : bsize), MPI_DOUBLE, dest, tag, MPI_COMM_WORLD, &c);
+    MPI_Isend(const_cast<double*>(sbuf+i*bsize), (i+1 == nbatch ? size-i*bsize : bsize), MPI_DOUBLE, dest, tag, mpi_comm_, &c);
     rq.push_back(c);
   }
 #endif
@@ -243,7 +296,7 @@ int MPI_Interface::request_send(const complex<double>* sbuf, const size_t size,
   for (int i = 0; i != nbatch; ++i) {
     MPI_Request c;
     // I hate const_cast. Blame the MPI C binding
-    MPI_Isend(const_cast<complex<double>*>(sbuf+i*bsize), (i+1 == nbatch ? size-i*bsize : bsize), MPI_CXX_DOUBLE_COMPLEX, dest, tag, MPI_COMM_WORLD, &c);
+    MPI_Isend(const_cast<complex<double>*>(sbuf+i*bsize), (i+1 == nbatch ? size-i*bsize : bsize), MPI_CXX_DOUBLE_COMPLEX, dest, tag, mpi_comm_, &c);
     rq.push_back(c);
   }
 #endif
@@ -265,7 +318,7 @@ int MPI_Interface::request_send(const size_t* sbuf, const size_t size, const int
   for (int i = 0; i != nbatch; ++i) {
     MPI_Request c;
     // I hate const_cast. Blame the MPI C binding
-    MPI_Isend(const_cast<size_t*>(sbuf+i*bsize), (i+1 == nbatch ? size-i*bsize : bsize), MPI_UNSIGNED_LONG_LONG, dest, tag, MPI_COMM_WORLD, &c);
+    MPI_Isend(const_cast<size_t*>(sbuf+i*bsize), (i+1 == nbatch ? size-i*bsize : bsize), MPI_UNSIGNED_LONG_LONG, dest, tag, mpi_comm_, &c);
     rq.push_back(c);
   }
 #endif
@@ -286,7 +339,7 @@ int MPI_Interface::request_recv(double* rbuf, const size_t size, const int origi
   const int nbatch = (size-1)/bsize  + 1;
   for (int i = 0; i != nbatch; ++i) {
     MPI_Request c;
-    MPI_Irecv(rbuf+i*bsize, (i+1 == nbatch ? size-i*bsize : bsize), MPI_DOUBLE, (origin == -1 ? MPI_ANY_SOURCE : origin), (tag==-1 ? MPI_ANY_TAG : tag), MPI_COMM_WORLD, &c);
+    MPI_Irecv(rbuf+i*bsize, (i+1 == nbatch ? size-i*bsize : bsize), MPI_DOUBLE, (origin == -1 ? MPI_ANY_SOURCE : origin), (tag==-1 ? MPI_ANY_TAG : tag), mpi_comm_, &c);
     rq.push_back(c);
   }
 #endif
@@ -306,7 +359,7 @@ int MPI_Interface::request_recv(complex<double>* rbuf, const size_t size, const
   const int nbatch = (size-1)/bsize  + 1;
   for (int i = 0; i != nbatch; ++i) {
     MPI_Request c;
-    MPI_Irecv(rbuf+i*bsize, (i+1 == nbatch ? size-i*bsize : bsize), MPI_CXX_DOUBLE_COMPLEX, (origin == -1 ? MPI_ANY_SOURCE : origin), (tag==-1 ? MPI_ANY_TAG : tag), MPI_COMM_WORLD, &c);
+    MPI_Irecv(rbuf+i*bsize, (i+1 == nbatch ? size-i*bsize : bsize), MPI_CXX_DOUBLE_COMPLEX, (origin == -1 ? MPI_ANY_SOURCE : origin), (tag==-1 ? MPI_ANY_TAG : tag), mpi_comm_, &c);
     rq.push_back(c);
   }
 #endif
@@ -326,7 +379,7 @@ int MPI_Interface::request_recv(size_t* rbuf, const size_t size, const int origi
   const int nbatch = (size-1)/bsize  + 1;
   for (int i = 0; i != nbatch; ++i) {
     MPI_Request c;
-    MPI_Irecv(rbuf+i*bsize, (i+1 == nbatch ? size-i*bsize : bsize), MPI_UNSIGNED_LONG_LONG, (origin == -1 ? MPI_ANY_SOURCE : origin), (tag==-1 ? MPI_ANY_TAG : tag), MPI_COMM_WORLD, &c);
+    MPI_Irecv(rbuf+i*bsize, (i+1 == nbatch ? size-i*bsize : bsize), MPI_UNSIGNED_LONG_LONG, (origin == -1 ? MPI_ANY_SOURCE : origin), (tag==-1 ? MPI_ANY_TAG : tag), mpi_comm_, &c);
     rq.push_back(c);
   }
 #endif
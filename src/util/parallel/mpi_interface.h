@@ -32,6 +32,7 @@
 #include <mutex>
 #include <vector>
 #include <map>
+#include <array>
 #ifdef HAVE_MPI_H
  #include <mpi.h>
 #endif
@@ -42,6 +43,15 @@ class MPI_Interface {
   protected:
     int rank_;
     int size_;
+    int world_rank_;
+    int world_size_;
+#ifdef HAVE_MPI_H
+    // communicator used by all of the functions below (MPI_COMM_WORLD unless split)
+    MPI_Comm mpi_comm_;
+#endif
+    // number of groups and the group this process belongs to
+    int ngroup_;
+    int group_;
 
     int cnt_;
     // request handles
@@ -53,6 +63,8 @@ class MPI_Interface {
     int context_;
     int myprow_;
     int mypcol_;
+    // process grid of MPI_COMM_WORLD, kept while split
+    std::array<int,5> world_grid_;
 
     // maximum size of the MPI buffer
     static constexpr size_t bsize = 100000000LU;
@@ -70,6 +82,19 @@ class MPI_Interface {
     int rank() const { return rank_; }
     int size() const { return size_; }
     bool last() const { return rank() == size()-1; }
+    int world_rank() const { return world_rank_; }
+    int world_size() const { return world_size_; }
+#ifdef HAVE_MPI_H
+    MPI_Comm mpi_comm() const { return mpi_comm_; }
+#endif
+
+    // splits the processes into n groups of contiguous ranks; until merge() is called, rank(), size(),
+    // the collective functions and the process grid refer to the group this process belongs to
+    void split(const int n);
+    void merge();
+    bool is_split() const { return ngroup_ > 1; }
+    int ngroup() const { return ngroup_; }
+    int group() const { return group_; }
 
     // collective functions
     // barrier
@@ -100,9 +100,11 @@ namespace bagel {
     std::shared_ptr<Process> proc_;
     std::map<std::shared_ptr<StackMem>, std::atomic_flag> stackmem_;
     size_t max_num_threads_;
+    // number of threaded regions (TaskQueue etc.) that are running; code inside them should not spawn threads
+    std::atomic<int> parallel_regions_;
 
   public:
-    Resources(const int max) : proc_(std::make_shared<Process>()), max_num_threads_(max) {
+    Resources(const int max) : proc_(std::make_shared<Process>()), max_num_threads_(max), parallel_regions_(0) {
 #ifdef LIBINT_INTERFACE
       LIBINT2_PREFIXED_NAME(libint2_static_init)();
 #endif
@@ -128,6 +130,10 @@ namespace bagel {
     }
 
     size_t max_num_threads() const { return max_num_threads_; }
+
+    void begin_parallel() { ++parallel_regions_; }
+    void end_parallel() { --parallel_regions_; }
+    bool in_parallel() const { return parallel_regions_ > 0; }
     std::shared_ptr<Process> proc() { return proc_; }
 };
 
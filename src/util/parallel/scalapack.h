@@ -31,6 +31,7 @@
 #include <cassert>
 #include <cmath>
 #include <complex>
+#include <mpi.h>
 
 extern "C" {
   // scalapack routines
@@ -39,6 +40,9 @@ extern "C" {
   void blacs_gridexit_(const int*);
   void blacs_exit_(int*);
   int blacs_pnum_(const int*, const int*, const int*);
+  // C interface of BLACS, used to set up process grids on subcommunicators
+  int Csys2blacs_handle(MPI_Comm);
+  void Cblacs_gridinit(int*, const char*, int, int);
 
   int numroc_(const int* globalsize, const int* blocksize, const int* myrow, const int* startproc, const int* nproc);
   void descinit_(int* desc, const int* dimr, const int* dimc, const int* nbr, const int* nbc, const int* nsr, const int* nsc, const int* context, const int* ld, int* info);
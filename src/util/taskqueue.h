@@ -83,6 +83,7 @@ class TaskQueue {
       const int mkl_num = mkl_get_max_threads();
       mkl_set_num_threads(1);
 #endif
+      resources__->begin_parallel();
 #ifndef _OPENMP
       flag_.resize((task_.size()-1)/chunck_+1);
       std::for_each(flag_.begin(), flag_.end(), [](std::atomic_flag& i){ i.clear(); });
@@ -96,6 +97,7 @@ class TaskQueue {
       for (size_t i = 0; i < n; ++i)
         call_compute(task_[i]);
 #endif
+      resources__->end_parallel();
 #ifdef HAVE_MKL_H
       mkl_set_num_threads(mkl_num);
 #endif
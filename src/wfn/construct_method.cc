@@ -32,6 +32,7 @@
 #include <src/ci/fci/knowles.h>
 #include <src/ci/ras/rasci.h>
 #include <src/ci/zfci/zharrison.h>
+#include <src/ci/zfci/distzharrison.h>
 #include <src/pt2/nevpt2/nevpt2.h>
 #include <src/pt2/mp2/mp2.h>
 #include <src/pt2/dmp2/dmp2.h>
@@ -69,7 +70,17 @@ shared_ptr<Method> construct_method(string title, shared_ptr<const PTree> itree,
     else if (title == "dmp2")     out = make_shared<DMP2>(itree, geom, ref);
     else if (title == "smith")    out = make_shared<Smith>(itree, geom, ref);
     else if (title == "relsmith") out = make_shared<RelSmith>(itree, geom, ref);
-    else if (title == "zfci")     out = make_shared<ZHarrison>(itree, geom, ref);
+    else if (title == "zfci") {
+      const string algorithm = itree->get<string>("algorithm", "");
+      if (algorithm == "hz" || algorithm == "harrison" || algorithm == "zarrabian" || algorithm == "")
+        out = make_shared<ZHarrison>(itree, geom, ref);
+#ifdef HAVE_MPI_H
+      else if (algorithm == "parallel" || algorithm == "dist")
+        out = make_shared<DistZHarrison>(itree, geom, ref);
+#endif
+      else
+        throw runtime_error("unknown ZFCI algorithm specified. " + algorithm);
+    }
     else if (title == "ras") {
       const string algorithm = itree->get<string>("algorithm", "");
       if ( algorithm == "local" || algorithm == "" )
@@ -131,7 +142,17 @@ shared_ptr<Method> construct_method(string title, shared_ptr<const PTree> itree,
     if (title == "hf")              out = make_shared<RHF_London>(itree, geom, ref);
     else if (title == "dhf")        out = make_shared<Dirac>(itree, geom, ref);
     else if (title == "current")    out = make_shared<Current>(itree, geom, ref);
-    else if (title == "zfci")       out = make_shared<ZHarrison>(itree, geom, ref);
+    else if (title == "zfci") {
+      const string algorithm = itree->get<string>("algorithm", "");
+      if (algorithm == "hz" || algorithm == "harrison" || algorithm == "zarrabian" || algorithm == "")
+        out = make_shared<ZHarrison>(itree, geom, ref);
+#ifdef HAVE_MPI_H
+      else if (algorithm == "parallel" || algorithm == "dist")
+        out = make_shared<DistZHarrison>(itree, geom, ref);
+#endif
+      else
+        throw runtime_error("unknown ZFCI algorithm specified. " + algorithm);
+    }
     else if (title == "zcasscf") {
       string algorithm = itree->get<string>("algorithm", "");
       if (algorithm == "second" || algorithm == "") {
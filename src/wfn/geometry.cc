@@ -25,6 +25,7 @@
 
 #include <src/wfn/geometry.h>
 #include <src/df/complexdf.h>
+#include <src/df/choleskydist.h>
 #include <src/integral/rys/eribatch.h>
 #include <src/integral/rys/smalleribatch.h>
 #include <src/integral/rys/mixederibatch.h>
@@ -38,6 +39,29 @@
 using namespace std;
 using namespace bagel;
 
+namespace {
+// elements (in the convention of the basis files) for which the basis sets are read
+set<string> basis_elements(shared_ptr<const PTree> atoms) {
+  set<string> out;
+  for (auto& a : *atoms) {
+    string na = to_lower(a->get<string>("atom"));
+    na[0] = toupper(na[0]);
+    if (na != "Q") out.insert(na);
+  }
+  return out;
+}
+
+set<string> basis_elements(const vector<shared_ptr<const Atom>>& atoms) {
+  set<string> out;
+  for (auto& a : atoms) {
+    string na = a->name();
+    na[0] = toupper(na[0]);
+    if (!a->dummy()) out.insert(na);
+  }
+  return out;
+}
+}
+
 
 BOOST_CLASS_EXPORT_IMPLEMENT(Geometry)
 
@@ -50,6 +74,7 @@ Geometry::Geometry(shared_ptr<const PTree> geominfo) : magnetism_(false), do_per
 
   schwarz_thresh_ = geominfo->get<double>("schwarz_thresh", 1.0e-12);
   overlap_thresh_ = geominfo->get<double>("thresh_overlap", 1.0e-8);
+  cholesky_thresh_ = geominfo->get<double>("cholesky_thresh", 1.0e-6);
 
   // symmetry
   symmetry_ = to_lower(geominfo->get<string>("symmetry", "c1"));
@@ -101,10 +126,10 @@ Geometry::Geometry(shared_ptr<const PTree> geominfo) : magnetism_(false), do_per
   } else {
 
     // read the default basis file
-    shared_ptr<const PTree> bdata = PTree::read_basis(basisfile_);
+    auto atoms = geominfo->get_child("geometry");
+    shared_ptr<const PTree> bdata = PTree::read_basis(basisfile_, basis_elements(atoms));
     shared_ptr<const PTree> elem = geominfo->get_child_optional("_basis");
 
-    auto atoms = geominfo->get_child("geometry");
     use_ecp_basis_ = (basisfile_.find("ecp") != string::npos) ? true : false;
     for (auto& a : *atoms)
       atoms_.push_back(make_shared<const Atom>(a, spherical_, angstrom, make_pair(basisfile_, bdata), elem, false, use_ecp_basis_, use_finite_));
@@ -116,10 +141,12 @@ Geometry::Geometry(shared_ptr<const PTree> geominfo) : magnetism_(false), do_per
 
   /* Set up aux_atoms_ */
   auxfile_ = geominfo->get<string>("df_basis", "");  // default value for non-DF HF.
-  if (!auxfile_.empty()) {
+  if (cholesky() && !primitive_vectors_.empty())
+    throw runtime_error("Cholesky-decomposed integrals are not available for periodic systems");
+  if (!auxfile_.empty() && !cholesky()) {
     if (!primitive_vectors_.empty()) do_periodic_df_ = true;
     // read the default aux basis file
-    shared_ptr<const PTree> bdata = PTree::read_basis(auxfile_);
+    shared_ptr<const PTree> bdata = PTree::read_basis(auxfile_, basis_elements(atoms_));
     shared_ptr<const PTree> elem = geominfo->get_child_optional("_df_basis");
     if (basisfile_ == "molden") {
       for(auto& iatom : atoms_) {
@@ -153,7 +180,12 @@ void Geometry::common_init2(const bool print, const double thresh, const bool no
 
   if (london_ || nonzero_magnetic_field()) init_magnetism();
 
-  if (!auxfile_.empty() && !nodf && !do_periodic_df_ && !dofmm_) {
+  if (cholesky() && !nodf && !dofmm_) {
+    cout << "  Since Cholesky decomposition is requested, we compute the Cholesky vectors of the two-electron integrals:" << endl;
+    Timer timer;
+    compute_integrals(thresh);
+    cout << "        elapsed time:  " << setw(10) << setprecision(2) << timer.tick() << " sec." << endl << endl;
+  } else if (!auxfile_.empty() && !nodf && !do_periodic_df_ && !dofmm_) {
     if (print) cout << "  Number of auxiliary basis functions: " << setw(8) << naux() << endl << endl;
     cout << "  Since a DF basis is specified, we compute 2- and 3-index integrals:" << endl;
     const double scale = magnetism_ ? 2.0 : 1.0;
@@ -164,6 +196,10 @@ void Geometry::common_init2(const bool print, const double thresh, const bool no
     cout << "        elapsed time:  " << setw(10) << setprecision(2) << timer.tick() << " sec." << endl << endl;
   }
 
+  // the number of Cholesky vectors is only known after the decomposition
+  if (cholesky() && df_)
+    naux_ = df_->naux();
+
   // symmetry set-up
   plist_ = make_shared<Petite>(atoms_, symmetry_);
   nirrep_ = plist_->nirrep();
@@ -183,7 +219,7 @@ void Geometry::common_init2(const bool print, const double thresh, const bool no
 
 // suitable for geometry updates in optimization
 Geometry::Geometry(const Geometry& o, shared_ptr<const Matrix> displ, shared_ptr<const PTree> geominfo, const bool rotate, const bool nodf)
-  : schwarz_thresh_(o.schwarz_thresh_), dkh_(o.dkh_), magnetism_(false), london_(o.london_), use_finite_(o.use_finite_), use_ecp_basis_(o.use_ecp_basis_),
+  : schwarz_thresh_(o.schwarz_thresh_), cholesky_thresh_(o.cholesky_thresh_), dkh_(o.dkh_), magnetism_(false), london_(o.london_), use_finite_(o.use_finite_), use_ecp_basis_(o.use_ecp_basis_),
     do_periodic_df_(o.do_periodic_df_) {
 
   // Members of Molecule
@@ -197,12 +233,12 @@ Geometry::Geometry(const Geometry& o, shared_ptr<const Matrix> displ, shared_ptr
   magnetic_field_ = o.magnetic_field_;
   dofmm_ = o.dofmm_;
 
-  // first construct atoms using displacements
-  int iat = 0;
-  for (auto i = o.atoms_.begin(), j = o.aux_atoms_.begin(); i != o.atoms_.end(); ++i, ++j, ++iat) {
+  // first construct atoms using displacements (there are no auxiliary atoms with Cholesky-decomposed integrals)
+  for (int iat = 0; iat != o.natom(); ++iat) {
     array<double,3> cdispl = {{displ->element(0,iat), displ->element(1,iat), displ->element(2,iat)}};
-    atoms_.push_back(make_shared<Atom>(**i, cdispl));
-    aux_atoms_.push_back(make_shared<Atom>(**j, cdispl));
+    atoms_.push_back(make_shared<Atom>(*o.atoms_[iat], cdispl));
+    if (!o.aux_atoms_.empty())
+      aux_atoms_.push_back(make_shared<Atom>(*o.aux_atoms_[iat], cdispl));
   }
 
   // second find the unique frame.
@@ -231,14 +267,15 @@ Geometry::Geometry(const Geometry& o, shared_ptr<const Matrix> displ, shared_ptr
       // first subtract mc, rotate, and then add oc
       vector<shared_ptr<const Atom>> newatoms;
       vector<shared_ptr<const Atom>> newauxatoms;
-      for (auto i = atoms_.begin(), j = aux_atoms_.begin(); i != atoms_.end(); ++i, ++j) {
-        assert((*i)->position() == (*j)->position());
-        Quatern<double> source = (*i)->position();
+      for (int i = 0; i != natom(); ++i) {
+        assert(aux_atoms_.empty() || atoms_[i]->position() == aux_atoms_[i]->position());
+        Quatern<double> source = atoms_[i]->position();
         Quatern<double> target = op * (source - mc) * opd + oc;
         array<double,3> cdispl = (target - source).ijk();
 
-        newatoms.push_back(make_shared<Atom>(**i, cdispl));
-        newauxatoms.push_back(make_shared<Atom>(**j, cdispl));
+        newatoms.push_back(make_shared<Atom>(*atoms_[i], cdispl));
+        if (!aux_atoms_.empty())
+          newauxatoms.push_back(make_shared<Atom>(*aux_atoms_[i], cdispl));
       }
       atoms_ = newatoms;
       aux_atoms_ = newauxatoms;
@@ -270,14 +307,15 @@ Geometry::Geometry(const Geometry& o, shared_ptr<const Matrix> displ, shared_ptr
 
         vector<shared_ptr<const Atom>> newatoms;
         vector<shared_ptr<const Atom>> newauxatoms;
-        for (auto i = atoms_.begin(), j = aux_atoms_.begin(); i != atoms_.end(); ++i, ++j) {
-          assert((*i)->position() == (*j)->position());
-          Quatern<double> source = (*i)->position();
+        for (int i = 0; i != natom(); ++i) {
+          assert(aux_atoms_.empty() || atoms_[i]->position() == aux_atoms_[i]->position());
+          Quatern<double> source = atoms_[i]->position();
           Quatern<double> target = op * (source - mc) * opd + oc;
           array<double,3> cdispl = (target - source).ijk();
 
-          newatoms.push_back(make_shared<Atom>(**i, cdispl));
-          newauxatoms.push_back(make_shared<Atom>(**j, cdispl));
+          newatoms.push_back(make_shared<Atom>(*atoms_[i], cdispl));
+          if (!aux_atoms_.empty())
+            newauxatoms.push_back(make_shared<Atom>(*aux_atoms_[i], cdispl));
         }
         atoms_ = newatoms;
         aux_atoms_ = newauxatoms;
@@ -295,7 +333,7 @@ Geometry::Geometry(const Geometry& o, shared_ptr<const Matrix> displ, shared_ptr
 }
 
 Geometry::Geometry(const Geometry& o, const array<double,3> displ)
-  : schwarz_thresh_(o.schwarz_thresh_), overlap_thresh_(o.overlap_thresh_), dkh_(o.dkh_), magnetism_(false),
+  : schwarz_thresh_(o.schwarz_thresh_), overlap_thresh_(o.overlap_thresh_), cholesky_thresh_(o.cholesky_thresh_), dkh_(o.dkh_), magnetism_(false),
     london_(o.london_), use_finite_(o.use_finite_), use_ecp_basis_(o.use_ecp_basis_), do_periodic_df_(o.do_periodic_df_) {
 
   // members of Molecule
@@ -327,7 +365,7 @@ Geometry::Geometry(const Geometry& o, const array<double,3> displ)
 
 // used when a new Geometry block is provided in input
 Geometry::Geometry(const Geometry& o, shared_ptr<const PTree> geominfo, const bool discard)
-  : schwarz_thresh_(o.schwarz_thresh_), overlap_thresh_(o.overlap_thresh_), magnetism_(false),
+  : schwarz_thresh_(o.schwarz_thresh_), overlap_thresh_(o.overlap_thresh_), cholesky_thresh_(o.cholesky_thresh_), magnetism_(false),
     london_(o.london_), use_finite_(o.use_finite_), use_ecp_basis_(o.use_ecp_basis_), do_periodic_df_(o.do_periodic_df_) {
 
   // members of Molecule
@@ -346,6 +384,7 @@ Geometry::Geometry(const Geometry& o, shared_ptr<const PTree> geominfo, const bo
   // check all the options
   schwarz_thresh_ = geominfo->get<double>("schwarz_thresh", schwarz_thresh_);
   overlap_thresh_ = geominfo->get<double>("thresh_overlap", overlap_thresh_);
+  cholesky_thresh_ = geominfo->get<double>("cholesky_thresh", cholesky_thresh_);
   symmetry_ = to_lower(geominfo->get<string>("symmetry", symmetry_));
 
   spherical_ = !geominfo->get<bool>("cartesian", !spherical_);
@@ -375,8 +414,8 @@ Geometry::Geometry(const Geometry& o, shared_ptr<const PTree> geominfo, const bo
   // if so, construct atoms
   if (prevbasis != basisfile_ || atoms || newfield) {
     use_ecp_basis_ = (basisfile_.find("ecp") != string::npos) ? true : false;
+    shared_ptr<const PTree> bdata = PTree::read_basis(basisfile_, atoms ? basis_elements(atoms) : basis_elements(o.atoms_));
     atoms_.clear();
-    shared_ptr<const PTree> bdata = PTree::read_basis(basisfile_);
     shared_ptr<const PTree> elem = geominfo->get_child_optional("_basis");
     if (atoms) {
       const bool angstrom = geominfo->get<bool>("angstrom", false);
@@ -389,9 +428,11 @@ Geometry::Geometry(const Geometry& o, shared_ptr<const PTree> geominfo, const bo
   }
   const string prevaux = auxfile_;
   auxfile_ = geominfo->get<string>("df_basis", auxfile_);
-  if (prevaux != auxfile_ || atoms) {
+  if ((prevaux != auxfile_ || atoms) && cholesky()) {
     aux_atoms_.clear();
-    shared_ptr<const PTree> bdata = PTree::read_basis(auxfile_);
+  } else if (prevaux != auxfile_ || atoms) {
+    aux_atoms_.clear();
+    shared_ptr<const PTree> bdata = PTree::read_basis(auxfile_, basis_elements(atoms_));
     shared_ptr<const PTree> elem = geominfo->get_child_optional("_df_basis");
     if (atoms) {
       const bool angstrom = geominfo->get<bool>("angstrom", false);
@@ -405,7 +446,7 @@ Geometry::Geometry(const Geometry& o, shared_ptr<const PTree> geominfo, const bo
 
   common_init1();
 
-  if (o.basisfile_ != basisfile_ || o.auxfile_ != auxfile_ || atoms || newfield) {
+  if (o.basisfile_ != basisfile_ || o.auxfile_ != auxfile_ || atoms || newfield || (cholesky() && o.cholesky_thresh_ != cholesky_thresh_)) {
     // discard the previous one before we compute the new one. Note that df_'s are mutable... too bad, I know..
     if (discard)
       o.discard_df();
@@ -425,7 +466,7 @@ Geometry::Geometry(const Geometry& o, shared_ptr<const PTree> geominfo, const bo
 *  supergeometry                                            *
 ************************************************************/
 Geometry::Geometry(vector<shared_ptr<const Geometry>> nmer, const bool nodf) :
-  schwarz_thresh_(nmer.front()->schwarz_thresh_), overlap_thresh_(nmer.front()->overlap_thresh_), dkh_(nmer.front()->dkh()), magnetism_(false), london_(nmer.front()->london_),
+  schwarz_thresh_(nmer.front()->schwarz_thresh_), overlap_thresh_(nmer.front()->overlap_thresh_), cholesky_thresh_(nmer.front()->cholesky_thresh_), dkh_(nmer.front()->dkh()), magnetism_(false), london_(nmer.front()->london_),
   use_finite_(nmer.front()->use_finite_), use_ecp_basis_(nmer.front()->use_ecp_basis_),  do_periodic_df_(false) {
 
   // A member of Molecule
@@ -482,6 +523,7 @@ Geometry::Geometry(vector<shared_ptr<const Geometry>> nmer, const bool nodf) :
   for(auto& inmer : nmer) {
      schwarz_thresh_ = min(schwarz_thresh_, inmer->schwarz_thresh_);
      overlap_thresh_ = min(overlap_thresh_, inmer->overlap_thresh_);
+     cholesky_thresh_ = min(cholesky_thresh_, inmer->cholesky_thresh_);
   }
 
   /* Data is merged (crossed fingers), now finish */
@@ -514,14 +556,15 @@ Geometry::Geometry(const vector<shared_ptr<const Atom>> atoms, shared_ptr<const
 
   schwarz_thresh_ = geominfo->get<double>("schwarz_thresh", 1.0e-12);
   overlap_thresh_ = geominfo->get<double>("thresh_overlap", 1.0e-8);
+  cholesky_thresh_ = geominfo->get<double>("cholesky_thresh", 1.0e-6);
 
   // cartesian or not. Look in the atoms info to find out
   spherical_ = atoms.front()->spherical();
   // basis
   auxfile_ = geominfo->get<string>("df_basis", "");
-  if (!auxfile_.empty()) {
+  if (!auxfile_.empty() && !cholesky()) {
     // read the default basis file
-    shared_ptr<const PTree> bdata = PTree::read_basis(auxfile_);
+    shared_ptr<const PTree> bdata = PTree::read_basis(auxfile_, basis_elements(atoms_));
     shared_ptr<const PTree> elem = geominfo->get_child_optional("_df_basis");
     if (atomlist) {
       for (auto& i : *atomlist)
@@ -631,8 +674,8 @@ shared_ptr<const Geometry> Geometry::periodic(vector<shared_ptr<const Atom>> ato
   auto out = make_shared<Geometry>(*this);
 
   vector<shared_ptr<const Atom>> aux_atoms;
-  if (!auxfile_.empty()) {
-    shared_ptr<const PTree> bdata = PTree::read_basis(auxfile_);
+  if (!auxfile_.empty() && !cholesky()) {
+    shared_ptr<const PTree> bdata = PTree::read_basis(auxfile_, basis_elements(atoms));
     for (auto& a : atoms)
       aux_atoms.push_back(make_shared<const Atom>(*a, spherical_, auxfile_, make_pair(auxfile_, bdata), nullptr));
   }
@@ -672,6 +715,8 @@ shared_ptr<const Geometry> Geometry::relativistic(const bool do_gaunt, const boo
 
 
 void Geometry::compute_relativistic_integrals(const bool do_gaunt) {
+  if (cholesky())
+    throw runtime_error("Relativistic calculations with Cholesky-decomposed integrals are not implemented");
   df_->average_3index();
   shared_ptr<Matrix> d2 = df_->data2()->copy();
 
@@ -706,6 +751,12 @@ void Geometry::set_london(shared_ptr<const PTree>& geominfo) {
 
 
 void Geometry::compute_integrals(const double thresh) const {
+  if (cholesky()) {
+    if (magnetism_)
+      throw runtime_error("Cholesky-decomposed integrals are not available with a magnetic field");
+    df_ = make_shared<CholeskyDist>(nbasis(), atoms(), cholesky_thresh_);
+    return;
+  }
 #ifdef LIBINT_INTERFACE
   if (!magnetism_)
     df_ = form_fit<DFDist_ints<Libint>>(thresh, true); // true means we construct J^-1/2
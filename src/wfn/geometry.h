@@ -38,6 +38,8 @@ class Geometry : public Molecule {
     // integral screening
     double schwarz_thresh_;
     double overlap_thresh_;
+    // threshold for the Cholesky decomposition of the two-electron integrals (used when df_basis is "cholesky")
+    double cholesky_thresh_;
 
     // for DF calculations
     mutable std::shared_ptr<DFDist> df_;
@@ -77,7 +79,7 @@ class Geometry : public Molecule {
     template<class Archive>
     void save(Archive& ar, const unsigned int) const {
       ar << boost::serialization::base_object<Molecule>(*this);
-      ar << schwarz_thresh_ << overlap_thresh_ << dkh_ << magnetism_ << london_ << use_finite_ << use_ecp_basis_ << do_periodic_df_;
+      ar << schwarz_thresh_ << overlap_thresh_ << cholesky_thresh_ << dkh_ << magnetism_ << london_ << use_finite_ << use_ecp_basis_ << do_periodic_df_;
       const size_t dfindex = !df_ ? 0 : std::hash<DFDist*>()(df_.get());
       ar << dfindex;
       const bool do_rel   = !!dfs_;
@@ -88,7 +90,7 @@ class Geometry : public Molecule {
     template<class Archive>
     void load(Archive& ar, const unsigned int) {
       ar >> boost::serialization::base_object<Molecule>(*this);
-      ar >> schwarz_thresh_ >> overlap_thresh_ >> dkh_ >> magnetism_ >> london_ >> use_finite_ >> use_ecp_basis_ >> do_periodic_df_;
+      ar >> schwarz_thresh_ >> overlap_thresh_ >> cholesky_thresh_ >> dkh_ >> magnetism_ >> london_ >> use_finite_ >> use_ecp_basis_ >> do_periodic_df_;
       size_t dfindex;
       ar >> dfindex;
       static std::map<size_t, std::weak_ptr<DFDist>> dfmap;
@@ -123,6 +125,9 @@ class Geometry : public Molecule {
     std::shared_ptr<const Matrix> compute_grad_vnuc(const bool skip_self_interaction = true) const;
     double schwarz_thresh() const { return schwarz_thresh_; }
     double overlap_thresh() const { return overlap_thresh_; }
+    double cholesky_thresh() const { return cholesky_thresh_; }
+    // 3-index integrals are Cholesky vectors of the two-electron integrals rather than fitted ones
+    bool cholesky() const { return auxfile_ == "cholesky"; }
     bool dkh() const { return dkh_; }
     bool london() const { return london_; }
     bool magnetism() const { return magnetism_; }
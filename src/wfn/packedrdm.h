@@ -0,0 +1,174 @@
+//
+// BAGEL - Brilliantly Advanced General Electronic Structure Library
+// Filename: packedrdm.h
+// Copyright (C) 2017 Toru Shiozaki
+//
+// Author: Toru Shiozaki <shiozaki@northwestern.edu>
+// Maintainer: Shiozaki group
+//
+// This file is part of the BAGEL package.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __BAGEL_WFN_PACKEDRDM_H
+#define __BAGEL_WFN_PACKEDRDM_H
+
+#include <src/wfn/rdm.h>
+
+namespace bagel {
+
+// RDMs in which only the elements that are unique under particle exchange are stored.
+// The elements of RDM<rank> are indexed as (a0,b0,a1,b1,...), and the (normal-ordered) RDM is invariant
+// under any permutation of the pairs (ak,bk). With p_k = ak + norb*bk sorted in descending order,
+// the element is stored at sum_k binom(p_k+rank-1-k, rank-k), i.e., binom(norb^2+rank-1, rank) elements
+// instead of norb^(2*rank) (1/6 for RDM<3> and 1/24 for RDM<4> asymptotically).
+template <int rank, typename DataType = double>
+class PackedRDM {
+  protected:
+    int norb_;
+    std::vector<size_t> binom_;
+    std::unique_ptr<DataType[]> data_;
+    size_t size_;
+
+    size_t binom(const int n, const int k) const { return binom_[k+(rank+1)*n]; }
+
+    // p has to be sorted in descending order
+    size_t index_sorted(const std::array<int,rank>& p) const {
+      size_t out = 0;
+      for (int k = 0; k != rank; ++k)
+        out += binom(p[k]+rank-1-k, rank-k);
+      return out;
+    }
+
+    size_t index(std::array<int,rank> p) const {
+      std::sort(p.begin(), p.end(), std::greater<int>());
+      return index_sorted(p);
+    }
+
+    template<typename ...args>
+    std::array<int,rank> pairs(const args&... ind) const {
+      static_assert(sizeof...(ind) == rank*2, "wrong number of indices in PackedRDM");
+      const std::array<int,rank*2> in{{static_cast<int>(ind)...}};
+      std::array<int,rank> p;
+      for (int k = 0; k != rank; ++k)
+        p[k] = in[2*k] + norb_*in[2*k+1];
+      return p;
+    }
+
+    template<typename ...args>
+    size_t index(const args&... ind) const { return index(pairs(ind...)); }
+
+  public:
+    PackedRDM(const int norb) : norb_(norb) {
+      const int npair = norb*norb;
+      binom_.resize((npair+rank)*(rank+1));
+      for (int n = 0; n != npair+rank; ++n)
+        for (int k = 0; k <= rank; ++k)
+          binom_[k+(rank+1)*n] = k == 0 ? 1 : (n == 0 ? 0 : binom(n-1, k-1) + binom(n-1, k));
+      size_ = binom(npair+rank-1, rank);
+      data_ = std::unique_ptr<DataType[]>(new DataType[size_]);
+      zero();
+    }
+
+    // packs a full RDM; the redundant elements are assumed to be consistent
+    PackedRDM(const RDM<rank,DataType>& o) : PackedRDM(o.norb()) {
+      std::array<int,rank*2> ind;
+      std::fill(ind.begin(), ind.end(), 0);
+      for (auto& i : o) {
+        std::array<int,rank> p;
+        for (int k = 0; k != rank; ++k)
+          p[k] = ind[2*k] + norb_*ind[2*k+1];
+        data_[index(p)] = i;
+        for (int k = 0; k != rank*2 && ++ind[k] == norb_; ++k)
+          ind[k] = 0;
+      }
+    }
+
+    PackedRDM(const PackedRDM<rank,DataType>& o) : PackedRDM(o.norb_) {
+      std::copy_n(o.data_.get(), size_, data_.get());
+    }
+
+    std::shared_ptr<PackedRDM<rank,DataType>> clone() const { return std::make_shared<PackedRDM<rank,DataType>>(norb_); }
+    std::shared_ptr<PackedRDM<rank,DataType>> copy() const { return std::make_shared<PackedRDM<rank,DataType>>(*this); }
+
+    template<typename ...args>
+    DataType& element(const args&... ind) { return data_[index(ind...)]; }
+
+    template<typename ...args>
+    const DataType& element(const args&... ind) const { return data_[index(ind...)]; }
+
+    // Adds a*x to the element, where x is a single (not symmetrized) contribution. Because the stored element is
+    // the average over the distinct permutations of the pairs, the contribution is divided by their number.
+    // Accumulating all contributions this way is exact as long as their total is invariant under particle exchange.
+    template<typename ...args>
+    void add(const DataType& a, const args&... ind) { add_pairs(a, pairs(ind...)); }
+
+    // same as above with the pair indices p_k = a_k + norb*b_k
+    void add_pairs(const DataType& a, std::array<int,rank> p) {
+      std::sort(p.begin(), p.end(), std::greater<int>());
+      // nfact = prod_i m_i! over the multiplicities of the pairs
+      size_t nfact = 1;
+      for (int k = 1, m = 1; k != rank; ++k) {
+        m = p[k] == p[k-1] ? m+1 : 1;
+        nfact *= m;
+      }
+      size_t rankfact = 1;
+      for (int k = 2; k <= rank; ++k)
+        rankfact *= k;
+      data_[index_sorted(p)] += a * (static_cast<double>(nfact) / rankfact);
+    }
+
+    DataType* data() { return data_.get(); }
+    const DataType* data() const { return data_.get(); }
+
+    size_t size() const { return size_; }
+    int norb() const { return norb_; }
+
+    void zero() { std::fill_n(data_.get(), size_, 0.0); }
+    void scale(const DataType& a) { std::for_each(data_.get(), data_.get()+size_, [&a](DataType& p) { p *= a; }); }
+    void ax_plus_y(const DataType& a, const PackedRDM<rank,DataType>& o) { blas::ax_plus_y_n(a, o.data(), size_, data()); }
+    void allreduce() { mpi__->allreduce(data(), size()); }
+
+    // unpacks the block [offset[i], offset[i]+size[i]) into a column-major buffer (the first index runs fastest)
+    void unpack_block(const std::array<int,rank*2>& offset, const std::array<int,rank*2>& size, DataType* out) const {
+      const size_t nblock = std::accumulate(size.begin(), size.end(), 1ul, std::multiplies<size_t>());
+      if (nblock == 0) return;
+      std::array<int,rank*2> ind = offset;
+      for (size_t n = 0; n != nblock; ++n) {
+        std::array<int,rank> p;
+        for (int k = 0; k != rank; ++k)
+          p[k] = ind[2*k] + norb_*ind[2*k+1];
+        out[n] = data_[index(p)];
+        for (int k = 0; k != rank*2 && ++ind[k] == offset[k]+size[k]; ++k)
+          ind[k] = offset[k];
+      }
+    }
+
+    std::shared_ptr<RDM<rank,DataType>> unpack() const {
+      auto out = std::make_shared<RDM<rank,DataType>>(norb_);
+      std::array<int,rank*2> offset, size;
+      std::fill(offset.begin(), offset.end(), 0);
+      std::fill(size.begin(), size.end(), norb_);
+      unpack_block(offset, size, out->data());
+      return out;
+    }
+};
+
+template <int rank>
+using ZPackedRDM = PackedRDM<rank, std::complex<double>>;
+
+}
+
+#endif
@@ -33,6 +33,7 @@
 #include <src/wfn/geometry.h>
 #include <src/wfn/ciwfn.h>
 #include <src/wfn/rdm.h>
+#include <src/wfn/packedrdm.h>
 #include <src/util/vec.h>
 
 // all the info to construct wave functions
@@ -168,6 +169,10 @@ class Reference : public std::enable_shared_from_this<Reference> {
 
     std::tuple<std::shared_ptr<const RDM<1>>, std::shared_ptr<const RDM<2>>> rdm12(const int ist, const int jst, const bool recompute = false) const;
     std::tuple<std::shared_ptr<const RDM<3>>, std::shared_ptr<const RDM<4>>> rdm34(const int ist, const int jst) const;
+    // 3RDM and 4RDM stored in the packed format (see PackedRDM)
+    std::tuple<std::shared_ptr<const PackedRDM<3>>, std::shared_ptr<const PackedRDM<4>>> rdm34_packed(const int ist, const int jst) const;
+    // 3RDM and 4RDM contracted with fock on the last index pair (the 4RDM itself is not formed)
+    std::tuple<std::shared_ptr<const RDM<3>>, std::shared_ptr<const RDM<3>>> rdm34f(const int ist, const int jst, std::shared_ptr<const Matrix> fock) const;
 
     // function to return a CI vectors from orbital info
     std::shared_ptr<const Dvec> civectors() const;